@@ -1,10 +1,12 @@
 #include "pch.h"
 #include "OurSolarSystem.h"
+#include "ComponentScheduler.h"
 #include "FirstPersonCamera.h"
 #include "VertexDeclarations.h"
 #include "Game.h"
 #include "GameException.h"
 #include "Model.h"
+#include "GeometryGenerator.h"
 #include "ProxyModel.h"
 #include "PointLightMaterial.h"
 #include <GameTime.cpp>
@@ -75,19 +77,22 @@ namespace Rendering
 		std::unique_ptr<VertexPosition> vertexData(new VertexPosition[10000 * sizeof(Bodies) / sizeof(Bodies[0])]);
 		VertexPosition* vertices = vertexData.get();
 
-		//The outer loop cycles through each body
-		for (int i = 0; i < sizeof(Bodies) / sizeof(Bodies[0]); i++)
+		//Every vertex is independent, so the segments of all orbits are spread across the job system's threads together
+		mGame->Jobs().ParallelFor(0, 10000 * sizeof(Bodies) / sizeof(Bodies[0]), 2048, [this, vertices](size_t begin, size_t end)
 		{
-			//While the inner loop creates the segments for that bodies orbit
-			for (int j = 0; j < 10000; j++)
+			for (size_t k = begin; k < end; k++)
 			{
+				//Vertex k is segment j of body i's orbit
+				const size_t i = k / 10000;
+				const int j = static_cast<int>(k % 10000);
+
 				DirectX::XMFLOAT4 Offset{ 0, 0, 0, 1 };
 				Offset.x += Bodies[i].OrbitalDistance * cos(j * DirectX::XM_2PI / 10000);
 				Offset.z += Bodies[i].OrbitalDistance * sin(j * DirectX::XM_2PI / 10000);
 
-				vertices[j + i *10000] = VertexPosition(Offset);
+				vertices[k] = VertexPosition(Offset);
 			}
-		}
+		});
 		//We form the lines and ensure everything was created properly.
 		D3D11_BUFFER_DESC vertexBufferDesc{ 0 };
 		vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
@@ -102,15 +107,23 @@ namespace Rendering
 	void OurSolarSystem::Initialize()
 	{
 		auto direct3DDevice = mGame->Direct3DDevice();
-		const auto PlanetModel = mGame->Content().Load<Model>(L"Models\\Sphere.obj.bin"s);
-		Mesh* PlanetMesh = PlanetModel->Meshes().at(0).get();
+		//Every sphere in the scene is generated rather than loaded, with its levels of detail and meshlets built in
+		PlanetModel = GeometryGenerator::LoadSphere(mGame->Content());
+		PlanetMesh = PlanetModel->Meshes().at(0).get();
 
 		auto sunTexture = mGame->Content().Load<Texture2D>(L"Textures\\SunMap.dds"s);
 		auto PlanetSpecular = mGame->Content().Load<Texture2D>(L"Textures\\NoReflection.dds"s);
 		
-		VertexPositionTextureNormal::CreateVertexBuffer(direct3DDevice, *PlanetMesh, not_null<ID3D11Buffer**>(PlanetVertexBuffer.put()));
-		PlanetMesh->CreateIndexBuffer(*direct3DDevice, not_null<ID3D11Buffer**>(PlanetIndexBuffer.put()));
-		PlanetIndexCount = narrow<uint32_t>(PlanetMesh->Indices().size());
+		//The sphere buffers are shared through the game's cache, so the skybox and sun reuse the same upload
+		PlanetBuffers = mGame->BufferCache().Get<VertexPositionTextureNormalPacked>(direct3DDevice, *PlanetMesh);
+		//Planet positions are stored quantized, so every world matrix is prefixed with the mesh's dequantization
+		const VertexQuantization PlanetQuantization = VertexPositionTextureNormalPacked::Quantization(*PlanetMesh);
+		XMStoreFloat4x4(&PlanetDequantizationMatrix, PlanetQuantization.DequantizationMatrix());
+		PlanetRadius = PlanetQuantization.Scale;
+		if (!PlanetMesh->Meshlets().empty())
+		{
+			PlanetCuller = make_unique<MeshletCuller>(PlanetBuffers->IndexFormat);
+		}
 
 		//We initialize the orbit lines for each planet for easier reading
 		InitializeOrbitLines();
@@ -165,7 +178,7 @@ namespace Rendering
 	void OurSolarSystem::CreateSun(std::shared_ptr<Library::Texture2D> ColorMap, std::shared_ptr<Library::Texture2D>LightMap)
 	{
 		SunPointLight = make_unique<PointLight>();
-		SunModel = make_unique<ProxyModel>(*mGame, mCamera, "Models\\Sphere.obj.bin"s, SunScale);
+		SunModel = make_unique<ProxyModel>(*mGame, mCamera, GeometryGenerator::LoadSphere(mGame->Content()), SunScale);
 
 		SunPointLight->SetPosition(0.0f, 0.0f, 0.0f);
 
@@ -200,16 +213,23 @@ namespace Rendering
 	{
 		if (AnimationEnabled())
 		{
-			Orbit(gameTime, Mercury, Mercury);
-			Orbit(gameTime, Venus, Venus);
-			Orbit(gameTime, Earth, Earth);
-			Orbit(gameTime, Moon, Earth);
-			Orbit(gameTime, Mars, Mars);
-			Orbit(gameTime, Jupiter, Jupiter);
-			Orbit(gameTime, Saturn, Saturn);
-			Orbit(gameTime, Uranus, Uranus);
-			Orbit(gameTime, Neptune, Neptune);
-			Orbit(gameTime, Pluto, Pluto);
+			//Each body orbits independently, except the Moon, which has to follow wherever Earth has just moved to
+			JobSystem& jobs = mGame->Jobs();
+			const JobHandle earthOrbit = jobs.Submit([&]() { Orbit(gameTime, Earth, Earth); });
+			const JobHandle orbits[]
+			{
+				jobs.Submit([&]() { Orbit(gameTime, Mercury, Mercury); }),
+				jobs.Submit([&]() { Orbit(gameTime, Venus, Venus); }),
+				earthOrbit,
+				jobs.Submit([&]() { Orbit(gameTime, Moon, Earth); }, { earthOrbit }),
+				jobs.Submit([&]() { Orbit(gameTime, Mars, Mars); }),
+				jobs.Submit([&]() { Orbit(gameTime, Jupiter, Jupiter); }),
+				jobs.Submit([&]() { Orbit(gameTime, Saturn, Saturn); }),
+				jobs.Submit([&]() { Orbit(gameTime, Uranus, Uranus); }),
+				jobs.Submit([&]() { Orbit(gameTime, Neptune, Neptune); }),
+				jobs.Submit([&]() { Orbit(gameTime, Pluto, Pluto); })
+			};
+			jobs.Wait(orbits);
 
 			SunCurrentRotation += Earth.RotationalPeriod/1000;
 			XMStoreFloat4x4(&SunWorldMatrix, XMMatrixRotationY(SunCurrentRotation) * XMMatrixScaling(SunScale, SunScale, SunScale));
@@ -218,6 +238,12 @@ namespace Rendering
 		UpdateMaterial = true;
 	}
 
+	void OurSolarSystem::DeclareAccess(ComponentAccess& access) const
+	{
+		//The camera's callbacks flag this component's materials for update, so it has to update after the camera
+		access.Reads(mCamera.get());
+	}
+
 	//Lets a body orbit around a central point: either the origin or the satellite (if it differs from the planet)
 	void OurSolarSystem::Orbit(const GameTime& gameTime, CelestialBody& Body, const CelestialBody& SatelliteTarget)
 	{
@@ -262,9 +288,37 @@ namespace Rendering
 	//Updates a single celestial body and its transforms
 	void OurSolarSystem::UpdateBody(CelestialBody& Body)
 	{
-		const XMMATRIX PlanetWorldMatrix = XMLoadFloat4x4(&Body.WorldMatrix);
+		const XMMATRIX PlanetWorldMatrix = XMLoadFloat4x4(&PlanetDequantizationMatrix) * XMLoadFloat4x4(&Body.WorldMatrix);
 		const XMMATRIX Planetwvp = XMMatrixTranspose(PlanetWorldMatrix * mCamera->ViewProjectionMatrix());
 		Body.Material->UpdateTransforms(Planetwvp, XMMatrixTranspose(PlanetWorldMatrix));
+		Body.LodIndex = SelectPlanetLod(Body.WorldMatrix, Body.Scale);
+	}
+
+	std::uint32_t OurSolarSystem::SelectPlanetLod(const XMFLOAT4X4& WorldMatrix, float Scale) const
+	{
+		//The LOD errors are in mesh units, so the body's scale turns them into world units before they are projected onto the screen.
+		//Distance is measured to the nearest point of the body, so large planets close to the camera keep their detail.
+		auto perspectiveCamera = mCamera->As<PerspectiveCamera>();
+		const float fieldOfView = (perspectiveCamera != nullptr ? perspectiveCamera->FieldOfView() : PerspectiveCamera::DefaultFieldOfView);
+		const XMVECTOR bodyPosition = XMVectorSet(WorldMatrix._41, WorldMatrix._42, WorldMatrix._43, 1.0f);
+		const float distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(bodyPosition, mCamera->PositionVector()))) - PlanetRadius * Scale;
+
+		return MeshLod::Select(PlanetBuffers->Lods, Scale * MeshLod::PixelsPerUnit(distance, fieldOfView, mGame->Viewport().Height));
+	}
+
+	void OurSolarSystem::CullPlanetMeshlets(const XMFLOAT4X4& WorldMatrix, std::uint32_t LodIndex, std::optional<MeshletDraw>& CulledDraw)
+	{
+		//Meshlet bounds are in the mesh's original units, so the dequantization is left out here
+		CulledDraw.reset();
+		if (PlanetCuller != nullptr && LodIndex == 0)
+		{
+			CulledDraw = PlanetCuller->Cull(*PlanetMesh, XMLoadFloat4x4(&WorldMatrix));
+		}
+	}
+
+	MeshletCullStatistics OurSolarSystem::MeshletStatistics() const
+	{
+		return (PlanetCuller != nullptr ? PlanetCuller->Statistics() : MeshletCullStatistics());
 	}
 
 	void OurSolarSystem::Draw(const GameTime& gameTime)
@@ -291,9 +345,22 @@ namespace Rendering
 			UpdateBody(Neptune);
 			UpdateBody(Pluto);
 			//Drawing the sun
-			const XMMATRIX sunworldMatrix = XMLoadFloat4x4(&SunWorldMatrix);
+			const XMMATRIX sunworldMatrix = XMLoadFloat4x4(&PlanetDequantizationMatrix) * XMLoadFloat4x4(&SunWorldMatrix);
 			const XMMATRIX sunwvp = XMMatrixTranspose(sunworldMatrix * mCamera->ViewProjectionMatrix());
 			SunMaterial->UpdateTransforms(sunwvp, XMMatrixTranspose(sunworldMatrix));
+			SunLodIndex = SelectPlanetLod(SunWorldMatrix, SunScale);
+
+			//Culling the planet meshlets of every body close enough to be drawn at full detail
+			if (PlanetCuller != nullptr)
+			{
+				PlanetCuller->Begin(*mCamera);
+				for (CelestialBody* Body : { &Mercury, &Venus, &Earth, &Moon, &Mars, &Jupiter, &Saturn, &Uranus, &Neptune, &Pluto })
+				{
+					CullPlanetMeshlets(Body->WorldMatrix, Body->LodIndex, Body->CulledDraw);
+				}
+				CullPlanetMeshlets(SunWorldMatrix, SunLodIndex, SunCulledDraw);
+				PlanetCuller->End(*mGame->Direct3DDeviceContext());
+			}
 			//We no longer need to update the materials
 			UpdateMaterial = false;
 		}
@@ -305,16 +372,36 @@ namespace Rendering
 
 	void OurSolarSystem::DrawMaterials()
 	{
-		Mercury.Material->DrawIndexed(not_null<ID3D11Buffer*>(PlanetVertexBuffer.get()), not_null<ID3D11Buffer*>(PlanetIndexBuffer.get()), PlanetIndexCount);
-		Venus.Material->DrawIndexed(not_null<ID3D11Buffer*>(PlanetVertexBuffer.get()), not_null<ID3D11Buffer*>(PlanetIndexBuffer.get()), PlanetIndexCount);
-		Moon.Material->DrawIndexed(not_null<ID3D11Buffer*>(PlanetVertexBuffer.get()), not_null<ID3D11Buffer*>(PlanetIndexBuffer.get()), PlanetIndexCount);
-		Earth.Material->DrawIndexed(not_null<ID3D11Buffer*>(PlanetVertexBuffer.get()), not_null<ID3D11Buffer*>(PlanetIndexBuffer.get()), PlanetIndexCount);
-		Mars.Material->DrawIndexed(not_null<ID3D11Buffer*>(PlanetVertexBuffer.get()), not_null<ID3D11Buffer*>(PlanetIndexBuffer.get()), PlanetIndexCount);
-		Jupiter.Material->DrawIndexed(not_null<ID3D11Buffer*>(PlanetVertexBuffer.get()), not_null<ID3D11Buffer*>(PlanetIndexBuffer.get()), PlanetIndexCount);
-		Saturn.Material->DrawIndexed(not_null<ID3D11Buffer*>(PlanetVertexBuffer.get()), not_null<ID3D11Buffer*>(PlanetIndexBuffer.get()), PlanetIndexCount);
-		Uranus.Material->DrawIndexed(not_null<ID3D11Buffer*>(PlanetVertexBuffer.get()), not_null<ID3D11Buffer*>(PlanetIndexBuffer.get()), PlanetIndexCount);
-		Neptune.Material->DrawIndexed(not_null<ID3D11Buffer*>(PlanetVertexBuffer.get()), not_null<ID3D11Buffer*>(PlanetIndexBuffer.get()), PlanetIndexCount);
-		Pluto.Material->DrawIndexed(not_null<ID3D11Buffer*>(PlanetVertexBuffer.get()), not_null<ID3D11Buffer*>(PlanetIndexBuffer.get()), PlanetIndexCount);
-		SunMaterial->DrawIndexed(not_null<ID3D11Buffer*>(PlanetVertexBuffer.get()), not_null<ID3D11Buffer*>(PlanetIndexBuffer.get()), PlanetIndexCount);
+		const not_null<ID3D11Buffer*> planetVertexBuffer(PlanetBuffers->VertexBuffer);
+		const not_null<ID3D11Buffer*> planetIndexBuffer(PlanetBuffers->IndexBuffer);
+
+		//Every level of detail lives in the same index range, so picking one only changes the count and start of the draw
+		//Bodies with culled meshlets draw their surviving triangles from the culler's index buffer instead
+		auto drawPlanet = [&](PointLightMaterial& Material, std::uint32_t LodIndex, const std::optional<MeshletDraw>& CulledDraw)
+		{
+			if (CulledDraw.has_value())
+			{
+				if (CulledDraw->IndexCount > 0)
+				{
+					Material.DrawIndexed(planetVertexBuffer, not_null<ID3D11Buffer*>(PlanetCuller->IndexBuffer()), CulledDraw->IndexCount, PlanetCuller->IndexFormat(), CulledDraw->StartIndexLocation, PlanetBuffers->BaseVertexLocation);
+				}
+				return;
+			}
+
+			const MeshLod& lod = PlanetBuffers->Lods[LodIndex];
+			Material.DrawIndexed(planetVertexBuffer, planetIndexBuffer, lod.IndexCount, PlanetBuffers->IndexFormat, PlanetBuffers->StartIndexLocation + lod.StartIndex, PlanetBuffers->BaseVertexLocation);
+		};
+
+		drawPlanet(*Mercury.Material, Mercury.LodIndex, Mercury.CulledDraw);
+		drawPlanet(*Venus.Material, Venus.LodIndex, Venus.CulledDraw);
+		drawPlanet(*Moon.Material, Moon.LodIndex, Moon.CulledDraw);
+		drawPlanet(*Earth.Material, Earth.LodIndex, Earth.CulledDraw);
+		drawPlanet(*Mars.Material, Mars.LodIndex, Mars.CulledDraw);
+		drawPlanet(*Jupiter.Material, Jupiter.LodIndex, Jupiter.CulledDraw);
+		drawPlanet(*Saturn.Material, Saturn.LodIndex, Saturn.CulledDraw);
+		drawPlanet(*Uranus.Material, Uranus.LodIndex, Uranus.CulledDraw);
+		drawPlanet(*Neptune.Material, Neptune.LodIndex, Neptune.CulledDraw);
+		drawPlanet(*Pluto.Material, Pluto.LodIndex, Pluto.CulledDraw);
+		drawPlanet(*SunMaterial, SunLodIndex, SunCulledDraw);
 	}
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <gsl\gsl>
 #include <winrt\Windows.Foundation.h>
 #include <d3d11.h>
+#include <optional>
 #include "DrawableGameComponent.h"
 #include "MatrixHelper.h"
 #include <PointLight.h>
@@ -10,10 +11,13 @@
 #include "Skybox.h"
 #include "Texture2D.h"
 #include "BasicMaterial.h"
+#include "MeshletCuller.h"
 
 namespace Library
 {
+	class Model;
 	class ProxyModel;
+	struct MeshBuffers;
 }
 
 namespace Rendering
@@ -49,6 +53,8 @@ namespace Rendering
 			float RotationalPeriod{ DirectX::XM_PI };
 			float AxialTilt = 23.5f / 90.0f;
 			float Scale = .4f;
+			std::uint32_t LodIndex = 0;
+			std::optional<Library::MeshletDraw> CulledDraw;
 		};
 
 		/// <summary>
@@ -71,6 +77,14 @@ namespace Rendering
 		/// </summary>
 		void UpdateBody(CelestialBody& Body);
 
+		/// <summary>
+		/// Chooses the coarsest level of detail of the planet mesh whose simplification error stays under a pixel on screen.
+		/// </summary>
+		/// <param name="WorldMatrix">The world matrix of the body being drawn, used for its position.</param>
+		/// <param name="Scale">The uniform scale applied to the planet mesh for this body.</param>
+		/// <returns>The index of the level of detail to draw.</returns>
+		std::uint32_t SelectPlanetLod(const DirectX::XMFLOAT4X4& WorldMatrix, float Scale) const;
+
 		/// <summary>
 		/// This creates the Sun object for the solar system, allowing the user to pass in a color and specular map to display its model onscreen.
 		/// </summary>
@@ -106,6 +120,7 @@ namespace Rendering
 		/// <param name="gameTime">GameTime(based on an in-game clock) elapsed this frame.</param>
 		/// </summary>
 		virtual void Update(const Library::GameTime& gameTime) override;
+		virtual void DeclareAccess(Library::ComponentAccess& access) const override;
 		/// <summary>
 		/// Draws all drawable components within the OurSolarSystem object. This draw is performed with regard to the GameTime argument provided.
 		/// <param name="gameTime">GameTime(based on an in-game clock) elapsed this frame.</param>
@@ -121,6 +136,12 @@ namespace Rendering
 		/// </summary>
 		void InitializeOrbitLines();
 
+		/// <summary>
+		/// Returns how many planet meshlets were culled and drawn in the last frame. All zero when the planet mesh has no meshlets.
+		/// </summary>
+		/// <returns>The meshlet culling counters of the last frame.</returns>
+		Library::MeshletCullStatistics MeshletStatistics() const;
+
 		///This is the orbital speed variable currently being used for the Earth's orbital period. It is public to allow it to be displayed to the user onscreen when adjusting rotation and movement rates of the
 		/// solar system bodies.
 		float OrbitalSpeed = 0.0025f;
@@ -131,10 +152,22 @@ namespace Rendering
 		/// <param name="enabled">Whether or not the animation should be enabled.</param>
 		void SetAnimationEnabled(bool enabled);
 
+		/// <summary>
+		/// Culls the full-detail planet meshlets of a body, recording the compacted draw if the body is close enough to use them.
+		/// </summary>
+		/// <param name="WorldMatrix">The world matrix of the body, without the dequantization.</param>
+		/// <param name="LodIndex">The level of detail selected for the body this frame.</param>
+		/// <param name="CulledDraw">Receives the compacted draw, or is reset when the body is drawn from the shared index buffer.</param>
+		void CullPlanetMeshlets(const DirectX::XMFLOAT4X4& WorldMatrix, std::uint32_t LodIndex, std::optional<Library::MeshletDraw>& CulledDraw);
+
 		//These variables specify the planet model data. This can be reused for all bodies, so they are stored generically for reuse, independent of the exact body being defined.
-		winrt::com_ptr<ID3D11Buffer> PlanetVertexBuffer;
-		winrt::com_ptr<ID3D11Buffer> PlanetIndexBuffer;
-		std::uint32_t PlanetIndexCount{ 0 };
+		std::shared_ptr<const Library::MeshBuffers> PlanetBuffers;
+		DirectX::XMFLOAT4X4 PlanetDequantizationMatrix{ Library::MatrixHelper::Identity };
+		float PlanetRadius{ 1.0f };
+		//Meshlets only cover the full-detail level, so only bodies drawn at LOD 0 are culled per cluster
+		std::shared_ptr<Library::Model> PlanetModel;
+		const Library::Mesh* PlanetMesh{ nullptr };
+		std::unique_ptr<Library::MeshletCuller> PlanetCuller;
 
 		/// <summary>
 		/// These are all the Celestial bodies. The Earth is used as the standard for all other bodies
@@ -191,6 +224,10 @@ namespace Rendering
 		float SunCurrentRotation{ 0.0f };
 		//The scale of the sun
 		float SunScale = 1;
+		//The planet mesh level of detail the sun is drawn with
+		std::uint32_t SunLodIndex = 0;
+		//The sun's compacted draw when its meshlets were culled this frame
+		std::optional<Library::MeshletDraw> SunCulledDraw;
 
 		//This is a pointer to the skybox of space
 		std::unique_ptr<Library::Skybox> SpaceBackdrop;
@@ -130,7 +130,7 @@ namespace Rendering
 
 	uint32_t PointLightMaterial::VertexSize() const
 	{
-		return sizeof(VertexPositionTextureNormal);
+		return sizeof(VertexPositionTextureNormalPacked);
 	}
 
 	void PointLightMaterial::Initialize()
@@ -138,15 +138,14 @@ namespace Rendering
 		Material::Initialize();
 
 		auto& content = mGame->Content();		
-		auto vertexShader = content.Load<VertexShader>(L"Shaders\\PointLightDemoVS.cso"s);
+		auto vertexShader = content.Load<VertexShader>(L"Shaders\\PointLightDemoPackedVS.cso"s);
 		SetShader(vertexShader);
 
 		auto pixelShader = content.Load<PixelShader>(L"Shaders\\PointLightDemoPS.cso");
 		SetShader(pixelShader);
 
 		auto direct3DDevice = mGame->Direct3DDevice();
-		vertexShader->CreateInputLayout<VertexPositionTextureNormal>(direct3DDevice);
-		SetInputLayout(vertexShader->InputLayout());
+		SetInputLayout(mGame->ShaderCache().GetInputLayout<VertexPositionTextureNormalPacked>(direct3DDevice, vertexShader->CompiledShader()));
 
 		D3D11_BUFFER_DESC constantBufferDesc{ 0 };
 		constantBufferDesc.ByteWidth = sizeof(VertexCBufferPerFrame);
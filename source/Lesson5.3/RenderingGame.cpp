@@ -14,6 +14,8 @@
 #include "ImGuiComponent.h"
 #include "imgui_impl_dx11.h"
 #include "UtilityWin32.h"
+#include "ContentPrefetcher.h"
+#include "Profiler.h"
 #include <limits>
 
 using namespace std;
@@ -31,33 +33,39 @@ namespace Rendering
 
 	void RenderingGame::Initialize()
 	{
+		//Serve content from the packed archive when one has been built; loose files remain the fallback
+		mContentManager.MountArchive(L"Content.pak");
+
+		//Read ahead whatever the last start loaded before its first frame; the archive has to be mounted first
+		mContentManager.BeginPrefetch();
+
 		SamplerStates::Initialize(Direct3DDevice());
 		RasterizerStates::Initialize(Direct3DDevice());
 
 		mKeyboard = make_shared<KeyboardComponent>(*this);
-		mComponents.push_back(mKeyboard);
-		mServices.AddService(KeyboardComponent::TypeIdClass(), mKeyboard.get());
+		AddComponent(mKeyboard);
+		mServices.AddService<KeyboardComponent>(*mKeyboard);
 
 		mMouse = make_shared<MouseComponent>(*this, MouseModes::Absolute);
-		mComponents.push_back(mMouse);
-		mServices.AddService(MouseComponent::TypeIdClass(), mMouse.get());
+		AddComponent(mMouse);
+		mServices.AddService<MouseComponent>(*mMouse);
 
 		mGamePad = make_shared<GamePadComponent>(*this);
-		mComponents.push_back(mGamePad);
-		mServices.AddService(GamePadComponent::TypeIdClass(), mGamePad.get());
+		AddComponent(mGamePad);
+		mServices.AddService<GamePadComponent>(*mGamePad);
 
 		auto camera = make_shared<FirstPersonCamera>(*this);
-		mComponents.push_back(camera);
-		mServices.AddService(Camera::TypeIdClass(), camera.get());
+		AddComponent(camera);
+		mServices.AddService<Camera>(*camera);
 
 		//Creating the solar system model as a single component
 		mSolarSystem = make_shared<OurSolarSystem>(*this, camera);
-		mComponents.push_back(mSolarSystem);
+		AddComponent(mSolarSystem);
 
 		//Making a "Guide" for controls to be visible onscreen
 		auto imGui = make_shared<ImGuiComponent>(*this);
-		mComponents.push_back(imGui);
-		mServices.AddService(ImGuiComponent::TypeIdClass(), imGui.get());
+		AddComponent(imGui);
+		mServices.AddService<ImGuiComponent>(*imGui);
 		auto imGuiWndProcHandler = make_shared<UtilityWin32::WndProcHandler>(ImGui_ImplWin32_WndProcHandler);
 		UtilityWin32::AddWndProcHandler(imGuiWndProcHandler);
 
@@ -67,20 +75,46 @@ namespace Rendering
 				ImGui::Begin("Controls");
 				ImGui::SetNextWindowPos(ImVec2(10, 10));
 
-				stringstream fpsLabel;
-				fpsLabel << setprecision(3) << "Frame Rate: " << mFpsComponent->FrameRate() << "    Total Elapsed Time: " << mGameTime.TotalGameTimeSeconds().count();
-				ImGui::Text(fpsLabel.str().c_str());
+				//Formatted into ImGui's own buffer, so the overlay allocates nothing per frame
+				ImGui::Text("Frame Rate: %d    Total Elapsed Time: %.3g", mFpsComponent->FrameRate(), mGameTime.TotalGameTimeSeconds().count());
 
 				ImGui::Text("Camera (WASD + Left-Click-Mouse-Look)");
 				ImGui::Text("Rotate Directional Light (Arrow Keys)");
+				ImGui::Text("Save Profiler Trace (F12), Frame Times (F11)");
+
+				ImGui::Text("Toggle Animation (Space): %s", (mSolarSystem->AnimationEnabled() ? "Enabled" : "Disabled"));
+				ImGui::Text("Speed Up (G) and Slow Down (H): %g", mSolarSystem->OrbitalSpeed);
+
+				const auto& bufferCache = BufferCache();
+				ImGui::Text("Mesh Buffer Cache: %u hits, %u misses, %llu bytes saved", bufferCache.Hits(), bufferCache.Misses(), bufferCache.BytesSaved());
+
+				const auto& shaderCache = ShaderCache();
+				ImGui::Text("Shader Cache: %u hits, %u misses, %zu objects", shaderCache.Hits(), shaderCache.Misses(), shaderCache.EntryCount());
+
+				if (const auto& prefetcher = mContentManager.Prefetcher(); prefetcher != nullptr)
+				{
+					const auto prefetchStatistics = prefetcher->Statistics();
+					ImGui::Text("Startup: %.4g ms to first frame (baseline %.4g ms), %u prefetch hits, %u misses", prefetchStatistics.TimeToFirstFrameMilliseconds, prefetchStatistics.BaselineTimeToFirstFrameMilliseconds, prefetchStatistics.HitCount, prefetchStatistics.MissCount);
+				}
+
+				const auto poolStatistics = bufferCache.PoolStatistics();
+				ImGui::Text("Geometry Pool: %u vertex pages, %u index pages, %llu/%llu bytes, fragmentation %.3g", poolStatistics.VertexPageCount, poolStatistics.IndexPageCount, poolStatistics.UsedBytes, poolStatistics.ReservedBytes, poolStatistics.Fragmentation());
+
+				const auto meshletStatistics = mSolarSystem->MeshletStatistics();
+				ImGui::Text("Meshlets: %u tested, %u outside frustum, %u back-facing, %u triangles drawn", meshletStatistics.MeshletCount, meshletStatistics.FrustumCulledCount, meshletStatistics.BackfaceCulledCount, meshletStatistics.SubmittedIndexCount / 3);
 
-				stringstream animationEnabledLabel;
-				animationEnabledLabel << "Toggle Animation (Space): " << (mSolarSystem->AnimationEnabled() ? "Enabled" : "Disabled");
-				ImGui::Text(animationEnabledLabel.str().c_str());
+				const auto& frameStatistics = FrameTimeStatistics();
+				const auto frameTimes = frameStatistics.FrameTimes();
+				ImGui::Text("Frame Time: p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms", frameTimes.P50, frameTimes.P95, frameTimes.P99, frameTimes.Max);
+				ImGui::Text("Update p99 %.2f ms, Draw p99 %.2f ms, %zu of %zu frames over %.2f ms", frameStatistics.UpdateTimes().P99, frameStatistics.DrawTimes().P99, frameStatistics.FramesOverBudget(), frameStatistics.FrameCount(), frameStatistics.FrameBudgetMilliseconds());
 
-				stringstream SpeedChangeLabel;
-				SpeedChangeLabel << "Speed Up (G) and Slow Down (H): " << mSolarSystem->OrbitalSpeed;
-				ImGui::Text(SpeedChangeLabel.str().c_str());
+				//Log-scale buckets, from under a quarter millisecond on the left
+				array<float, FrameStatistics::HistogramBucketCount> histogram;
+				transform(frameStatistics.FrameTimeHistogram().begin(), frameStatistics.FrameTimeHistogram().end(), histogram.begin(), [](uint32_t count) { return static_cast<float>(count); });
+				ImGui::PlotHistogram("Frame Times", histogram.data(), static_cast<int>(histogram.size()), 0, nullptr, 0.0f, numeric_limits<float>::max(), ImVec2(0.0f, 60.0f));
+
+				const auto& frameMemory = FrameMemory();
+				ImGui::Text("Frame Memory: %zu of %zu bytes, peak %zu, %zu frames fell back to the heap", frameMemory.UsedBytes(), frameMemory.Capacity(), frameMemory.PeakBytes(), frameMemory.OverflowFrameCount());
 				ImGui::End();
 			});
 		imGui->AddRenderBlock(helpTextImGuiRenderBlock);
@@ -88,7 +122,7 @@ namespace Rendering
 		//Counts elapsed time and frame rate for display to user on control menu
 		mFpsComponent = make_shared<FpsComponent>(*this);
 		mFpsComponent->SetVisible(false);
-		mComponents.push_back(mFpsComponent);
+		AddComponent(mFpsComponent);
 
 		Game::Initialize();
 
@@ -130,6 +164,18 @@ namespace Rendering
 			mSolarSystem->SlowDown();
 		}
 
+		//Saves the most recent profiler zones of every thread, for chrome://tracing or Perfetto
+		if (mKeyboard->WasKeyPressedThisFrame(Keys::F12))
+		{
+			Profiler::WriteChromeTrace(L"ProfilerTrace.json");
+		}
+
+		//Saves the frame times in the statistics window, to check against a frame-time target
+		if (mKeyboard->WasKeyPressedThisFrame(Keys::F11))
+		{
+			FrameTimeStatistics().WriteCsv(L"FrameStatistics.csv");
+		}
+
 		Game::Update(gameTime);
 	}
 
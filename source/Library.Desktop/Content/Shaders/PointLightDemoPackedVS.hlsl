@@ -0,0 +1,53 @@
+cbuffer CBufferPerFrame
+{
+	float3 LightPosition;
+	float LightRadius;
+}
+
+cbuffer CBufferPerObject
+{
+	float4x4 WorldViewProjection;
+	float4x4 World;
+}
+
+struct VS_INPUT
+{
+	float4 ObjectPosition: POSITION;
+	float2 TextureCoordinates : TEXCOORD;
+	float2 EncodedNormal : NORMAL;
+};
+
+struct VS_OUTPUT
+{
+	float4 Position: SV_Position;
+	float3 WorldPosition : WORLDPOS;
+	float Attenuation : ATTENUATION;
+	float2 TextureCoordinates : TEXCOORD;
+	float3 Normal : NORMAL;
+};
+
+// Octahedral normal decoding; see VertexPacking::DecodeOctahedral()
+float3 DecodeNormal(float2 encodedNormal)
+{
+	float3 normal = float3(encodedNormal, 1.0f - abs(encodedNormal.x) - abs(encodedNormal.y));
+	float t = saturate(-normal.z);
+	normal.xy += (normal.xy >= 0.0f ? -t : t);
+
+	return normalize(normal);
+}
+
+// Positions are quantized per mesh; the dequantization matrix is folded into WorldViewProjection and World
+VS_OUTPUT main(VS_INPUT IN)
+{
+	VS_OUTPUT OUT = (VS_OUTPUT)0;
+
+	OUT.Position = mul(IN.ObjectPosition, WorldViewProjection);
+	OUT.WorldPosition = mul(IN.ObjectPosition, World).xyz;
+	OUT.TextureCoordinates = IN.TextureCoordinates;
+	OUT.Normal = normalize(mul(float4(DecodeNormal(IN.EncodedNormal), 0), World).xyz);
+
+	float3 lightDirection = LightPosition - OUT.WorldPosition;
+	OUT.Attenuation = saturate(1.0f - (length(lightDirection) / LightRadius));
+
+	return OUT;
+}
\ No newline at end of file
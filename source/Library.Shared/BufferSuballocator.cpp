@@ -0,0 +1,144 @@
+#include "pch.h"
+#include "BufferSuballocator.h"
+
+using namespace std;
+
+namespace Library
+{
+	float BufferSuballocatorStatistics::Fragmentation() const
+	{
+		return (FreeSize > 0 ? 1.0f - static_cast<float>(LargestFreeBlock) / static_cast<float>(FreeSize) : 0.0f);
+	}
+
+	BufferSuballocator::BufferSuballocator(uint32_t capacity) :
+		mCapacity(capacity)
+	{
+		Reset();
+	}
+
+	uint32_t BufferSuballocator::Capacity() const
+	{
+		return mCapacity;
+	}
+
+	uint32_t BufferSuballocator::UsedSize() const
+	{
+		return mUsedSize;
+	}
+
+	uint32_t BufferSuballocator::AllocationCount() const
+	{
+		return mAllocationCount;
+	}
+
+	bool BufferSuballocator::IsEmpty() const
+	{
+		return mAllocationCount == 0;
+	}
+
+	optional<BufferAllocation> BufferSuballocator::Allocate(uint32_t size, uint32_t alignment)
+	{
+		assert(alignment > 0);
+		if (size == 0)
+		{
+			return nullopt;
+		}
+
+		for (auto it = mFreeBlocks.begin(); it != mFreeBlocks.end(); ++it)
+		{
+			const uint64_t blockOffset = it->first;
+			const uint64_t blockEnd = blockOffset + it->second;
+			const uint64_t alignedOffset = (blockOffset + alignment - 1) / alignment * alignment;
+			if (alignedOffset + size > blockEnd)
+			{
+				continue;
+			}
+
+			mFreeBlocks.erase(it);
+
+			// Return the alignment gap and the tail to the free list.
+			if (alignedOffset > blockOffset)
+			{
+				mFreeBlocks.emplace(static_cast<uint32_t>(blockOffset), static_cast<uint32_t>(alignedOffset - blockOffset));
+			}
+
+			const uint64_t allocationEnd = alignedOffset + size;
+			if (blockEnd > allocationEnd)
+			{
+				mFreeBlocks.emplace(static_cast<uint32_t>(allocationEnd), static_cast<uint32_t>(blockEnd - allocationEnd));
+			}
+
+			mUsedSize += size;
+			++mAllocationCount;
+
+			return BufferAllocation{ static_cast<uint32_t>(alignedOffset), size };
+		}
+
+		return nullopt;
+	}
+
+	void BufferSuballocator::Free(const BufferAllocation& allocation)
+	{
+		assert(allocation.Size > 0);
+		assert(uint64_t(allocation.Offset) + allocation.Size <= mCapacity);
+		assert(mAllocationCount > 0 && mUsedSize >= allocation.Size);
+
+		uint32_t offset = allocation.Offset;
+		uint32_t size = allocation.Size;
+
+		auto next = mFreeBlocks.lower_bound(offset);
+		assert(next == mFreeBlocks.end() || next->first >= offset + size);
+
+		// Coalesce with the preceding free block.
+		if (next != mFreeBlocks.begin())
+		{
+			auto previous = std::prev(next);
+			assert(previous->first + previous->second <= offset);
+			if (previous->first + previous->second == offset)
+			{
+				offset = previous->first;
+				size += previous->second;
+				mFreeBlocks.erase(previous);
+			}
+		}
+
+		// Coalesce with the following free block.
+		if (next != mFreeBlocks.end() && next->first == allocation.Offset + allocation.Size)
+		{
+			size += next->second;
+			mFreeBlocks.erase(next);
+		}
+
+		mFreeBlocks.emplace(offset, size);
+		mUsedSize -= allocation.Size;
+		--mAllocationCount;
+	}
+
+	void BufferSuballocator::Reset()
+	{
+		mFreeBlocks.clear();
+		if (mCapacity > 0)
+		{
+			mFreeBlocks.emplace(0, mCapacity);
+		}
+
+		mUsedSize = 0;
+		mAllocationCount = 0;
+	}
+
+	BufferSuballocatorStatistics BufferSuballocator::Statistics() const
+	{
+		BufferSuballocatorStatistics statistics;
+		statistics.Capacity = mCapacity;
+		statistics.UsedSize = mUsedSize;
+		statistics.AllocationCount = mAllocationCount;
+		statistics.FreeBlockCount = static_cast<uint32_t>(mFreeBlocks.size());
+		for (const auto& block : mFreeBlocks)
+		{
+			statistics.FreeSize += block.second;
+			statistics.LargestFreeBlock = max(statistics.LargestFreeBlock, block.second);
+		}
+
+		return statistics;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+
+namespace Library
+{
+	struct BufferAllocation final
+	{
+		std::uint32_t Offset{ 0 };
+		std::uint32_t Size{ 0 };
+	};
+
+	struct BufferSuballocatorStatistics final
+	{
+		std::uint32_t Capacity{ 0 };
+		std::uint32_t UsedSize{ 0 };
+		std::uint32_t FreeSize{ 0 };
+		std::uint32_t LargestFreeBlock{ 0 };
+		std::uint32_t FreeBlockCount{ 0 };
+		std::uint32_t AllocationCount{ 0 };
+
+		float Fragmentation() const;
+	};
+
+	/// <summary>
+	/// Device-independent first-fit free-list allocator over a fixed range of units (bytes, vertices or indices).
+	/// Adjacent free blocks are coalesced on release.
+	/// </summary>
+	class BufferSuballocator final
+	{
+	public:
+		explicit BufferSuballocator(std::uint32_t capacity);
+		BufferSuballocator(const BufferSuballocator&) = default;
+		BufferSuballocator& operator=(const BufferSuballocator&) = default;
+		BufferSuballocator(BufferSuballocator&&) = default;
+		BufferSuballocator& operator=(BufferSuballocator&&) = default;
+		~BufferSuballocator() = default;
+
+		std::uint32_t Capacity() const;
+		std::uint32_t UsedSize() const;
+		std::uint32_t AllocationCount() const;
+		bool IsEmpty() const;
+
+		std::optional<BufferAllocation> Allocate(std::uint32_t size, std::uint32_t alignment = 1);
+		void Free(const BufferAllocation& allocation);
+		void Reset();
+
+		BufferSuballocatorStatistics Statistics() const;
+
+	private:
+		std::map<std::uint32_t, std::uint32_t> mFreeBlocks;
+		std::uint32_t mCapacity;
+		std::uint32_t mUsedSize{ 0 };
+		std::uint32_t mAllocationCount{ 0 };
+	};
+}
\ No newline at end of file
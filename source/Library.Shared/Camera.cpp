@@ -17,41 +17,49 @@ namespace Library
 
 	const XMFLOAT3& Camera::Position() const
 	{
+		ValidateRead();
 		return mPosition;
 	}
 
 	const XMFLOAT3& Camera::Direction() const
 	{
+		ValidateRead();
 		return mDirection;
 	}
 
 	const XMFLOAT3& Camera::Up() const
 	{
+		ValidateRead();
 		return mUp;
 	}
 
 	const XMFLOAT3& Camera::Right() const
 	{
+		ValidateRead();
 		return mRight;
 	}
 
 	XMVECTOR Camera::PositionVector() const
 	{
+		ValidateRead();
 		return XMLoadFloat3(&mPosition);
 	}
 
 	XMVECTOR Camera::DirectionVector() const
 	{
+		ValidateRead();
 		return XMLoadFloat3(&mDirection);
 	}
 
 	XMVECTOR Camera::UpVector() const
 	{
+		ValidateRead();
 		return XMLoadFloat3(&mUp);
 	}
 
 	XMVECTOR Camera::RightVector() const
 	{
+		ValidateRead();
 		return XMLoadFloat3(&mRight);
 	}
 
@@ -79,16 +87,19 @@ namespace Library
 
 	XMMATRIX Camera::ViewMatrix() const
 	{
+		ValidateRead();
 		return XMLoadFloat4x4(&mViewMatrix);
 	}
 
 	XMMATRIX Camera::ProjectionMatrix() const
 	{
+		ValidateRead();
 		return XMLoadFloat4x4(&mProjectionMatrix);
 	}
 
 	XMMATRIX Camera::ViewProjectionMatrix() const
 	{
+		ValidateRead();
 		XMMATRIX viewMatrix = XMLoadFloat4x4(&mViewMatrix);
 		XMMATRIX projectionMatrix = XMLoadFloat4x4(&mProjectionMatrix);
 
@@ -158,6 +169,11 @@ namespace Library
 		}
 	}
 
+	void Camera::DeclareAccess(ComponentAccess&) const
+	{
+		// Subscribers' callbacks run during Update; each subscriber declares that it reads the camera, which orders it after
+	}
+
 	void Camera::UpdateViewMatrix()
 	{
 		XMVECTOR eyePosition = XMLoadFloat3(&mPosition);
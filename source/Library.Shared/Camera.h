@@ -54,6 +54,7 @@ namespace Library
 		virtual void Reset();
 		virtual void Initialize() override;
 		virtual void Update(const GameTime& gameTime) override;
+		virtual void DeclareAccess(ComponentAccess& access) const override;
 		virtual void UpdateViewMatrix();
 		virtual void UpdateProjectionMatrix() = 0;
 		virtual void ApplyRotation(DirectX::CXMMATRIX transform);
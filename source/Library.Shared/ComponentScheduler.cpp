@@ -0,0 +1,201 @@
+#include "pch.h"
+#include "ComponentScheduler.h"
+#include "GameComponent.h"
+#include "GameException.h"
+#include "Profiler.h"
+
+using namespace std;
+using namespace gsl;
+
+namespace Library
+{
+	namespace
+	{
+		// The component updating on this thread and what it declared, while validation is on
+		thread_local const GameComponent* sUpdatingComponent{ nullptr };
+		thread_local const ComponentAccess* sUpdatingAccess{ nullptr };
+
+		bool Contains(const vector<const void*>& resources, const void* resource)
+		{
+			return find(resources.begin(), resources.end(), resource) != resources.end();
+		}
+	}
+
+	void ComponentAccess::Reads(const void* resource)
+	{
+		if (resource != nullptr && !Contains(mReads, resource))
+		{
+			mReads.push_back(resource);
+		}
+	}
+
+	void ComponentAccess::Writes(const void* resource)
+	{
+		if (resource != nullptr && !Contains(mWrites, resource))
+		{
+			mWrites.push_back(resource);
+		}
+	}
+
+	void ComponentAccess::SetExclusive()
+	{
+		mExclusive = true;
+	}
+
+	bool ComponentAccess::IsExclusive() const
+	{
+		return mExclusive;
+	}
+
+	bool ComponentAccess::CanRead(const void* resource) const
+	{
+		return mExclusive || Contains(mReads, resource) || Contains(mWrites, resource);
+	}
+
+	bool ComponentAccess::CanWrite(const void* resource) const
+	{
+		return mExclusive || Contains(mWrites, resource);
+	}
+
+	bool ComponentAccess::ConflictsWith(const ComponentAccess& other) const
+	{
+		if (mExclusive || other.mExclusive)
+		{
+			return true;
+		}
+
+		auto writesAnyOf = [](const vector<const void*>& writes, const vector<const void*>& resources)
+		{
+			return any_of(writes.begin(), writes.end(), [&resources](const void* resource) { return Contains(resources, resource); });
+		};
+
+		return writesAnyOf(mWrites, other.mReads) || writesAnyOf(mWrites, other.mWrites) || writesAnyOf(other.mWrites, mReads);
+	}
+
+	ComponentScheduler::ComponentScheduler(JobSystem& jobs) :
+		mJobs(&jobs)
+	{
+	}
+
+	void ComponentScheduler::Update(const vector<shared_ptr<GameComponent>>& components, const GameTime& gameTime)
+	{
+		if (mGraphStale.exchange(false))
+		{
+			Build(components);
+		}
+
+		// Single-threaded runs keep the list's order exactly, for deterministic debugging.
+		if (mJobs->ThreadCount() == JobSystem::SingleThreaded)
+		{
+			for (const auto& node : mNodes)
+			{
+				UpdateComponent(node, gameTime);
+			}
+
+			return;
+		}
+
+		// The time is read through a member so each job captures two pointers, which std::function stores without allocating
+		mGameTime = &gameTime;
+		for (size_t i = 0; i < mNodes.size(); ++i)
+		{
+			const Node& node = mNodes[i];
+			mDependencyHandles.clear();
+			for (size_t dependency : node.Dependencies)
+			{
+				mDependencyHandles.push_back(mJobHandles[dependency]);
+			}
+
+			mJobHandles[i] = mJobs->Submit([this, &node]() { UpdateComponent(node, *mGameTime); }, mDependencyHandles);
+		}
+
+		mJobs->Wait(mJobHandles);
+		mGameTime = nullptr;
+	}
+
+	void ComponentScheduler::Invalidate()
+	{
+		mGraphStale = true;
+	}
+
+	bool ComponentScheduler::ValidationEnabled() const
+	{
+		return mValidationEnabled;
+	}
+
+	void ComponentScheduler::SetValidationEnabled(bool enabled)
+	{
+		mValidationEnabled = enabled;
+	}
+
+	size_t ComponentScheduler::ConcurrentComponentCount() const
+	{
+		return count_if(mNodes.begin(), mNodes.end(), [](const Node& node) { return node.Dependencies.empty(); });
+	}
+
+	void ComponentScheduler::ValidateRead(const GameComponent& component)
+	{
+		if (sUpdatingAccess != nullptr && sUpdatingComponent != &component && !sUpdatingAccess->CanRead(&component))
+		{
+			throw GameException("A component read another component during Update without declaring it.");
+		}
+	}
+
+	void ComponentScheduler::Build(const vector<shared_ptr<GameComponent>>& components)
+	{
+		mNodes.clear();
+		mNodes.reserve(components.size());
+		for (const auto& component : components)
+		{
+			// Disabled components are left out. Every conflicting pair has its own edge, so nothing is ordered through them.
+			if (!component->Enabled())
+			{
+				continue;
+			}
+
+			Node node{ component.get(), ComponentAccess(), vector<size_t>() };
+			node.Access.Writes(component.get());
+			component->DeclareAccess(node.Access);
+
+			for (size_t i = 0; i < mNodes.size(); ++i)
+			{
+				if (node.Access.ConflictsWith(mNodes[i].Access))
+				{
+					node.Dependencies.push_back(i);
+				}
+			}
+
+			mNodes.push_back(move(node));
+		}
+
+		mJobHandles.assign(mNodes.size(), nullptr);
+	}
+
+	void ComponentScheduler::UpdateComponent(const Node& node, const GameTime& gameTime) const
+	{
+		PROFILE_ZONE(node.Component->TypeInfoInstance().Name);
+
+		// A waiting thread can pick up another component's update, so the previous one is restored rather than cleared.
+		const GameComponent* previousComponent = sUpdatingComponent;
+		const ComponentAccess* previousAccess = sUpdatingAccess;
+		if (mValidationEnabled)
+		{
+			sUpdatingComponent = node.Component;
+			sUpdatingAccess = &node.Access;
+		}
+
+		try
+		{
+			node.Component->Update(gameTime);
+		}
+		catch (...)
+		{
+			sUpdatingComponent = previousComponent;
+			sUpdatingAccess = previousAccess;
+			throw;
+		}
+
+		sUpdatingComponent = previousComponent;
+		sUpdatingAccess = previousAccess;
+	}
+}
\ No newline at end of file
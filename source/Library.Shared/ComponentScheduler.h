@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "JobSystem.h"
+
+namespace Library
+{
+	class GameComponent;
+	class GameTime;
+
+	/// <summary>
+	/// What a component's Update touches beyond its own state. Resources are identified by address: another component,
+	/// or any object shared between components. Every component implicitly writes itself.
+	/// A component that declares nothing is exclusive, and updates with no other component running.
+	/// </summary>
+	class ComponentAccess final
+	{
+	public:
+		void Reads(const void* resource);
+		void Writes(const void* resource);
+		void SetExclusive();
+
+		bool IsExclusive() const;
+		bool CanRead(const void* resource) const;
+		bool CanWrite(const void* resource) const;
+
+		/// <summary>
+		/// True if the two can't update concurrently: either is exclusive, or one writes what the other reads or writes.
+		/// </summary>
+		bool ConflictsWith(const ComponentAccess& other) const;
+
+	private:
+		std::vector<const void*> mReads;
+		std::vector<const void*> mWrites;
+		bool mExclusive{ false };
+	};
+
+	/// <summary>
+	/// Updates a game's components through the job system, concurrently wherever their declared accesses allow.
+	/// Components keep the list's order wherever they conflict, so any two that share data still update in the same order as a plain loop.
+	/// The dependency graph holds only enabled components. It is built on the first update and again after Invalidate,
+	/// which Game calls whenever a component is added, removed, enabled or disabled.
+	/// With validation on, a component that reads another through its accessors without having declared it throws.
+	/// </summary>
+	class ComponentScheduler final
+	{
+	public:
+		explicit ComponentScheduler(JobSystem& jobs);
+		ComponentScheduler(const ComponentScheduler&) = delete;
+		ComponentScheduler& operator=(const ComponentScheduler&) = delete;
+		ComponentScheduler(ComponentScheduler&&) = delete;
+		ComponentScheduler& operator=(ComponentScheduler&&) = delete;
+		~ComponentScheduler() = default;
+
+		void Update(const std::vector<std::shared_ptr<GameComponent>>& components, const GameTime& gameTime);
+		void Invalidate();
+
+		bool ValidationEnabled() const;
+		void SetValidationEnabled(bool enabled);
+
+		std::size_t ConcurrentComponentCount() const; // Components with no dependency on an earlier one, and so free to start together
+
+		/// <summary>
+		/// Called by a component's accessors. Throws when the component updating on this thread reads component without having declared it.
+		/// </summary>
+		static void ValidateRead(const GameComponent& component);
+
+	private:
+#if defined(DEBUG) || defined(_DEBUG)
+		inline static const bool DefaultValidationEnabled{ true };
+#else
+		inline static const bool DefaultValidationEnabled{ false };
+#endif
+
+		struct Node final
+		{
+			GameComponent* Component;
+			ComponentAccess Access;
+			std::vector<std::size_t> Dependencies; // Earlier nodes this one conflicts with
+		};
+
+		void Build(const std::vector<std::shared_ptr<GameComponent>>& components);
+		void UpdateComponent(const Node& node, const GameTime& gameTime) const;
+
+		JobSystem* mJobs;
+		std::vector<Node> mNodes;
+		std::vector<JobHandle> mJobHandles; // Kept between frames with the handles they hold, so submitting reuses their storage
+		std::vector<JobHandle> mDependencyHandles;
+		const GameTime* mGameTime{ nullptr }; // While an update is in flight
+		std::atomic<bool> mGraphStale{ true };
+		bool mValidationEnabled{ DefaultValidationEnabled };
+	};
+}
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include "pch.h"
+#include "CompressionHelper.h"
+#include "GameException.h"
+
+using namespace std;
+using namespace gsl;
+
+namespace Library
+{
+	namespace
+	{
+		inline uint32_t ReadUInt32(const uint8_t* source)
+		{
+			uint32_t value;
+			memcpy(&value, source, sizeof(value));
+			return value;
+		}
+
+		inline void WriteLength(vector<uint8_t>& destination, size_t length)
+		{
+			while (length >= 255)
+			{
+				destination.push_back(255);
+				length -= 255;
+			}
+			destination.push_back(narrow_cast<uint8_t>(length));
+		}
+
+		inline size_t ReadLength(const uint8_t*& input, const uint8_t* inputEnd)
+		{
+			size_t length = 0;
+			uint8_t value;
+			do
+			{
+				if (input >= inputEnd)
+				{
+					throw GameException("Compressed block is truncated.");
+				}
+
+				value = *input++;
+				length += value;
+			} while (value == 255);
+
+			return length;
+		}
+	}
+
+	size_t CompressionHelper::CompressBound(size_t sourceSize)
+	{
+		return sourceSize + (sourceSize / 255) + 16;
+	}
+
+	size_t CompressionHelper::Compress(span<const uint8_t> source, vector<uint8_t>& destination)
+	{
+		destination.clear();
+		destination.reserve(CompressBound(source.size()));
+
+		const uint8_t* input = source.data();
+		const size_t sourceSize = source.size();
+		size_t literalStart = 0;
+
+		auto emitSequence = [&](size_t literalEnd, size_t matchLength, size_t offset)
+		{
+			const size_t literalLength = literalEnd - literalStart;
+			const size_t encodedMatchLength = (matchLength > 0 ? matchLength - MinMatchLength : 0);
+			const uint8_t literalToken = narrow_cast<uint8_t>(min<size_t>(literalLength, TokenLengthMask));
+			const uint8_t matchToken = narrow_cast<uint8_t>(min<size_t>(encodedMatchLength, TokenLengthMask));
+			destination.push_back(narrow_cast<uint8_t>((literalToken << 4) | matchToken));
+			if (literalLength >= TokenLengthMask)
+			{
+				WriteLength(destination, literalLength - TokenLengthMask);
+			}
+
+			destination.insert(destination.end(), input + literalStart, input + literalEnd);
+
+			if (matchLength > 0)
+			{
+				destination.push_back(narrow_cast<uint8_t>(offset & 0xFF));
+				destination.push_back(narrow_cast<uint8_t>(offset >> 8));
+				if (encodedMatchLength >= TokenLengthMask)
+				{
+					WriteLength(destination, encodedMatchLength - TokenLengthMask);
+				}
+			}
+		};
+
+		if (sourceSize > MinMatchLength)
+		{
+			vector<uint32_t> hashTable(size_t(1) << HashBits, numeric_limits<uint32_t>::max());
+			auto hash = [](uint32_t value)
+			{
+				return (value * 2654435761U) >> (32 - HashBits);
+			};
+
+			const size_t matchLimit = sourceSize - MinMatchLength;
+			size_t position = 0;
+			while (position <= matchLimit)
+			{
+				const uint32_t sequence = ReadUInt32(input + position);
+				uint32_t& slot = hashTable[hash(sequence)];
+				const uint32_t candidate = slot;
+				slot = narrow_cast<uint32_t>(position);
+
+				if (candidate != numeric_limits<uint32_t>::max() && position - candidate <= MaxOffset && ReadUInt32(input + candidate) == sequence)
+				{
+					size_t matchLength = MinMatchLength;
+					while (position + matchLength < sourceSize && input[candidate + matchLength] == input[position + matchLength])
+					{
+						++matchLength;
+					}
+
+					emitSequence(position, matchLength, position - candidate);
+					position += matchLength;
+					literalStart = position;
+				}
+				else
+				{
+					++position;
+				}
+			}
+		}
+
+		// The final sequence carries the trailing literals and no match.
+		emitSequence(sourceSize, 0, 0);
+
+		return destination.size();
+	}
+
+	void CompressionHelper::Decompress(span<const uint8_t> source, span<uint8_t> destination)
+	{
+		const uint8_t* input = source.data();
+		const uint8_t* const inputEnd = input + source.size();
+		uint8_t* output = destination.data();
+		uint8_t* const outputStart = output;
+		uint8_t* const outputEnd = output + destination.size();
+
+		while (input < inputEnd)
+		{
+			const uint8_t token = *input++;
+
+			size_t literalLength = token >> 4;
+			if (literalLength == TokenLengthMask)
+			{
+				literalLength += ReadLength(input, inputEnd);
+			}
+
+			if (literalLength > size_t(inputEnd - input) || literalLength > size_t(outputEnd - output))
+			{
+				throw GameException("Compressed block is corrupt.");
+			}
+
+			memcpy(output, input, literalLength);
+			input += literalLength;
+			output += literalLength;
+
+			if (input == inputEnd)
+			{
+				break;
+			}
+
+			if (inputEnd - input < 2)
+			{
+				throw GameException("Compressed block is truncated.");
+			}
+
+			const size_t offset = size_t(input[0]) | (size_t(input[1]) << 8);
+			input += 2;
+
+			size_t matchLength = token & TokenLengthMask;
+			if (matchLength == TokenLengthMask)
+			{
+				matchLength += ReadLength(input, inputEnd);
+			}
+			matchLength += MinMatchLength;
+
+			if (offset == 0 || offset > size_t(output - outputStart) || matchLength > size_t(outputEnd - output))
+			{
+				throw GameException("Compressed block is corrupt.");
+			}
+
+			// Matches may overlap the bytes they produce, so copy forward one byte at a time when they do.
+			const uint8_t* match = output - offset;
+			if (offset >= matchLength)
+			{
+				memcpy(output, match, matchLength);
+				output += matchLength;
+			}
+			else
+			{
+				for (size_t i = 0; i < matchLength; ++i)
+				{
+					*output++ = *match++;
+				}
+			}
+		}
+
+		if (output != outputEnd)
+		{
+			throw GameException("Compressed block size does not match the expected size.");
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <gsl\gsl>
+
+namespace Library
+{
+	/// <summary>
+	/// Byte-oriented LZ77 block compressor (LZ4-style token/literal/match sequences).
+	/// Blocks carry no header; the caller is responsible for storing the uncompressed size.
+	/// </summary>
+	class CompressionHelper final
+	{
+	public:
+		static std::size_t CompressBound(std::size_t sourceSize);
+		static std::size_t Compress(gsl::span<const std::uint8_t> source, std::vector<std::uint8_t>& destination);
+		static void Decompress(gsl::span<const std::uint8_t> source, gsl::span<std::uint8_t> destination);
+
+		CompressionHelper() = delete;
+		CompressionHelper(const CompressionHelper&) = delete;
+		CompressionHelper& operator=(const CompressionHelper&) = delete;
+		CompressionHelper(CompressionHelper&&) = delete;
+		CompressionHelper& operator=(CompressionHelper&&) = delete;
+		~CompressionHelper() = default;
+
+	private:
+		inline static const std::uint32_t MinMatchLength{ 4 };
+		inline static const std::uint32_t MaxOffset{ 65535 };
+		inline static const std::uint32_t HashBits{ 16 };
+		inline static const std::uint32_t TokenLengthMask{ 15 };
+	};
+}
\ No newline at end of file
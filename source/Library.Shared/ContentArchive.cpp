@@ -0,0 +1,243 @@
+#include "pch.h"
+#include "ContentArchive.h"
+#include "CompressionHelper.h"
+#include "GameException.h"
+
+using namespace std;
+using namespace gsl;
+using namespace winrt;
+
+namespace Library
+{
+	namespace
+	{
+		wchar_t NormalizeCharacter(wchar_t character)
+		{
+			return (character == L'/' ? L'\\' : narrow_cast<wchar_t>(towlower(character)));
+		}
+
+		bool StartsWithNormalized(const wstring& value, const wstring& prefix)
+		{
+			if (prefix.size() > value.size())
+			{
+				return false;
+			}
+
+			for (size_t i = 0; i < prefix.size(); ++i)
+			{
+				if (NormalizeCharacter(value[i]) != NormalizeCharacter(prefix[i]))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+	}
+
+	void ContentArchive::ViewDeleter::operator()(const void* view) const
+	{
+		UnmapViewOfFile(view);
+	}
+
+	ContentArchive::ContentArchive(const wstring& filename, const wstring& mountPoint) :
+		mFilename(filename), mMountPoint(mountPoint)
+	{
+		mFile.attach(CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr));
+		if (!mFile)
+		{
+			throw GameException("Could not open content archive.", HRESULT_FROM_WIN32(GetLastError()));
+		}
+
+		LARGE_INTEGER fileSize;
+		if (GetFileSizeEx(mFile.get(), &fileSize) == FALSE || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(ContentArchiveHeader)))
+		{
+			throw GameException("Content archive is truncated.");
+		}
+		mFileSize = static_cast<uint64_t>(fileSize.QuadPart);
+
+		mFileMapping.attach(CreateFileMappingW(mFile.get(), nullptr, PAGE_READONLY, 0, 0, nullptr));
+		if (!mFileMapping)
+		{
+			throw GameException("CreateFileMappingW() failed.", HRESULT_FROM_WIN32(GetLastError()));
+		}
+
+		mView.reset(MapViewOfFile(mFileMapping.get(), FILE_MAP_READ, 0, 0, 0));
+		if (mView == nullptr)
+		{
+			throw GameException("MapViewOfFile() failed.", HRESULT_FROM_WIN32(GetLastError()));
+		}
+
+		mHeader = reinterpret_cast<const ContentArchiveHeader*>(mView.get());
+		if (mHeader->Signature != Signature || mHeader->Version != CurrentVersion)
+		{
+			throw GameException("Unsupported content archive format.");
+		}
+
+		const uint64_t tableOfContentsSize = uint64_t(mHeader->EntryCount) * sizeof(ContentArchiveEntry);
+		if (mHeader->TableOfContentsOffset > mFileSize || tableOfContentsSize > mFileSize - mHeader->TableOfContentsOffset ||
+			mHeader->NamesOffset > mFileSize || mHeader->NamesSize > mFileSize - mHeader->NamesOffset)
+		{
+			throw GameException("Content archive is truncated.");
+		}
+
+		auto base = reinterpret_cast<const uint8_t*>(mView.get());
+		mEntries = span<const ContentArchiveEntry>(reinterpret_cast<const ContentArchiveEntry*>(base + mHeader->TableOfContentsOffset), mHeader->EntryCount);
+		for (const auto& entry : mEntries)
+		{
+			if (entry.Offset > mFileSize || entry.StoredSize > mFileSize - entry.Offset)
+			{
+				throw GameException("Content archive entry lies outside of the archive.");
+			}
+		}
+	}
+
+	const wstring& ContentArchive::Filename() const
+	{
+		return mFilename;
+	}
+
+	const wstring& ContentArchive::MountPoint() const
+	{
+		return mMountPoint;
+	}
+
+	span<const ContentArchiveEntry> ContentArchive::Entries() const
+	{
+		return mEntries;
+	}
+
+	const ContentArchiveEntry* ContentArchive::Find(AssetId assetId) const
+	{
+		auto it = lower_bound(mEntries.begin(), mEntries.end(), assetId, [](const ContentArchiveEntry& entry, AssetId id)
+		{
+			return entry.AssetId < id;
+		});
+
+		return (it != mEntries.end() && it->AssetId == assetId ? &(*it) : nullptr);
+	}
+
+	const ContentArchiveEntry* ContentArchive::Find(const wstring& filename) const
+	{
+		if (mMountPoint.empty())
+		{
+			return Find(ComputeAssetId(filename));
+		}
+
+		if (!StartsWithNormalized(filename, mMountPoint))
+		{
+			return nullptr;
+		}
+
+		return Find(ComputeAssetId(filename.substr(mMountPoint.size())));
+	}
+
+	string ContentArchive::EntryName(const ContentArchiveEntry& entry) const
+	{
+		if (entry.NameOffset >= mHeader->NamesSize)
+		{
+			return string();
+		}
+
+		auto names = reinterpret_cast<const char*>(mView.get()) + mHeader->NamesOffset;
+		const size_t maxLength = narrow_cast<size_t>(mHeader->NamesSize - entry.NameOffset);
+		const char* name = names + entry.NameOffset;
+		return string(name, find(name, name + maxLength, '\0'));
+	}
+
+	span<const uint8_t> ContentArchive::EntryData(const ContentArchiveEntry& entry) const
+	{
+		auto base = reinterpret_cast<const uint8_t*>(mView.get());
+		return span<const uint8_t>(base + entry.Offset, narrow_cast<size_t>(entry.StoredSize));
+	}
+
+	void ContentArchive::Read(const ContentArchiveEntry& entry, vector<char>& data) const
+	{
+		auto storedData = EntryData(entry);
+		data.resize(narrow_cast<size_t>(entry.Size));
+
+		if (entry.Flags == ContentArchiveEntryFlags::Compressed)
+		{
+			CompressionHelper::Decompress(storedData, span<uint8_t>(reinterpret_cast<uint8_t*>(data.data()), data.size()));
+		}
+		else
+		{
+			if (entry.StoredSize != entry.Size)
+			{
+				throw GameException("Content archive entry is corrupt.");
+			}
+
+			copy(storedData.begin(), storedData.end(), reinterpret_cast<uint8_t*>(data.data()));
+		}
+	}
+
+	bool ContentArchive::TryRead(const wstring& filename, vector<char>& data) const
+	{
+		auto entry = Find(filename);
+		if (entry == nullptr)
+		{
+			return false;
+		}
+
+		Read(*entry, data);
+		return true;
+	}
+
+	ContentArchive::AssetId ContentArchive::ComputeAssetId(const wstring& assetName)
+	{
+		const uint64_t offsetBasis = 14695981039346656037ULL;
+		const uint64_t prime = 1099511628211ULL;
+
+		size_t start = 0;
+		while (start + 1 < assetName.size() && assetName[start] == L'.' && (assetName[start + 1] == L'\\' || assetName[start + 1] == L'/'))
+		{
+			start += 2;
+		}
+
+		// Hash the normalized UTF-16 code units so ids match regardless of path case or separator style.
+		uint64_t hash = offsetBasis;
+		for (size_t i = start; i < assetName.size(); ++i)
+		{
+			const uint16_t character = narrow_cast<uint16_t>(NormalizeCharacter(assetName[i]));
+			hash = (hash ^ (character & 0xFF)) * prime;
+			hash = (hash ^ (character >> 8)) * prime;
+		}
+
+		return hash;
+	}
+
+	void ContentArchive::Mount(const shared_ptr<ContentArchive>& archive)
+	{
+		assert(archive != nullptr);
+		sMountedArchives.push_back(archive);
+	}
+
+	void ContentArchive::Unmount(const shared_ptr<ContentArchive>& archive)
+	{
+		sMountedArchives.erase(remove(sMountedArchives.begin(), sMountedArchives.end(), archive), sMountedArchives.end());
+	}
+
+	void ContentArchive::UnmountAll()
+	{
+		sMountedArchives.clear();
+	}
+
+	const vector<shared_ptr<ContentArchive>>& ContentArchive::MountedArchives()
+	{
+		return sMountedArchives;
+	}
+
+	bool ContentArchive::TryReadMounted(const wstring& filename, vector<char>& data)
+	{
+		// Most recently mounted archives take precedence.
+		for (auto it = sMountedArchives.rbegin(); it != sMountedArchives.rend(); ++it)
+		{
+			if ((*it)->TryRead(filename, data))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <gsl\gsl>
+
+namespace Library
+{
+	enum class ContentArchiveEntryFlags : std::uint32_t
+	{
+		None = 0,
+		Compressed = 1
+	};
+
+	struct ContentArchiveHeader final
+	{
+		std::uint32_t Signature;
+		std::uint32_t Version;
+		std::uint32_t EntryCount;
+		std::uint32_t Alignment;
+		std::uint64_t TableOfContentsOffset;
+		std::uint64_t NamesOffset;
+		std::uint64_t NamesSize;
+	};
+
+	struct ContentArchiveEntry final
+	{
+		std::uint64_t AssetId;
+		std::uint64_t Offset;
+		std::uint64_t StoredSize;
+		std::uint64_t Size;
+		ContentArchiveEntryFlags Flags;
+		std::uint32_t NameOffset;
+	};
+
+	static_assert(sizeof(ContentArchiveHeader) == 40, "ContentArchiveHeader layout is part of the file format.");
+	static_assert(sizeof(ContentArchiveEntry) == 40, "ContentArchiveEntry layout is part of the file format.");
+
+	/// <summary>
+	/// Read-only, memory-mapped content archive. The table of contents is sorted by asset id
+	/// (FNV-1a of the normalized asset path, relative to the content root) and each entry is
+	/// either stored or compressed with CompressionHelper.
+	/// </summary>
+	class ContentArchive final
+	{
+	public:
+		using AssetId = std::uint64_t;
+
+		inline static const std::uint32_t Signature{ 0x4B505353 }; // "SSPK"
+		inline static const std::uint32_t CurrentVersion{ 1 };
+		inline static const std::uint32_t DefaultAlignment{ 16 };
+
+		ContentArchive(const std::wstring& filename, const std::wstring& mountPoint = std::wstring());
+		ContentArchive(const ContentArchive&) = delete;
+		ContentArchive& operator=(const ContentArchive&) = delete;
+		ContentArchive(ContentArchive&&) = default;
+		ContentArchive& operator=(ContentArchive&&) = default;
+		~ContentArchive() = default;
+
+		const std::wstring& Filename() const;
+		const std::wstring& MountPoint() const;
+		gsl::span<const ContentArchiveEntry> Entries() const;
+
+		const ContentArchiveEntry* Find(AssetId assetId) const;
+		const ContentArchiveEntry* Find(const std::wstring& filename) const;
+		std::string EntryName(const ContentArchiveEntry& entry) const;
+		gsl::span<const std::uint8_t> EntryData(const ContentArchiveEntry& entry) const;
+
+		void Read(const ContentArchiveEntry& entry, std::vector<char>& data) const;
+		bool TryRead(const std::wstring& filename, std::vector<char>& data) const;
+
+		static AssetId ComputeAssetId(const std::wstring& assetName);
+
+		static void Mount(const std::shared_ptr<ContentArchive>& archive);
+		static void Unmount(const std::shared_ptr<ContentArchive>& archive);
+		static void UnmountAll();
+		static const std::vector<std::shared_ptr<ContentArchive>>& MountedArchives();
+		static bool TryReadMounted(const std::wstring& filename, std::vector<char>& data);
+
+	private:
+		struct ViewDeleter final
+		{
+			void operator()(const void* view) const;
+		};
+
+		std::wstring mFilename;
+		std::wstring mMountPoint;
+		winrt::file_handle mFile;
+		winrt::handle mFileMapping;
+		std::unique_ptr<const void, ViewDeleter> mView;
+		std::uint64_t mFileSize{ 0 };
+		const ContentArchiveHeader* mHeader{ nullptr };
+		gsl::span<const ContentArchiveEntry> mEntries;
+
+		inline static std::vector<std::shared_ptr<ContentArchive>> sMountedArchives;
+	};
+}
\ No newline at end of file
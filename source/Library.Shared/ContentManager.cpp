@@ -1,6 +1,8 @@
 #include "pch.h"
 #include "ContentManager.h"
 #include "ContentTypeReaderManager.h"
+#include "ContentArchive.h"
+#include "ContentPrefetcher.h"
 #include "GameException.h"
 
 using namespace std;
@@ -8,12 +10,61 @@ using namespace std;
 namespace Library
 {
 	const wstring ContentManager::DefaultRootDirectory{ L"Content\\" };
+	const wstring ContentManager::DefaultPrefetchManifestName{ L"Prefetch.manifest" };
 
 	ContentManager::ContentManager(Game& game, const wstring& rootDirectory) :
 		mGame(game), mRootDirectory(rootDirectory)
 	{
 	}
 
+	bool ContentManager::MountArchive(const wstring& archiveName)
+	{
+		const wstring archivePath = mRootDirectory + archiveName;
+		if (!filesystem::exists(archivePath))
+		{
+			return false;
+		}
+
+		auto archive = make_shared<ContentArchive>(archivePath, mRootDirectory);
+		ContentArchive::Mount(archive);
+		mMountedArchives.push_back(move(archive));
+
+		return true;
+	}
+
+	void ContentManager::UnmountArchives()
+	{
+		for (const auto& archive : mMountedArchives)
+		{
+			ContentArchive::Unmount(archive);
+		}
+
+		mMountedArchives.clear();
+	}
+
+	void ContentManager::BeginPrefetch(const wstring& manifestName)
+	{
+		EndPrefetch();
+
+		mPrefetcher = make_shared<ContentPrefetcher>(mRootDirectory + manifestName);
+		ContentPrefetcher::Install(mPrefetcher);
+		mPrefetcher->Start();
+	}
+
+	void ContentManager::EndPrefetch()
+	{
+		if (mPrefetcher == nullptr || !mPrefetcher->IsRecording())
+		{
+			return;
+		}
+
+		mPrefetcher->Finish();
+		if (ContentPrefetcher::Installed() == mPrefetcher)
+		{
+			ContentPrefetcher::Uninstall();
+		}
+	}
+
 	void ContentManager::AddAsset(const wstring& assetName, const shared_ptr<RTTI>& asset)
 	{
 		mLoadedAssets[assetName] = asset;
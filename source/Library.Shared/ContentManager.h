@@ -2,14 +2,18 @@
 
 #include <memory>
 #include <map>
+#include <vector>
 #include <algorithm>
 #include <functional>
 #include "RTTI.h"
 #include "StringHelper.h"
+#include "Profiler.h"
 
 namespace Library
 {
 	class Game;
+	class ContentArchive;
+	class ContentPrefetcher;
 
 	class ContentManager final
 	{
@@ -28,18 +32,29 @@ namespace Library
 		template <typename T>
 		std::shared_ptr<T> Load(const std::wstring& assetName, bool reload = false, std::function<std::shared_ptr<T>(std::wstring&)> customReader = nullptr);
 
+		bool MountArchive(const std::wstring& archiveName);
+		void UnmountArchives();
+		const std::vector<std::shared_ptr<ContentArchive>>& MountedArchives() const;
+
+		void BeginPrefetch(const std::wstring& manifestName = DefaultPrefetchManifestName);
+		void EndPrefetch();
+		const std::shared_ptr<ContentPrefetcher>& Prefetcher() const;
+
 		void AddAsset(const std::wstring& assetName, const std::shared_ptr<RTTI>& asset);
 		void RemoveAsset(const std::wstring& assetName);
 		void Clear();
 
 	private:
 		static const std::wstring DefaultRootDirectory;
+		static const std::wstring DefaultPrefetchManifestName;
 
 		std::shared_ptr<RTTI> ReadAsset(const std::int64_t targetTypeId, const std::wstring& assetName);
 
 		Library::Game& mGame;
 		std::map<std::wstring, std::shared_ptr<RTTI>> mLoadedAssets;
 		std::wstring mRootDirectory;
+		std::vector<std::shared_ptr<ContentArchive>> mMountedArchives;
+		std::shared_ptr<ContentPrefetcher> mPrefetcher;
 	};
 }
 
@@ -13,6 +13,16 @@ namespace Library
 		return mRootDirectory;
 	}
 
+	inline const std::vector<std::shared_ptr<ContentArchive>>& ContentManager::MountedArchives() const
+	{
+		return mMountedArchives;
+	}
+
+	inline const std::shared_ptr<ContentPrefetcher>& ContentManager::Prefetcher() const
+	{
+		return mPrefetcher;
+	}
+
 	inline void ContentManager::SetRootDirectory(const std::wstring& rootDirectory)
 	{
 		mRootDirectory = rootDirectory + (StringHelper::EndsWith(rootDirectory, L"\\") ? std::wstring() : L"\\");
@@ -21,6 +31,8 @@ namespace Library
 	template<typename T>
 	inline std::shared_ptr<T> ContentManager::Load(const std::wstring& assetName, bool reload, std::function<std::shared_ptr<T>(std::wstring&)> customReader)
 	{
+		PROFILE_FUNCTION();
+
 		if (reload == false)
 		{
 			auto it = mLoadedAssets.find(assetName);
@@ -0,0 +1,304 @@
+#include "pch.h"
+#include "ContentPrefetcher.h"
+#include "GameException.h"
+#include "Utility.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace gsl;
+
+namespace Library
+{
+	ContentPrefetcher::ContentPrefetcher(const wstring& manifestFilename, uint32_t threadCount) :
+		mManifestFilename(manifestFilename), mThreadCount(max(threadCount, 1U))
+	{
+	}
+
+	ContentPrefetcher::~ContentPrefetcher()
+	{
+		StopThreads();
+	}
+
+	const wstring& ContentPrefetcher::ManifestFilename() const
+	{
+		return mManifestFilename;
+	}
+
+	const vector<ContentPrefetchEntry>& ContentPrefetcher::RecordedEntries() const
+	{
+		return mRecordedEntries;
+	}
+
+	ContentPrefetchStatistics ContentPrefetcher::Statistics() const
+	{
+		lock_guard<mutex> lock(mMutex);
+		return mStatistics;
+	}
+
+	bool ContentPrefetcher::IsRecording() const
+	{
+		lock_guard<mutex> lock(mMutex);
+		return mIsRecording;
+	}
+
+	void ContentPrefetcher::Start()
+	{
+		assert(!IsRecording() && mThreads.empty());
+
+		{
+			lock_guard<mutex> lock(mMutex);
+			mStartTime = high_resolution_clock::now();
+			mIsRecording = true;
+		}
+
+		vector<ContentPrefetchEntry> manifestEntries;
+		if (!LoadManifest(manifestEntries))
+		{
+			return;
+		}
+
+		for (const ContentPrefetchEntry& manifestEntry : manifestEntries)
+		{
+			if (mEntries.try_emplace(manifestEntry.Filename).second)
+			{
+				mReadOrder.push_back(manifestEntry.Filename);
+			}
+		}
+
+		const size_t threadCount = min(size_t(mThreadCount), mReadOrder.size());
+		mThreads.reserve(threadCount);
+		for (size_t i = 0; i < threadCount; ++i)
+		{
+			mThreads.emplace_back([this]() { ReadAhead(); });
+		}
+	}
+
+	void ContentPrefetcher::Finish()
+	{
+		{
+			// Loads on other threads stop recording here, so the manifest is no longer written to once it is saved.
+			lock_guard<mutex> lock(mMutex);
+			if (!mIsRecording)
+			{
+				return;
+			}
+
+			mIsRecording = false;
+		}
+
+		StopThreads();
+
+		{
+			lock_guard<mutex> lock(mMutex);
+			mStatistics.TimeToFirstFrameMilliseconds = duration<float, milli>(high_resolution_clock::now() - mStartTime).count();
+
+			// Without read-ahead this start is the reference the next ones are compared against.
+			if (mReadOrder.empty())
+			{
+				mStatistics.BaselineTimeToFirstFrameMilliseconds = mStatistics.TimeToFirstFrameMilliseconds;
+			}
+
+			// Anything read ahead but never loaded is dropped; the manifest is rewritten from this start's reads.
+			mEntries.clear();
+			mReadOrder.clear();
+		}
+
+		try
+		{
+			SaveManifest();
+		}
+		catch (const exception&)
+		{
+			// Read-only content directories only lose the read-ahead on the next start.
+		}
+	}
+
+	bool ContentPrefetcher::TryTake(const wstring& filename, vector<char>& data)
+	{
+		unique_lock<mutex> lock(mMutex);
+		auto it = mEntries.find(filename);
+		if (it == mEntries.end())
+		{
+			return false;
+		}
+
+		Entry& entry = it->second;
+		if (entry.State == EntryState::Queued)
+		{
+			// No thread has reached the file yet, so the caller reads it rather than waiting behind the queue.
+			entry.State = EntryState::Claimed;
+			return false;
+		}
+
+		mEntryReady.wait(lock, [&entry]() { return entry.State != EntryState::Reading; });
+		if (entry.State != EntryState::Ready)
+		{
+			return false;
+		}
+
+		data = move(entry.Data);
+		entry.State = EntryState::Claimed;
+		++mStatistics.HitCount;
+		Record(filename, data.size(), entry.ReadMilliseconds);
+
+		return true;
+	}
+
+	void ContentPrefetcher::RecordRead(const wstring& filename, uint64_t size, float readMilliseconds)
+	{
+		lock_guard<mutex> lock(mMutex);
+		if (!mIsRecording)
+		{
+			return;
+		}
+
+		++mStatistics.MissCount;
+		Record(filename, size, readMilliseconds);
+	}
+
+	void ContentPrefetcher::Record(const wstring& filename, uint64_t size, float readMilliseconds)
+	{
+		if (!mIsRecording)
+		{
+			return;
+		}
+
+		if (mRecordedIndices.try_emplace(filename, mRecordedEntries.size()).second)
+		{
+			mRecordedEntries.push_back({ filename, size, readMilliseconds });
+		}
+	}
+
+	void ContentPrefetcher::ReadAhead()
+	{
+		for (;;)
+		{
+			wstring filename;
+			{
+				lock_guard<mutex> lock(mMutex);
+				while (mNextRead < mReadOrder.size() && mEntries[mReadOrder[mNextRead]].State != EntryState::Queued)
+				{
+					++mNextRead;
+				}
+
+				if (mStopping || mNextRead == mReadOrder.size())
+				{
+					return;
+				}
+
+				filename = mReadOrder[mNextRead++];
+				mEntries[filename].State = EntryState::Reading;
+			}
+
+			vector<char> data;
+			bool succeeded = true;
+			const auto startTime = high_resolution_clock::now();
+			try
+			{
+				Utility::ReadBinaryFile(filename, data);
+			}
+			catch (const exception&)
+			{
+				// The load itself reads the file again and reports the error.
+				succeeded = false;
+			}
+
+			const float readMilliseconds = duration<float, milli>(high_resolution_clock::now() - startTime).count();
+			{
+				lock_guard<mutex> lock(mMutex);
+				Entry& entry = mEntries[filename];
+				entry.State = (succeeded ? EntryState::Ready : EntryState::Failed);
+				entry.ReadMilliseconds = readMilliseconds;
+				if (succeeded)
+				{
+					++mStatistics.PrefetchedFileCount;
+					mStatistics.PrefetchedBytes += data.size();
+					entry.Data = move(data);
+				}
+			}
+
+			mEntryReady.notify_all();
+		}
+	}
+
+	void ContentPrefetcher::StopThreads()
+	{
+		{
+			lock_guard<mutex> lock(mMutex);
+			mStopping = true;
+		}
+
+		for (thread& readThread : mThreads)
+		{
+			readThread.join();
+		}
+
+		mThreads.clear();
+		mStopping = false;
+	}
+
+	bool ContentPrefetcher::LoadManifest(vector<ContentPrefetchEntry>& entries)
+	{
+		ifstream file(mManifestFilename);
+		if (!file.good())
+		{
+			return false;
+		}
+
+		// Format: the version, the baseline time to first frame, then one "size <tab> milliseconds <tab> UTF-8 filename" line per file
+		uint32_t version = 0;
+		float baselineMilliseconds = 0.0f;
+		if (!(file >> version >> baselineMilliseconds) || version != FileVersion)
+		{
+			return false;
+		}
+
+		string line;
+		getline(file, line);
+		while (getline(file, line))
+		{
+			istringstream lineStream(line);
+			ContentPrefetchEntry entry;
+			string filename;
+			if (lineStream >> entry.Size >> entry.ReadMilliseconds && lineStream.get() == '\t' && getline(lineStream, filename) && !filename.empty())
+			{
+				entry.Filename = Utility::ToWideString(filename);
+				entries.push_back(move(entry));
+			}
+		}
+
+		mStatistics.BaselineTimeToFirstFrameMilliseconds = baselineMilliseconds;
+
+		return !entries.empty();
+	}
+
+	void ContentPrefetcher::SaveManifest() const
+	{
+		ofstream file(mManifestFilename, ios::trunc);
+		if (!file.good())
+		{
+			throw GameException("Could not open the prefetch manifest for writing.");
+		}
+
+		file << FileVersion << '\n' << mStatistics.BaselineTimeToFirstFrameMilliseconds << '\n';
+		for (const ContentPrefetchEntry& entry : mRecordedEntries)
+		{
+			file << entry.Size << '\t' << entry.ReadMilliseconds << '\t' << Utility::ToString(entry.Filename) << '\n';
+		}
+	}
+
+	void ContentPrefetcher::Install(const shared_ptr<ContentPrefetcher>& prefetcher)
+	{
+		sInstalled = prefetcher;
+	}
+
+	void ContentPrefetcher::Uninstall()
+	{
+		sInstalled = nullptr;
+	}
+
+	const shared_ptr<ContentPrefetcher>& ContentPrefetcher::Installed()
+	{
+		return sInstalled;
+	}
+}
\ No newline at end of file
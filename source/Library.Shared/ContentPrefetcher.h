@@ -0,0 +1,106 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Library
+{
+	struct ContentPrefetchEntry final
+	{
+		std::wstring Filename;
+		std::uint64_t Size{ 0 };
+		float ReadMilliseconds{ 0.0f };
+	};
+
+	struct ContentPrefetchStatistics final
+	{
+		std::uint32_t PrefetchedFileCount{ 0 }; // Files named by the manifest and read ahead
+		std::uint64_t PrefetchedBytes{ 0 };
+		std::uint32_t HitCount{ 0 }; // Loads served from read-ahead memory
+		std::uint32_t MissCount{ 0 }; // Loads that read the file themselves
+		float TimeToFirstFrameMilliseconds{ 0.0f };
+		float BaselineTimeToFirstFrameMilliseconds{ 0.0f }; // Measured by the last start without a manifest; 0 when unknown
+	};
+
+	/// <summary>
+	/// Records the files read between Start() and Finish() (normally everything loaded before the first frame) into a manifest,
+	/// and on later starts reads the manifest's files ahead on background threads, in the recorded order.
+	/// Utility::LoadBinaryFile consults the installed prefetcher, so content readers find their bytes already in memory.
+	/// Archives must be mounted before Start(), since the read-ahead threads read through them.
+	/// </summary>
+	class ContentPrefetcher final
+	{
+	public:
+		inline static const std::uint32_t FileVersion{ 1 };
+		inline static const std::uint32_t DefaultThreadCount{ 4 };
+
+		explicit ContentPrefetcher(const std::wstring& manifestFilename, std::uint32_t threadCount = DefaultThreadCount);
+		ContentPrefetcher(const ContentPrefetcher&) = delete;
+		ContentPrefetcher& operator=(const ContentPrefetcher&) = delete;
+		ContentPrefetcher(ContentPrefetcher&&) = delete;
+		ContentPrefetcher& operator=(ContentPrefetcher&&) = delete;
+		~ContentPrefetcher();
+
+		const std::wstring& ManifestFilename() const;
+		const std::vector<ContentPrefetchEntry>& RecordedEntries() const;
+		ContentPrefetchStatistics Statistics() const;
+		bool IsRecording() const;
+
+		void Start();
+		void Finish();
+
+		bool TryTake(const std::wstring& filename, std::vector<char>& data);
+		void RecordRead(const std::wstring& filename, std::uint64_t size, float readMilliseconds);
+
+		static void Install(const std::shared_ptr<ContentPrefetcher>& prefetcher);
+		static void Uninstall();
+		static const std::shared_ptr<ContentPrefetcher>& Installed();
+
+	private:
+		enum class EntryState
+		{
+			Queued,
+			Reading,
+			Ready,
+			Claimed, // Taken by a load, or read by it directly before a thread got to it
+			Failed
+		};
+
+		struct Entry final
+		{
+			EntryState State{ EntryState::Queued };
+			std::vector<char> Data;
+			float ReadMilliseconds{ 0.0f };
+		};
+
+		void Record(const std::wstring& filename, std::uint64_t size, float readMilliseconds); // Caller holds mMutex
+		bool LoadManifest(std::vector<ContentPrefetchEntry>& entries);
+		void SaveManifest() const;
+		void ReadAhead();
+		void StopThreads();
+
+		std::wstring mManifestFilename;
+		std::uint32_t mThreadCount;
+		mutable std::mutex mMutex;
+		std::condition_variable mEntryReady;
+		std::map<std::wstring, Entry> mEntries;
+		std::vector<std::wstring> mReadOrder;
+		std::size_t mNextRead{ 0 };
+		bool mStopping{ false };
+		std::vector<std::thread> mThreads;
+		std::vector<ContentPrefetchEntry> mRecordedEntries;
+		std::map<std::wstring, std::size_t> mRecordedIndices;
+		ContentPrefetchStatistics mStatistics;
+		std::chrono::high_resolution_clock::time_point mStartTime;
+		bool mIsRecording{ false }; // Guarded by mMutex, as loads on worker threads record their reads
+
+		inline static std::shared_ptr<ContentPrefetcher> sInstalled;
+	};
+}
\ No newline at end of file
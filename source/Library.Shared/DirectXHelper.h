@@ -53,6 +53,12 @@ namespace Library
 		return isProgrammableMap.at(shaderStage);
 	}
 
+	inline std::uint32_t IndexFormatSize(DXGI_FORMAT indexFormat)
+	{
+		assert(indexFormat == DXGI_FORMAT_R16_UINT || indexFormat == DXGI_FORMAT_R32_UINT);
+		return static_cast<std::uint32_t>(indexFormat == DXGI_FORMAT_R16_UINT ? sizeof(std::uint16_t) : sizeof(std::uint32_t));
+	}
+
 	void CreateIndexBuffer(gsl::not_null<ID3D11Device*> device, const gsl::span<const std::uint16_t>& indices, gsl::not_null<ID3D11Buffer**> indexBuffer);
 	void CreateIndexBuffer(gsl::not_null<ID3D11Device*> device, const gsl::span<const std::uint32_t>& indices, gsl::not_null<ID3D11Buffer**> indexBuffer);
 
@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "DrawableGameComponent.h"
+#include "Game.h"
 
 using namespace std;
 
@@ -19,7 +20,25 @@ namespace Library
 
 	void DrawableGameComponent::SetVisible(bool visible)
 	{
-		mVisible = visible;
+		if (mVisible != visible)
+		{
+			mVisible = visible;
+			mGame->DrawableComponentChanged(*this);
+		}
+	}
+
+	int DrawableGameComponent::DrawOrder() const
+	{
+		return mDrawOrder;
+	}
+
+	void DrawableGameComponent::SetDrawOrder(int drawOrder)
+	{
+		if (mDrawOrder != drawOrder)
+		{
+			mDrawOrder = drawOrder;
+			mGame->DrawableComponentChanged(*this);
+		}
 	}
 
 	shared_ptr<Camera> DrawableGameComponent::GetCamera()
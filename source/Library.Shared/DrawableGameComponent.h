@@ -23,6 +23,9 @@ namespace Library
         bool Visible() const;
         void SetVisible(bool visible);
 
+		int DrawOrder() const; // Lower draws first; equal orders draw in the order they were added
+		void SetDrawOrder(int drawOrder);
+
 		std::shared_ptr<Camera> GetCamera();
 		void SetCamera(const std::shared_ptr<Camera>& camera);
 
@@ -30,6 +33,7 @@ namespace Library
 
     protected:
 		bool mVisible{ true };
+		int mDrawOrder{ 0 };
 		std::shared_ptr<Camera> mCamera;
     };
 }
\ No newline at end of file
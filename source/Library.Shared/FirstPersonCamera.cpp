@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "FirstPersonCamera.h"
+#include "ComponentScheduler.h"
 #include "MouseComponent.h"
 #include "KeyboardComponent.h"
 #include "Game.h"
@@ -92,9 +93,9 @@ namespace Library
 
 	void FirstPersonCamera::Initialize()
 	{
-		mGamePad = reinterpret_cast<GamePadComponent*>(mGame->Services().GetService(GamePadComponent::TypeIdClass()));
-		mKeyboard = (KeyboardComponent*)mGame->Services().GetService(KeyboardComponent::TypeIdClass());
-		mMouse = (MouseComponent*)mGame->Services().GetService(MouseComponent::TypeIdClass());
+		mGamePad = mGame->Services().GetService<GamePadComponent>();
+		mKeyboard = mGame->Services().GetService<KeyboardComponent>();
+		mMouse = mGame->Services().GetService<MouseComponent>();
 
 		Camera::Initialize();
 	}
@@ -160,6 +161,13 @@ namespace Library
         Camera::Update(gameTime);
     }
 
+	void FirstPersonCamera::DeclareAccess(ComponentAccess& access) const
+	{
+		access.Reads(mGamePad);
+		access.Reads(mKeyboard);
+		access.Reads(mMouse);
+	}
+
 	void FirstPersonCamera::UpdatePosition(const XMFLOAT2& movementAmount, const XMFLOAT2& rotationAmount, const GameTime& gameTime)
 	{
 		float elapsedTime = gameTime.ElapsedGameTimeSeconds().count();
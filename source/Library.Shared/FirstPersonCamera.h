@@ -44,6 +44,7 @@ namespace Library
 
 		virtual void Initialize() override;
         virtual void Update(const GameTime& gameTime) override;
+        virtual void DeclareAccess(ComponentAccess& access) const override;
 
 		inline static const float DefaultMouseSensitivity{ 0.1f };
 		inline static const float DefaultRotationRate{ DirectX::XMConvertToRadians(100.0f) };
@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "FpsComponent.h"
 #include "Game.h"
+#include "Utility.h"
 
 using namespace std;
 using namespace std::literals;
@@ -33,7 +34,10 @@ namespace Library
 	void FpsComponent::Initialize()
 	{
 		mSpriteBatch = make_unique<SpriteBatch>(mGame->Direct3DDeviceContext());
-		mSpriteFont = make_unique<SpriteFont>(mGame->Direct3DDevice(), L"Content\\Fonts\\Arial_14_Regular.spritefont");
+
+		vector<char> fontData;
+		Utility::LoadBinaryFile(L"Content\\Fonts\\Arial_14_Regular.spritefont", fontData);
+		mSpriteFont = make_unique<SpriteFont>(mGame->Direct3DDevice(), reinterpret_cast<const uint8_t*>(fontData.data()), fontData.size());
 	}
 
 	void FpsComponent::Update(const GameTime& gameTime)
@@ -48,13 +52,17 @@ namespace Library
 		++mFrameCount;
 	}
 
+	void FpsComponent::DeclareAccess(ComponentAccess&) const
+	{
+		// Counts frames into its own state only
+	}
+
 	void FpsComponent::Draw(const GameTime& gameTime)
 	{
 		mSpriteBatch->Begin();
 
-		wostringstream fpsLabel;
-		fpsLabel << setprecision(4) << L"Frame Rate: " << mFrameRate << L"    Total Elapsed Time: " << gameTime.TotalGameTimeSeconds().count();
-		mSpriteFont->DrawString(mSpriteBatch.get(), fpsLabel.str().c_str(), mTextPosition);
+		const wchar_t* fpsLabel = mGame->FrameMemory().Format(L"Frame Rate: %d    Total Elapsed Time: %.4g", mFrameRate, gameTime.TotalGameTimeSeconds().count());
+		mSpriteFont->DrawString(mSpriteBatch.get(), fpsLabel, mTextPosition);
 
 		mSpriteBatch->End();
 	}
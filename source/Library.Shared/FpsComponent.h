@@ -25,6 +25,7 @@ namespace Library
 
 		virtual void Initialize() override;
 		virtual void Update(const GameTime& gameTime) override;
+		virtual void DeclareAccess(ComponentAccess& access) const override;
 		virtual void Draw(const GameTime& gameTime) override;
 
 	private:
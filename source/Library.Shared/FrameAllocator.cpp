@@ -0,0 +1,96 @@
+#include "pch.h"
+#include "FrameAllocator.h"
+
+using namespace std;
+
+namespace Library
+{
+	FrameAllocator::FrameAllocator(size_t capacity) :
+		mBuffer(make_unique<byte[]>(max(capacity, sizeof(max_align_t)))), mCapacity(max(capacity, sizeof(max_align_t)))
+	{
+	}
+
+	void FrameAllocator::Reset()
+	{
+		const size_t usedBytes = UsedBytes();
+		mPeakBytes = max(mPeakBytes, usedBytes);
+
+		if (!mOverflowBlocks.empty())
+		{
+			// Regrown once, to fit the frame that overflowed, rather than falling back every frame after it
+			++mOverflowFrameCount;
+			mOverflowBlocks.clear();
+			mOverflowBytes = 0;
+
+			while (mCapacity < usedBytes)
+			{
+				mCapacity *= 2;
+			}
+
+			mBuffer = make_unique<byte[]>(mCapacity);
+		}
+
+		mOffset.store(0, memory_order_relaxed);
+	}
+
+	size_t FrameAllocator::Capacity() const
+	{
+		return mCapacity;
+	}
+
+	size_t FrameAllocator::UsedBytes() const
+	{
+		return mOffset.load(memory_order_relaxed) + mOverflowBytes.load(memory_order_relaxed);
+	}
+
+	size_t FrameAllocator::PeakBytes() const
+	{
+		return mPeakBytes;
+	}
+
+	size_t FrameAllocator::OverflowFrameCount() const
+	{
+		return mOverflowFrameCount;
+	}
+
+	void* FrameAllocator::do_allocate(size_t bytes, size_t alignment)
+	{
+		const uintptr_t base = reinterpret_cast<uintptr_t>(mBuffer.get());
+		size_t offset = mOffset.load(memory_order_relaxed);
+		for (;;)
+		{
+			const size_t alignedOffset = static_cast<size_t>(((base + offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1)) - base);
+			if (alignedOffset + bytes > mCapacity)
+			{
+				return AllocateOverflow(bytes, alignment);
+			}
+
+			if (mOffset.compare_exchange_weak(offset, alignedOffset + bytes, memory_order_relaxed))
+			{
+				return mBuffer.get() + alignedOffset;
+			}
+		}
+	}
+
+	void FrameAllocator::do_deallocate(void*, size_t, size_t)
+	{
+		// Everything is released together by Reset
+	}
+
+	bool FrameAllocator::do_is_equal(const pmr::memory_resource& other) const noexcept
+	{
+		return this == &other;
+	}
+
+	void* FrameAllocator::AllocateOverflow(size_t bytes, size_t alignment)
+	{
+		lock_guard<mutex> lock(mOverflowMutex);
+		const size_t blockSize = bytes + alignment;
+		mOverflowBlocks.push_back(make_unique<byte[]>(blockSize));
+		mOverflowBytes += blockSize;
+
+		void* pointer = mOverflowBlocks.back().get();
+		size_t space = blockSize;
+		return align(alignment, bytes, pointer, space);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+namespace Library
+{
+	/// <summary>
+	/// A linear allocator for data that lives no longer than the frame it was made in. Allocation bumps an offset into one block,
+	/// from any thread without locking, and deallocation does nothing; Game resets it at the end of every frame, which releases everything at once.
+	/// As a std::pmr::memory_resource it backs std::pmr containers and strings directly.
+	/// A frame that outgrows the block falls back to the heap, and the block is regrown at the next reset to fit,
+	/// so a steady state does no general-purpose heap work.
+	/// </summary>
+	class FrameAllocator final : public std::pmr::memory_resource
+	{
+	public:
+		inline static const std::size_t DefaultCapacity{ 256 * 1024 };
+
+		explicit FrameAllocator(std::size_t capacity = DefaultCapacity);
+		FrameAllocator(const FrameAllocator&) = delete;
+		FrameAllocator& operator=(const FrameAllocator&) = delete;
+		FrameAllocator(FrameAllocator&&) = delete;
+		FrameAllocator& operator=(FrameAllocator&&) = delete;
+		~FrameAllocator() = default;
+
+		/// <summary>
+		/// Releases everything allocated since the last reset. Nothing may still be using it.
+		/// </summary>
+		void Reset();
+
+		std::size_t Capacity() const;
+		std::size_t UsedBytes() const; // This frame, so far, including any that fell back to the heap
+		std::size_t PeakBytes() const; // Over every completed frame
+		std::size_t OverflowFrameCount() const; // Frames that fell back to the heap
+
+		/// <summary>
+		/// printf-style formatting into this frame's memory, for labels and other text that is drawn and forgotten.
+		/// </summary>
+		template <typename... Arguments>
+		const char* Format(const char* format, Arguments... arguments);
+
+		template <typename... Arguments>
+		const wchar_t* Format(const wchar_t* format, Arguments... arguments);
+
+	private:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+		void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+		void* AllocateOverflow(std::size_t bytes, std::size_t alignment);
+
+		std::unique_ptr<std::byte[]> mBuffer;
+		std::size_t mCapacity;
+		std::atomic<std::size_t> mOffset{ 0 };
+
+		std::mutex mOverflowMutex;
+		std::vector<std::unique_ptr<std::byte[]>> mOverflowBlocks;
+		std::atomic<std::size_t> mOverflowBytes{ 0 };
+
+		std::size_t mPeakBytes{ 0 };
+		std::size_t mOverflowFrameCount{ 0 };
+	};
+}
+
+#include "FrameAllocator.inl"
\ No newline at end of file
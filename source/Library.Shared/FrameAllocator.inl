@@ -0,0 +1,40 @@
+#pragma once
+#include "FrameAllocator.h"
+#include <cstdio>
+#include <cwchar>
+
+namespace Library
+{
+	template <typename... Arguments>
+	inline const char* FrameAllocator::Format(const char* format, Arguments... arguments)
+	{
+		const int length = std::snprintf(nullptr, 0, format, arguments...);
+		if (length < 0)
+		{
+			return "";
+		}
+
+		const std::size_t size = static_cast<std::size_t>(length) + 1;
+		char* text = static_cast<char*>(allocate(size, alignof(char)));
+		std::snprintf(text, size, format, arguments...);
+
+		return text;
+	}
+
+	template <typename... Arguments>
+	inline const wchar_t* FrameAllocator::Format(const wchar_t* format, Arguments... arguments)
+	{
+		// swprintf can't measure, so the length comes from the counting variant
+		const int length = _scwprintf(format, arguments...);
+		if (length < 0)
+		{
+			return L"";
+		}
+
+		const std::size_t size = static_cast<std::size_t>(length) + 1;
+		wchar_t* text = static_cast<wchar_t*>(allocate(size * sizeof(wchar_t), alignof(wchar_t)));
+		std::swprintf(text, size, format, arguments...);
+
+		return text;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,192 @@
+#include "pch.h"
+#include "FrameStatistics.h"
+#include "GameException.h"
+#include <cmath>
+
+using namespace std;
+
+namespace Library
+{
+	void FrameStatistics::AddFrame(float frameMilliseconds, float updateMilliseconds, float drawMilliseconds)
+	{
+		FrameSample& sample = mSamples[mNextSample];
+		if (mSampleCount == WindowFrameCount)
+		{
+			// The oldest frame leaves the window through the slot the new one takes
+			mFrameTimes.Remove(sample.FrameMilliseconds);
+			mUpdateTimes.Remove(sample.UpdateMilliseconds);
+			mDrawTimes.Remove(sample.DrawMilliseconds);
+			--mHistogram[BucketOf(sample.FrameMilliseconds)];
+		}
+		else
+		{
+			++mSampleCount;
+		}
+
+		sample = { frameMilliseconds, updateMilliseconds, drawMilliseconds };
+		mFrameTimes.Insert(frameMilliseconds);
+		mUpdateTimes.Insert(updateMilliseconds);
+		mDrawTimes.Insert(drawMilliseconds);
+		++mHistogram[BucketOf(frameMilliseconds)];
+
+		mNextSample = (mNextSample + 1) % WindowFrameCount;
+		++mTotalFrameCount;
+		if (frameMilliseconds > mFrameBudgetMilliseconds)
+		{
+			++mTotalFramesOverBudget;
+		}
+	}
+
+	void FrameStatistics::Reset()
+	{
+		mNextSample = 0;
+		mSampleCount = 0;
+		mTotalFrameCount = 0;
+		mTotalFramesOverBudget = 0;
+		mFrameTimes.Clear();
+		mUpdateTimes.Clear();
+		mDrawTimes.Clear();
+		mHistogram.fill(0);
+	}
+
+	size_t FrameStatistics::FrameCount() const
+	{
+		return mSampleCount;
+	}
+
+	uint64_t FrameStatistics::TotalFrameCount() const
+	{
+		return mTotalFrameCount;
+	}
+
+	const FrameSample& FrameStatistics::Sample(size_t age) const
+	{
+		assert(age < mSampleCount);
+		return mSamples[(mNextSample + WindowFrameCount - 1 - age) % WindowFrameCount];
+	}
+
+	FrameTimeSummary FrameStatistics::FrameTimes() const
+	{
+		return mFrameTimes.Summary();
+	}
+
+	FrameTimeSummary FrameStatistics::UpdateTimes() const
+	{
+		return mUpdateTimes.Summary();
+	}
+
+	FrameTimeSummary FrameStatistics::DrawTimes() const
+	{
+		return mDrawTimes.Summary();
+	}
+
+	const FrameStatistics::Histogram& FrameStatistics::FrameTimeHistogram() const
+	{
+		return mHistogram;
+	}
+
+	float FrameStatistics::BucketLowerBound(size_t bucket)
+	{
+		return (bucket == 0 ? 0.0f : HistogramMinimumMilliseconds * exp2(static_cast<float>(bucket - 1) / HistogramBucketsPerDoubling));
+	}
+
+	size_t FrameStatistics::BucketOf(float milliseconds)
+	{
+		if (!(milliseconds >= HistogramMinimumMilliseconds))
+		{
+			return 0;
+		}
+
+		const float bucket = floor(log2(milliseconds / HistogramMinimumMilliseconds) * HistogramBucketsPerDoubling) + 1.0f;
+		return min(static_cast<size_t>(bucket), HistogramBucketCount - 1);
+	}
+
+	float FrameStatistics::FrameBudgetMilliseconds() const
+	{
+		return mFrameBudgetMilliseconds;
+	}
+
+	void FrameStatistics::SetFrameBudgetMilliseconds(float frameBudgetMilliseconds)
+	{
+		mFrameBudgetMilliseconds = frameBudgetMilliseconds;
+	}
+
+	size_t FrameStatistics::FramesOverBudget() const
+	{
+		return mFrameTimes.CountAbove(mFrameBudgetMilliseconds);
+	}
+
+	uint64_t FrameStatistics::TotalFramesOverBudget() const
+	{
+		return mTotalFramesOverBudget;
+	}
+
+	void FrameStatistics::WriteCsv(ostream& stream) const
+	{
+		stream << "Frame,FrameMilliseconds,UpdateMilliseconds,DrawMilliseconds\n";
+		stream << fixed << setprecision(3);
+		for (size_t age = mSampleCount; age > 0; --age)
+		{
+			const FrameSample& sample = Sample(age - 1);
+			stream << (mTotalFrameCount - age) << ',' << sample.FrameMilliseconds << ',' << sample.UpdateMilliseconds << ',' << sample.DrawMilliseconds << '\n';
+		}
+	}
+
+	void FrameStatistics::WriteCsv(const wstring& filename) const
+	{
+		ofstream file(filename, ios::trunc);
+		if (!file.good())
+		{
+			throw GameException("Could not open the frame statistics file for writing.");
+		}
+
+		WriteCsv(file);
+	}
+
+	void FrameStatistics::SortedWindow::Insert(float value)
+	{
+		assert(mCount < mValues.size());
+		const auto end = mValues.begin() + mCount;
+		const auto position = upper_bound(mValues.begin(), end, value);
+		move_backward(position, end, end + 1);
+		*position = value;
+		++mCount;
+	}
+
+	void FrameStatistics::SortedWindow::Remove(float value)
+	{
+		const auto end = mValues.begin() + mCount;
+		const auto position = lower_bound(mValues.begin(), end, value);
+		assert(position != end && *position == value);
+		move(position + 1, end, position);
+		--mCount;
+	}
+
+	void FrameStatistics::SortedWindow::Clear()
+	{
+		mCount = 0;
+	}
+
+	FrameTimeSummary FrameStatistics::SortedWindow::Summary() const
+	{
+		if (mCount == 0)
+		{
+			return FrameTimeSummary();
+		}
+
+		return { Percentile(0.50f), Percentile(0.95f), Percentile(0.99f), mValues[mCount - 1] };
+	}
+
+	size_t FrameStatistics::SortedWindow::CountAbove(float value) const
+	{
+		const auto end = mValues.begin() + mCount;
+		return static_cast<size_t>(end - upper_bound(mValues.begin(), end, value));
+	}
+
+	float FrameStatistics::SortedWindow::Percentile(float fraction) const
+	{
+		// Nearest rank: the smallest value that at least this fraction of the window is no greater than
+		const size_t rank = static_cast<size_t>(ceil(fraction * static_cast<float>(mCount)));
+		return mValues[max(rank, static_cast<size_t>(1)) - 1];
+	}
+}
\ No newline at end of file
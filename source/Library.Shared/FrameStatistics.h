@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace Library
+{
+	struct FrameSample final
+	{
+		float FrameMilliseconds{ 0.0f }; // From the start of the previous frame to the start of this one, as the player sees it
+		float UpdateMilliseconds{ 0.0f };
+		float DrawMilliseconds{ 0.0f }; // Including Present
+	};
+
+	struct FrameTimeSummary final
+	{
+		float P50{ 0.0f };
+		float P95{ 0.0f };
+		float P99{ 0.0f };
+		float Max{ 0.0f };
+	};
+
+	/// <summary>
+	/// Frame times over a rolling window of the most recent frames, kept up to date as each frame is added without allocating:
+	/// exact percentiles for the whole frame and its update and draw parts, a log-scale histogram of frame times,
+	/// and how many frames went over a budget, which is what a frame-time target is tracked against.
+	/// </summary>
+	class FrameStatistics final
+	{
+	public:
+		inline static const std::size_t WindowFrameCount{ 1024 };
+		inline static const std::size_t HistogramBucketCount{ 40 };
+		inline static const float HistogramMinimumMilliseconds{ 0.25f }; // Bucket 0 holds everything below this
+		inline static const float HistogramBucketsPerDoubling{ 4.0f }; // Each bucket is about 19% wider than the one before
+		inline static const float DefaultFrameBudgetMilliseconds{ 1000.0f / 60.0f };
+
+		using Histogram = std::array<std::uint32_t, HistogramBucketCount>;
+
+		void AddFrame(float frameMilliseconds, float updateMilliseconds, float drawMilliseconds);
+		void Reset();
+
+		std::size_t FrameCount() const; // In the window
+		std::uint64_t TotalFrameCount() const;
+
+		/// <summary>
+		/// A frame in the window, where 0 is the most recent.
+		/// </summary>
+		const FrameSample& Sample(std::size_t age) const;
+
+		FrameTimeSummary FrameTimes() const;
+		FrameTimeSummary UpdateTimes() const;
+		FrameTimeSummary DrawTimes() const;
+
+		const Histogram& FrameTimeHistogram() const;
+		static float BucketLowerBound(std::size_t bucket); // Milliseconds
+		static std::size_t BucketOf(float milliseconds);
+
+		float FrameBudgetMilliseconds() const;
+		void SetFrameBudgetMilliseconds(float frameBudgetMilliseconds);
+		std::size_t FramesOverBudget() const; // In the window
+		std::uint64_t TotalFramesOverBudget() const; // Since the last reset, counted against the budget each frame had when it was added
+
+		/// <summary>
+		/// Writes the window, oldest frame first, as comma-separated values with a header row.
+		/// </summary>
+		void WriteCsv(std::ostream& stream) const;
+		void WriteCsv(const std::wstring& filename) const;
+
+	private:
+		// The window's values in ascending order, updated by insertion and removal as frames come and go
+		class SortedWindow final
+		{
+		public:
+			void Insert(float value);
+			void Remove(float value);
+			void Clear();
+
+			FrameTimeSummary Summary() const;
+			std::size_t CountAbove(float value) const;
+
+		private:
+			float Percentile(float fraction) const;
+
+			std::array<float, WindowFrameCount> mValues{};
+			std::size_t mCount{ 0 };
+		};
+
+		std::array<FrameSample, WindowFrameCount> mSamples;
+		std::size_t mNextSample{ 0 };
+		std::size_t mSampleCount{ 0 };
+		std::uint64_t mTotalFrameCount{ 0 };
+		std::uint64_t mTotalFramesOverBudget{ 0 };
+		float mFrameBudgetMilliseconds{ DefaultFrameBudgetMilliseconds };
+
+		SortedWindow mFrameTimes;
+		SortedWindow mUpdateTimes;
+		SortedWindow mDrawTimes;
+		Histogram mHistogram{};
+	};
+}
\ No newline at end of file
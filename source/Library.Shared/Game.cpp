@@ -4,6 +4,7 @@
 #include "DrawableGameComponent.h"
 #include "DirectXHelper.h"
 #include "ContentTypeReaderManager.h"
+#include "Profiler.h"
 
 using namespace std;
 using namespace gsl;
@@ -28,20 +29,47 @@ namespace Library
 
 	void Game::Initialize()
 	{
+		PROFILE_THREAD_NAME("Main");
+
 		ContentTypeReaderManager::Initialize(*this);
 		mGameClock.Reset();
+		RebuildComponentLists();
 
 		for (auto& component : mComponents)
 		{
 			component->Initialize();
 		}
+
+		// Components have looked up what they need, and from here on worker threads may read services too
+		mServices.Seal();
 	}
 
 	void Game::Run()
 	{
+		PROFILE_ZONE("Frame");
+		const auto frameStartTime = chrono::high_resolution_clock::now();
 		mGameClock.UpdateGameTime(mGameTime);
 		Update(mGameTime);
+		const auto updateEndTime = chrono::high_resolution_clock::now();
 		Draw(mGameTime);
+		const auto drawEndTime = chrono::high_resolution_clock::now();
+
+		// The first frame has no previous one to measure from
+		if (mFirstFrameDrawn)
+		{
+			using Milliseconds = chrono::duration<float, milli>;
+			mFrameStatistics.AddFrame(Milliseconds(frameStartTime - mLastFrameStartTime).count(), Milliseconds(updateEndTime - frameStartTime).count(), Milliseconds(drawEndTime - updateEndTime).count());
+		}
+
+		mLastFrameStartTime = frameStartTime;
+		mFrameAllocator.Reset();
+
+		if (!mFirstFrameDrawn)
+		{
+			// Everything read so far is what the next start will read ahead.
+			mContentManager.EndPrefetch();
+			mFirstFrameDrawn = true;
+		}
 	}
 
 	void Game::Shutdown()
@@ -57,6 +85,10 @@ namespace Library
 		
 		mComponents.clear();
 		mComponents.shrink_to_fit();
+		RebuildComponentLists();
+		mMeshBufferCache.Clear();
+		mShaderCache.Clear();
+		mServices.Clear();
 
 		mDepthStencilView = nullptr;
 		mRenderTargetView = nullptr;
@@ -64,7 +96,9 @@ namespace Library
 		mDirect3DDeviceContext = nullptr;
 		mDirect3DDevice = nullptr;
 
+		mContentManager.EndPrefetch();
 		mContentManager.Clear();
+		mContentManager.UnmountArchives();
 		ContentTypeReaderManager::Shutdown();
 
 #if defined(DEBUG) || defined(_DEBUG)
@@ -74,25 +108,134 @@ namespace Library
 
 	void Game::Update(const GameTime& gameTime)
 	{
-		for (auto& component : mComponents)
+		PROFILE_FUNCTION();
+		// Components that declare no shared data update concurrently; the rest keep the list's order.
+		mComponentScheduler.Update(mComponents, gameTime);
+	}
+
+	void Game::Draw(const GameTime& gameTime)
+	{
+		PROFILE_FUNCTION();
+
+		// A component's Draw may show or hide others; the list is refreshed once every component has drawn, so none is skipped or drawn twice
+		mIsDrawing = true;
+		for (DrawableGameComponent* component : mVisibleComponents)
 		{
-			if (component->Enabled())
+			if (component == nullptr)
 			{
-				component->Update(gameTime);
+				continue;
 			}
+
+			PROFILE_ZONE(component->TypeInfoInstance().Name);
+			component->Draw(gameTime);
+		}
+
+		mIsDrawing = false;
+		if (mVisibleComponentsStale)
+		{
+			RefreshVisibleComponents();
 		}
 	}
 
-	void Game::Draw(const GameTime& gameTime)
+	void Game::AddComponent(shared_ptr<GameComponent> component)
 	{
-		for (auto& component : mComponents)
+		assert(component != nullptr);
+
+		DrawableGameComponent* drawableComponent = component->As<DrawableGameComponent>();
+		mComponents.push_back(move(component));
+		mComponentScheduler.Invalidate();
+
+		if (drawableComponent != nullptr)
 		{
-			DrawableGameComponent* drawableGameComponent = component->As<DrawableGameComponent>();
-			if (drawableGameComponent != nullptr && drawableGameComponent->Visible())
+			auto drawsAfter = [](int drawOrder, const DrawableGameComponent* other) { return drawOrder < other->DrawOrder(); };
+			mDrawableComponents.insert(upper_bound(mDrawableComponents.begin(), mDrawableComponents.end(), drawableComponent->DrawOrder(), drawsAfter), drawableComponent);
+			RefreshVisibleComponents();
+		}
+	}
+
+	void Game::RemoveComponent(const shared_ptr<GameComponent>& component)
+	{
+		auto position = find(mComponents.begin(), mComponents.end(), component);
+		if (position == mComponents.end())
+		{
+			return;
+		}
+
+		// Erased after the lists, which hold raw pointers into it. Mid-draw, the frame's list keeps its shape with the component blanked out.
+		DrawableGameComponent* drawableComponent = component->As<DrawableGameComponent>();
+		mDrawableComponents.erase(remove(mDrawableComponents.begin(), mDrawableComponents.end(), drawableComponent), mDrawableComponents.end());
+		if (mIsDrawing && drawableComponent != nullptr)
+		{
+			replace(mVisibleComponents.begin(), mVisibleComponents.end(), drawableComponent, static_cast<DrawableGameComponent*>(nullptr));
+		}
+
+		RefreshVisibleComponents();
+		mComponentScheduler.Invalidate();
+		mComponents.erase(position);
+	}
+
+	void Game::ComponentEnabledChanged(const GameComponent&)
+	{
+		mComponentScheduler.Invalidate();
+	}
+
+	void Game::DrawableComponentChanged(DrawableGameComponent& component)
+	{
+		auto position = find(mDrawableComponents.begin(), mDrawableComponents.end(), &component);
+		if (position == mDrawableComponents.end())
+		{
+			return;
+		}
+
+		// A new draw order moves the component after any others that share it; otherwise it keeps its place.
+		const bool inOrder = (position == mDrawableComponents.begin() || (*prev(position))->DrawOrder() <= component.DrawOrder()) &&
+			(next(position) == mDrawableComponents.end() || component.DrawOrder() <= (*next(position))->DrawOrder());
+		if (!inOrder)
+		{
+			mDrawableComponents.erase(position);
+			auto drawsAfter = [](int drawOrder, const DrawableGameComponent* other) { return drawOrder < other->DrawOrder(); };
+			mDrawableComponents.insert(upper_bound(mDrawableComponents.begin(), mDrawableComponents.end(), component.DrawOrder(), drawsAfter), &component);
+		}
+
+		RefreshVisibleComponents();
+	}
+
+	void Game::RebuildComponentLists()
+	{
+		// Picks up components pushed straight onto mComponents before Initialize, too
+		mDrawableComponents.clear();
+		for (const auto& component : mComponents)
+		{
+			DrawableGameComponent* drawableComponent = component->As<DrawableGameComponent>();
+			if (drawableComponent != nullptr)
 			{
-				drawableGameComponent->Draw(gameTime);
+				mDrawableComponents.push_back(drawableComponent);
 			}
 		}
+
+		stable_sort(mDrawableComponents.begin(), mDrawableComponents.end(), [](const DrawableGameComponent* lhs, const DrawableGameComponent* rhs)
+		{
+			return lhs->DrawOrder() < rhs->DrawOrder();
+		});
+
+		RefreshVisibleComponents();
+		mComponentScheduler.Invalidate();
+	}
+
+	void Game::RefreshVisibleComponents()
+	{
+		if (mIsDrawing)
+		{
+			mVisibleComponentsStale = true;
+			return;
+		}
+
+		mVisibleComponentsStale = false;
+		mVisibleComponents.clear();
+		copy_if(mDrawableComponents.begin(), mDrawableComponents.end(), back_inserter(mVisibleComponents), [](const DrawableGameComponent* component)
+		{
+			return component->Visible();
+		});
 	}
 
 	void Game::UpdateRenderTargetSize()
@@ -22,10 +22,17 @@
 #include "ServiceContainer.h"
 #include "RenderTarget.h"
 #include "ContentManager.h"
+#include "MeshBufferCache.h"
+#include "ShaderObjectCache.h"
+#include "JobSystem.h"
+#include "ComponentScheduler.h"
+#include "FrameStatistics.h"
+#include "FrameAllocator.h"
 
 namespace Library
 {
 	class GameComponent;
+	class DrawableGameComponent;
 
 	class IDeviceNotify
 	{
@@ -65,7 +72,17 @@ namespace Library
 		std::uint32_t MultiSamplingQualityLevels() const;
 
 		const std::vector<std::shared_ptr<GameComponent>>& Components() const;
-		const ServiceContainer& Services() const;			
+		const ServiceContainer& Services() const;
+
+		/// <summary>
+		/// The frame loop iterates lists kept current by these rather than casting every component each frame.
+		/// Components enable, show, hide and reorder themselves through GameComponent and DrawableGameComponent, which notify the game.
+		/// None of this is synchronized: make such changes on the game's thread, outside of component updates.
+		/// </summary>
+		void AddComponent(std::shared_ptr<GameComponent> component);
+		void RemoveComponent(const std::shared_ptr<GameComponent>& component);
+		void ComponentEnabledChanged(const GameComponent& component);
+		void DrawableComponentChanged(DrawableGameComponent& component);			
 
         virtual void Initialize();
 		virtual void Run();
@@ -80,6 +97,12 @@ namespace Library
 		std::function<void*()> GetWindowCallback() const;
 
 		ContentManager& Content();
+		MeshBufferCache& BufferCache();
+		ShaderObjectCache& ShaderCache();
+		JobSystem& Jobs();
+		ComponentScheduler& Scheduler();
+		FrameStatistics& FrameTimeStatistics();
+		FrameAllocator& FrameMemory(); // Transient memory, released at the end of every frame
 
     protected:		
 		virtual void HandleDeviceLost();
@@ -91,6 +114,9 @@ namespace Library
 		virtual void CreateDeviceResources();
 		virtual void CreateWindowSizeDependentResources();
 
+		void RebuildComponentLists();
+		void RefreshVisibleComponents();
+
 		inline static const D3D_FEATURE_LEVEL DefaultFeatureLevel{ D3D_FEATURE_LEVEL_9_1 };
 		inline static const std::uint32_t DefaultFrameRate{ 60 };
 		inline static const std::uint32_t DefaultMultiSamplingCount{ 4 };
@@ -108,6 +134,7 @@ namespace Library
 
 		std::uint32_t mFrameRate{ DefaultFrameRate };
 		bool mIsFullScreen{ false };
+		bool mFirstFrameDrawn{ false };
 		std::uint32_t mMultiSamplingCount{ DefaultMultiSamplingCount };
 		std::uint32_t mMultiSamplingQualityLevels{ 0 };
 
@@ -118,9 +145,20 @@ namespace Library
 
         GameClock mGameClock;
         GameTime mGameTime;
+		std::chrono::high_resolution_clock::time_point mLastFrameStartTime;
+		FrameStatistics mFrameStatistics;
+		FrameAllocator mFrameAllocator;
 		std::vector<std::shared_ptr<GameComponent>> mComponents;
+		std::vector<DrawableGameComponent*> mDrawableComponents; // Every drawable component, by draw order and then the order they were added
+		std::vector<DrawableGameComponent*> mVisibleComponents; // The visible subset, which is what Draw iterates
+		bool mIsDrawing{ false };
+		bool mVisibleComponentsStale{ false }; // Changed while drawing, and refreshed when the frame's draws are done
 		ServiceContainer mServices;
 		ContentManager mContentManager;
+		MeshBufferCache mMeshBufferCache;
+		ShaderObjectCache mShaderCache;
+		JobSystem mJobSystem; // Next to last, so its workers stop before anything a job could touch is destroyed
+		ComponentScheduler mComponentScheduler{ mJobSystem };
     };
 }
 
@@ -84,4 +84,34 @@ namespace Library
 	{
 		return mContentManager;
 	}
+
+	inline MeshBufferCache& Game::BufferCache()
+	{
+		return mMeshBufferCache;
+	}
+
+	inline ShaderObjectCache& Game::ShaderCache()
+	{
+		return mShaderCache;
+	}
+
+	inline JobSystem& Game::Jobs()
+	{
+		return mJobSystem;
+	}
+
+	inline ComponentScheduler& Game::Scheduler()
+	{
+		return mComponentScheduler;
+	}
+
+	inline FrameStatistics& Game::FrameTimeStatistics()
+	{
+		return mFrameStatistics;
+	}
+
+	inline FrameAllocator& Game::FrameMemory()
+	{
+		return mFrameAllocator;
+	}
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "pch.h"
 #include "GameComponent.h"
+#include "Game.h"
+#include "ComponentScheduler.h"
 
 namespace Library
 {
@@ -27,7 +29,11 @@ namespace Library
 
 	void GameComponent::SetEnabled(bool enabled)
 	{
-		mEnabled = enabled;
+		if (mEnabled != enabled)
+		{
+			mEnabled = enabled;
+			mGame->ComponentEnabledChanged(*this);
+		}
 	}
 
 	void GameComponent::Initialize()
@@ -41,4 +47,14 @@ namespace Library
 	void GameComponent::Update(const GameTime&)
 	{		
 	}
+
+	void GameComponent::DeclareAccess(ComponentAccess& access) const
+	{
+		access.SetExclusive();
+	}
+
+	void GameComponent::ValidateRead() const
+	{
+		ComponentScheduler::ValidateRead(*this);
+	}
 }
\ No newline at end of file
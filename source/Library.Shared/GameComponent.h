@@ -7,6 +7,7 @@ namespace Library
 {
 	class Game;
 	class GameTime;
+	class ComponentAccess;
 
 	class GameComponent : public RTTI
 	{
@@ -30,7 +31,15 @@ namespace Library
 		virtual void Shutdown();
 		virtual void Update(const GameTime& gameTime);
 
+		/// <summary>
+		/// Declares what Update touches beyond this component, so components that share nothing can update concurrently.
+		/// The default declares this component exclusive; override it once Update is known to be safe alongside others.
+		/// </summary>
+		virtual void DeclareAccess(ComponentAccess& access) const;
+
 	protected:
+		void ValidateRead() const; // For accessors other components call during their Update
+
 		gsl::not_null<Game*> mGame;
 		bool mEnabled{ true };
 	};
@@ -27,11 +27,13 @@ namespace Library
 
 	const GamePad::State& GamePadComponent::CurrentState() const
 	{
+		ValidateRead();
 		return mCurrentState;
 	}
 
 	const GamePad::State& GamePadComponent::LastState() const
 	{
+		ValidateRead();
 		return mLastState;
 	}
 
@@ -47,6 +49,11 @@ namespace Library
 		mCurrentState = sGamePad->GetState(mPlayer);
 	}
 
+	void GamePadComponent::DeclareAccess(ComponentAccess&) const
+	{
+		// Reads only the gamepad device
+	}
+
 	bool GamePadComponent::IsButtonUp(GamePadButtons button) const
 	{
 		return GetButtonState(mCurrentState, button) == false;
@@ -84,6 +91,7 @@ namespace Library
 
 	bool GamePadComponent::GetButtonState(const GamePad::State& state, GamePadButtons button) const
 	{
+		ValidateRead();
 		switch (button)
 		{
 			case GamePadButtons::A:
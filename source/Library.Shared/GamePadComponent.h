@@ -39,6 +39,7 @@ namespace Library
 
 		virtual void Initialize() override;
 		virtual void Update(const GameTime& gameTime) override;
+		virtual void DeclareAccess(ComponentAccess& access) const override;
 
 		bool IsButtonUp(GamePadButtons button) const;
 		bool IsButtonDown(GamePadButtons button) const;
@@ -0,0 +1,159 @@
+#include "pch.h"
+#include "GeometryBufferPool.h"
+#include "GameException.h"
+
+using namespace std;
+using namespace gsl;
+using namespace winrt;
+
+namespace Library
+{
+	float GeometryBufferPoolStatistics::Fragmentation() const
+	{
+		const uint64_t freeBytes = ReservedBytes - UsedBytes;
+		return (freeBytes > 0 ? 1.0f - static_cast<float>(static_cast<double>(LargestFreeBlockBytes) / freeBytes) : 0.0f);
+	}
+
+	GeometryBufferPool::GeometryBufferPool(uint32_t pageSize) :
+		mPageSize(pageSize)
+	{
+	}
+
+	GeometryIndexAllocation GeometryBufferPool::AllocateIndices(not_null<ID3D11Device*> device, span<const uint16_t> indices)
+	{
+		return AllocateIndices(device, DXGI_FORMAT_R16_UINT, narrow_cast<uint32_t>(sizeof(uint16_t)), indices.data(), narrow<uint32_t>(indices.size()));
+	}
+
+	GeometryIndexAllocation GeometryBufferPool::AllocateIndices(not_null<ID3D11Device*> device, span<const uint32_t> indices)
+	{
+		return AllocateIndices(device, DXGI_FORMAT_R32_UINT, narrow_cast<uint32_t>(sizeof(uint32_t)), indices.data(), narrow<uint32_t>(indices.size()));
+	}
+
+	GeometryIndexAllocation GeometryBufferPool::AllocateIndices(not_null<ID3D11Device*> device, DXGI_FORMAT indexFormat, uint32_t indexSize, const void* indices, uint32_t indexCount)
+	{
+		auto& pages = mIndexPages[indexFormat];
+		const auto [pageIndex, allocation] = Allocate(device, pages, indexSize, indexCount, D3D11_BIND_INDEX_BUFFER, indices);
+
+		GeometryIndexAllocation indexAllocation;
+		indexAllocation.Buffer = pages[pageIndex].Buffer.get();
+		indexAllocation.StartIndexLocation = allocation.Offset;
+		indexAllocation.IndexCount = allocation.Size;
+		indexAllocation.IndexFormat = indexFormat;
+		indexAllocation.PageIndex = pageIndex;
+
+		return indexAllocation;
+	}
+
+	GeometryVertexAllocation GeometryBufferPool::AllocateVertices(not_null<ID3D11Device*> device, const D3D11_INPUT_ELEMENT_DESC* vertexFormat, uint32_t vertexSize, const void* vertices, uint32_t vertexCount)
+	{
+		auto& pages = mVertexPages[vertexFormat];
+		const auto [pageIndex, allocation] = Allocate(device, pages, vertexSize, vertexCount, D3D11_BIND_VERTEX_BUFFER, vertices);
+
+		GeometryVertexAllocation vertexAllocation;
+		vertexAllocation.Buffer = pages[pageIndex].Buffer.get();
+		vertexAllocation.BaseVertexLocation = allocation.Offset;
+		vertexAllocation.VertexCount = allocation.Size;
+		vertexAllocation.VertexSize = vertexSize;
+		vertexAllocation.VertexFormat = vertexFormat;
+		vertexAllocation.PageIndex = pageIndex;
+
+		return vertexAllocation;
+	}
+
+	void GeometryBufferPool::Free(const GeometryVertexAllocation& allocation)
+	{
+		auto it = mVertexPages.find(allocation.VertexFormat);
+		assert(it != mVertexPages.end());
+		it->second.at(allocation.PageIndex).Allocator.Free(BufferAllocation{ allocation.BaseVertexLocation, allocation.VertexCount });
+	}
+
+	void GeometryBufferPool::Free(const GeometryIndexAllocation& allocation)
+	{
+		auto it = mIndexPages.find(allocation.IndexFormat);
+		assert(it != mIndexPages.end());
+		it->second.at(allocation.PageIndex).Allocator.Free(BufferAllocation{ allocation.StartIndexLocation, allocation.IndexCount });
+	}
+
+	void GeometryBufferPool::Clear()
+	{
+		mVertexPages.clear();
+		mIndexPages.clear();
+	}
+
+	GeometryBufferPoolStatistics GeometryBufferPool::Statistics() const
+	{
+		GeometryBufferPoolStatistics statistics;
+
+		auto accumulate = [&statistics](const vector<Page>& pages)
+		{
+			for (const auto& page : pages)
+			{
+				const BufferSuballocatorStatistics pageStatistics = page.Allocator.Statistics();
+				statistics.AllocationCount += pageStatistics.AllocationCount;
+				statistics.ReservedBytes += uint64_t(pageStatistics.Capacity) * page.ElementSize;
+				statistics.UsedBytes += uint64_t(pageStatistics.UsedSize) * page.ElementSize;
+				statistics.LargestFreeBlockBytes = max(statistics.LargestFreeBlockBytes, uint64_t(pageStatistics.LargestFreeBlock) * page.ElementSize);
+			}
+		};
+
+		for (const auto& entry : mVertexPages)
+		{
+			statistics.VertexPageCount += narrow_cast<uint32_t>(entry.second.size());
+			accumulate(entry.second);
+		}
+
+		for (const auto& entry : mIndexPages)
+		{
+			statistics.IndexPageCount += narrow_cast<uint32_t>(entry.second.size());
+			accumulate(entry.second);
+		}
+
+		return statistics;
+	}
+
+	pair<uint32_t, BufferAllocation> GeometryBufferPool::Allocate(not_null<ID3D11Device*> device, vector<Page>& pages, uint32_t elementSize, uint32_t elementCount, uint32_t bindFlags, const void* data)
+	{
+		if (elementCount == 0)
+		{
+			throw GameException("Cannot allocate an empty geometry range.");
+		}
+
+		uint32_t pageIndex = 0;
+		optional<BufferAllocation> allocation;
+		for (; pageIndex < pages.size(); ++pageIndex)
+		{
+			allocation = pages[pageIndex].Allocator.Allocate(elementCount);
+			if (allocation.has_value())
+			{
+				break;
+			}
+		}
+
+		if (!allocation.has_value())
+		{
+			// Ranges larger than a page get a dedicated page of their own.
+			const uint32_t pageElementCount = max(mPageSize / elementSize, elementCount);
+
+			D3D11_BUFFER_DESC bufferDesc{ 0 };
+			bufferDesc.ByteWidth = narrow<uint32_t>(uint64_t(pageElementCount) * elementSize);
+			bufferDesc.Usage = D3D11_USAGE_DEFAULT;
+			bufferDesc.BindFlags = bindFlags;
+
+			com_ptr<ID3D11Buffer> buffer;
+			ThrowIfFailed(device->CreateBuffer(&bufferDesc, nullptr, buffer.put()), "ID3D11Device::CreateBuffer() failed.");
+
+			pages.push_back(Page{ move(buffer), BufferSuballocator(pageElementCount), elementSize });
+			pageIndex = narrow_cast<uint32_t>(pages.size() - 1);
+			allocation = pages.back().Allocator.Allocate(elementCount);
+			assert(allocation.has_value());
+		}
+
+		com_ptr<ID3D11DeviceContext> direct3DDeviceContext;
+		device->GetImmediateContext(direct3DDeviceContext.put());
+
+		const D3D11_BOX destinationBox{ allocation->Offset * elementSize, 0, 0, (allocation->Offset + elementCount) * elementSize, 1, 1 };
+		direct3DDeviceContext->UpdateSubresource(pages[pageIndex].Buffer.get(), 0, &destinationBox, data, 0, 0);
+
+		return { pageIndex, *allocation };
+	}
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+#include <d3d11.h>
+#include <gsl\gsl>
+#include "BufferSuballocator.h"
+
+namespace Library
+{
+	struct GeometryVertexAllocation final
+	{
+		ID3D11Buffer* Buffer{ nullptr };
+		std::uint32_t BaseVertexLocation{ 0 };
+		std::uint32_t VertexCount{ 0 };
+		std::uint32_t VertexSize{ 0 };
+		const D3D11_INPUT_ELEMENT_DESC* VertexFormat{ nullptr };
+		std::uint32_t PageIndex{ 0 };
+	};
+
+	struct GeometryIndexAllocation final
+	{
+		ID3D11Buffer* Buffer{ nullptr };
+		std::uint32_t StartIndexLocation{ 0 };
+		std::uint32_t IndexCount{ 0 };
+		DXGI_FORMAT IndexFormat{ DXGI_FORMAT_R32_UINT };
+		std::uint32_t PageIndex{ 0 };
+	};
+
+	struct GeometryBufferPoolStatistics final
+	{
+		std::uint32_t VertexPageCount{ 0 };
+		std::uint32_t IndexPageCount{ 0 };
+		std::uint32_t AllocationCount{ 0 };
+		std::uint64_t ReservedBytes{ 0 };
+		std::uint64_t UsedBytes{ 0 };
+		std::uint64_t LargestFreeBlockBytes{ 0 };
+
+		float Fragmentation() const;
+	};
+
+	/// <summary>
+	/// Pages of shared D3D11_USAGE_DEFAULT vertex buffers (one set per vertex declaration) and index buffers (one set per index width).
+	/// Meshes are suballocated into the pages and drawn with baseVertexLocation/startIndexLocation.
+	/// </summary>
+	class GeometryBufferPool final
+	{
+	public:
+		inline static const std::uint32_t DefaultPageSize{ 4 * 1024 * 1024 };
+
+		explicit GeometryBufferPool(std::uint32_t pageSize = DefaultPageSize);
+		GeometryBufferPool(const GeometryBufferPool&) = delete;
+		GeometryBufferPool& operator=(const GeometryBufferPool&) = delete;
+		GeometryBufferPool(GeometryBufferPool&&) = default;
+		GeometryBufferPool& operator=(GeometryBufferPool&&) = default;
+		~GeometryBufferPool() = default;
+
+		template <typename T>
+		GeometryVertexAllocation AllocateVertices(gsl::not_null<ID3D11Device*> device, gsl::span<const T> vertices);
+		GeometryIndexAllocation AllocateIndices(gsl::not_null<ID3D11Device*> device, gsl::span<const std::uint16_t> indices);
+		GeometryIndexAllocation AllocateIndices(gsl::not_null<ID3D11Device*> device, gsl::span<const std::uint32_t> indices);
+
+		void Free(const GeometryVertexAllocation& allocation);
+		void Free(const GeometryIndexAllocation& allocation);
+		void Clear();
+
+		GeometryBufferPoolStatistics Statistics() const;
+
+	private:
+		struct Page final
+		{
+			winrt::com_ptr<ID3D11Buffer> Buffer;
+			BufferSuballocator Allocator;
+			std::uint32_t ElementSize;
+		};
+
+		GeometryIndexAllocation AllocateIndices(gsl::not_null<ID3D11Device*> device, DXGI_FORMAT indexFormat, std::uint32_t indexSize, const void* indices, std::uint32_t indexCount);
+		GeometryVertexAllocation AllocateVertices(gsl::not_null<ID3D11Device*> device, const D3D11_INPUT_ELEMENT_DESC* vertexFormat, std::uint32_t vertexSize, const void* vertices, std::uint32_t vertexCount);
+		std::pair<std::uint32_t, BufferAllocation> Allocate(gsl::not_null<ID3D11Device*> device, std::vector<Page>& pages, std::uint32_t elementSize, std::uint32_t elementCount, std::uint32_t bindFlags, const void* data);
+
+		std::map<const D3D11_INPUT_ELEMENT_DESC*, std::vector<Page>> mVertexPages;
+		std::map<DXGI_FORMAT, std::vector<Page>> mIndexPages;
+		std::uint32_t mPageSize;
+	};
+}
+
+#include "GeometryBufferPool.inl"
\ No newline at end of file
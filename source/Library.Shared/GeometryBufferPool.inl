@@ -0,0 +1,11 @@
+#pragma once
+#include "GeometryBufferPool.h"
+
+namespace Library
+{
+	template <typename T>
+	inline GeometryVertexAllocation GeometryBufferPool::AllocateVertices(gsl::not_null<ID3D11Device*> device, gsl::span<const T> vertices)
+	{
+		return AllocateVertices(device, T::InputElements.data(), T::VertexSize(), vertices.data(), gsl::narrow<std::uint32_t>(vertices.size()));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "pch.h"
+#include "GeometryGenerator.h"
+#include "GameException.h"
+#include "ContentManager.h"
+#include "Model.h"
+#include "Mesh.h"
+
+using namespace std;
+using namespace gsl;
+using namespace DirectX;
+
+namespace Library
+{
+	MeshData GeometryGenerator::CreateSphere(uint32_t sliceCount, uint32_t stackCount, uint32_t lodCount, float radius)
+	{
+		if (lodCount == 0 || lodCount > 16)
+		{
+			throw GameException("Sphere level of detail count is out of range.");
+		}
+
+		// Coarser levels reuse every second grid line of the previous one, so the grid must halve evenly.
+		const uint32_t coarsestStride = 1U << (lodCount - 1);
+		if (sliceCount < 3 * coarsestStride || stackCount < 2 * coarsestStride || sliceCount % coarsestStride != 0 || stackCount % coarsestStride != 0)
+		{
+			throw GameException("Sphere slice and stack counts must be multiples of 2^(lodCount - 1), with at least 3 slices and 2 stacks in the coarsest level.");
+		}
+
+		const uint32_t rowLength = sliceCount + 1;
+		const uint64_t vertexCount = uint64_t(rowLength) * (stackCount + 1);
+		if (vertexCount > uint64_t(numeric_limits<uint16_t>::max()) + 1)
+		{
+			throw GameException("Sphere has too many vertices for 16-bit indices.");
+		}
+
+		MeshData meshData;
+		meshData.Name = "Sphere";
+		meshData.Vertices.reserve(narrow_cast<size_t>(vertexCount));
+		meshData.Normals.reserve(narrow_cast<size_t>(vertexCount));
+		meshData.Tangents.reserve(narrow_cast<size_t>(vertexCount));
+		meshData.TextureCoordinates.emplace_back().reserve(narrow_cast<size_t>(vertexCount));
+		vector<XMFLOAT3>& textureCoordinates = meshData.TextureCoordinates.front();
+
+		// Stacks run from the north pole (v = 0) to the south pole (v = 1); slices turn from +x toward -z as u grows, matching Models\Sphere.obj.
+		// The seam column and the pole rows have a vertex per slice so every vertex has its own texture coordinate.
+		for (uint32_t stack = 0; stack <= stackCount; ++stack)
+		{
+			const float v = float(stack) / stackCount;
+			const float polarAngle = v * XM_PI;
+			const float sinPolar = sin(polarAngle);
+			const float cosPolar = cos(polarAngle);
+
+			for (uint32_t slice = 0; slice <= sliceCount; ++slice)
+			{
+				const float u = float(slice) / sliceCount;
+				const float azimuth = u * XM_2PI;
+				const float sinAzimuth = sin(azimuth);
+				const float cosAzimuth = cos(azimuth);
+
+				const XMFLOAT3 normal(sinPolar * cosAzimuth, cosPolar, -sinPolar * sinAzimuth);
+				meshData.Vertices.emplace_back(normal.x * radius, normal.y * radius, normal.z * radius);
+				meshData.Normals.push_back(normal);
+				meshData.Tangents.emplace_back(-sinAzimuth, 0.0f, -cosAzimuth);
+				textureCoordinates.emplace_back(u, v, 0.0f);
+			}
+		}
+
+		// Each quad is two clockwise triangles seen from outside; the quads touching a pole collapse to one.
+		auto appendQuad = [&](uint32_t stack, uint32_t slice, uint32_t stride)
+		{
+			const uint32_t topLeft = stack * rowLength + slice;
+			const uint32_t topRight = topLeft + stride;
+			const uint32_t bottomLeft = topLeft + stride * rowLength;
+			const uint32_t bottomRight = bottomLeft + stride;
+
+			if (stack > 0)
+			{
+				meshData.Indices.insert(meshData.Indices.end(), { topLeft, topRight, bottomLeft });
+			}
+
+			if (stack + stride < stackCount)
+			{
+				meshData.Indices.insert(meshData.Indices.end(), { topRight, bottomRight, bottomLeft });
+			}
+		};
+
+		// The full-detail level is emitted in square tiles of quads, each of which becomes a meshlet.
+		for (uint32_t tileStack = 0; tileStack < stackCount; tileStack += MeshletTileStacks)
+		{
+			for (uint32_t tileSlice = 0; tileSlice < sliceCount; tileSlice += MeshletTileSlices)
+			{
+				Meshlet meshlet;
+				meshlet.StartIndex = narrow<uint32_t>(meshData.Indices.size());
+
+				const uint32_t tileStackEnd = min(tileStack + MeshletTileStacks, stackCount);
+				const uint32_t tileSliceEnd = min(tileSlice + MeshletTileSlices, sliceCount);
+				for (uint32_t stack = tileStack; stack < tileStackEnd; ++stack)
+				{
+					for (uint32_t slice = tileSlice; slice < tileSliceEnd; ++slice)
+					{
+						appendQuad(stack, slice, 1);
+					}
+				}
+
+				meshlet.IndexCount = narrow<uint32_t>(meshData.Indices.size()) - meshlet.StartIndex;
+
+				// Tiles on a pole row leave out the corner of each collapsed quad, so their vertices are counted rather than derived.
+				vector<uint32_t> tileVertices(meshData.Indices.begin() + meshlet.StartIndex, meshData.Indices.end());
+				sort(tileVertices.begin(), tileVertices.end());
+				meshlet.VertexCount = narrow<uint32_t>(distance(tileVertices.begin(), unique(tileVertices.begin(), tileVertices.end())));
+				meshData.Meshlets.push_back(meshlet);
+			}
+		}
+
+		for (Meshlet& meshlet : meshData.Meshlets)
+		{
+			meshlet.ComputeBounds(meshData);
+		}
+
+		// A quad's center sinks furthest below the sphere, by r(1 - cos(a/2)cos(b/2)) for angular steps a and b.
+		// Levels report that depth relative to the full-detail level's, since the error is measured against it.
+		auto tessellationDepth = [&](uint32_t stride)
+		{
+			const float polarStep = XM_PI * stride / stackCount;
+			const float azimuthStep = XM_2PI * stride / sliceCount;
+			return radius * (1.0f - cos(polarStep * 0.5f) * cos(azimuthStep * 0.5f));
+		};
+
+		meshData.Lods.push_back({ 0, narrow<uint32_t>(meshData.Indices.size()), 0.0f });
+		for (uint32_t lod = 1; lod < lodCount; ++lod)
+		{
+			const uint32_t stride = 1U << lod;
+			const uint32_t startIndex = narrow<uint32_t>(meshData.Indices.size());
+			for (uint32_t stack = 0; stack < stackCount; stack += stride)
+			{
+				for (uint32_t slice = 0; slice < sliceCount; slice += stride)
+				{
+					appendQuad(stack, slice, stride);
+				}
+			}
+
+			meshData.Lods.push_back({ startIndex, narrow<uint32_t>(meshData.Indices.size()) - startIndex, tessellationDepth(stride) - tessellationDepth(1) });
+		}
+
+		meshData.FaceCount = meshData.Lods.front().IndexCount / 3;
+
+		return meshData;
+	}
+
+	shared_ptr<Model> GeometryGenerator::CreateSphereModel(uint32_t sliceCount, uint32_t stackCount, uint32_t lodCount, float radius)
+	{
+		// Meshes keep a reference to their model, so the model must be at its final address first.
+		auto model = make_shared<Model>();
+		model->Data().Meshes.push_back(make_shared<Mesh>(*model, CreateSphere(sliceCount, stackCount, lodCount, radius)));
+
+		return model;
+	}
+
+	shared_ptr<Model> GeometryGenerator::LoadSphere(ContentManager& content)
+	{
+		return content.Load<Model>(SphereAssetName, false, [](wstring&)
+		{
+			return CreateSphereModel();
+		});
+	}
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Library
+{
+	class ContentManager;
+	class Model;
+	struct MeshData;
+
+	/// <summary>
+	/// Builds meshes procedurally, so common shapes need no model file.
+	/// Spheres are latitude/longitude grids. Every coarser level of detail skips every other row and column of the same vertex grid,
+	/// so all levels share one vertex buffer, and the full-detail level is emitted tile by tile so each tile is a meshlet.
+	/// </summary>
+	class GeometryGenerator final
+	{
+	public:
+		inline static const std::uint32_t DefaultSliceCount{ 64 };
+		inline static const std::uint32_t DefaultStackCount{ 32 };
+		inline static const std::uint32_t DefaultLodCount{ 4 };
+		inline static const float DefaultSphereRadius{ 5.752084f }; // The radius of Models\Sphere.obj, which the scenes' scales were tuned against
+		inline static const std::wstring SphereAssetName{ L"Generated\\Sphere" };
+
+		static MeshData CreateSphere(std::uint32_t sliceCount = DefaultSliceCount, std::uint32_t stackCount = DefaultStackCount, std::uint32_t lodCount = DefaultLodCount, float radius = DefaultSphereRadius);
+		static std::shared_ptr<Model> CreateSphereModel(std::uint32_t sliceCount = DefaultSliceCount, std::uint32_t stackCount = DefaultStackCount, std::uint32_t lodCount = DefaultLodCount, float radius = DefaultSphereRadius);
+
+		/// <summary>
+		/// Returns the default sphere through the content manager, generating it on first use, so every component shares one mesh and one set of GPU buffers.
+		/// </summary>
+		static std::shared_ptr<Model> LoadSphere(ContentManager& content);
+
+		GeometryGenerator() = delete;
+		GeometryGenerator(const GeometryGenerator&) = delete;
+		GeometryGenerator& operator=(const GeometryGenerator&) = delete;
+		GeometryGenerator(GeometryGenerator&&) = delete;
+		GeometryGenerator& operator=(GeometryGenerator&&) = delete;
+		~GeometryGenerator() = default;
+
+	private:
+		// 8x4 quads: at most 45 vertices and 64 triangles, within the meshlet limits, and an even split of power-of-two grids
+		inline static const std::uint32_t MeshletTileSlices{ 8 };
+		inline static const std::uint32_t MeshletTileStacks{ 4 };
+	};
+}
\ No newline at end of file
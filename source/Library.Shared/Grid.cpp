@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "Grid.h"
+#include "ComponentScheduler.h"
 #include "GameException.h"
 #include "Game.h"
 #include "Camera.h"
@@ -82,6 +83,11 @@ namespace Library
 		InitializeGrid();
 	}
 
+	void Grid::DeclareAccess(ComponentAccess& access) const
+	{
+		access.Reads(mCamera.get()); // The camera's callbacks update this grid's material
+	}
+
 	void Grid::Draw(const GameTime&)
 	{
 		if (mUpdateMaterial)
@@ -35,6 +35,7 @@ namespace Library
 		void SetScale(std::uint32_t scale);
 
 		virtual void Initialize() override;
+		virtual void DeclareAccess(ComponentAccess& access) const override;
 		virtual void Draw(const GameTime& gameTime) override;
 
 		inline static const std::uint32_t DefaultSize{ 16 };
@@ -51,6 +51,11 @@ namespace Library
 		ImGui::DestroyContext();
 	}
 
+	void ImGuiComponent::DeclareAccess(ComponentAccess&) const
+	{
+		// Does no work in Update; render blocks run in Draw
+	}
+
 	void ImGuiComponent::Draw(const GameTime&)
 	{
 		if (mUseCustomDraw == false)
@@ -29,6 +29,7 @@ namespace Library
 
 		virtual void Initialize() override;
 		virtual void Shutdown() override;
+		virtual void DeclareAccess(ComponentAccess& access) const override;
 		virtual void Draw(const GameTime& gameTime) override;
 
 		// Use this when opting to invoke ImGui::Begin/End/Render statements manually
@@ -0,0 +1,464 @@
+#include "pch.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+
+using namespace std;
+using namespace gsl;
+
+namespace Library
+{
+	namespace
+	{
+		// Which system's worker the current thread is, if any, and the deque it owns
+		thread_local const JobSystem* sCurrentJobSystem{ nullptr };
+		thread_local uint32_t sCurrentQueueIndex{ 0 };
+	}
+
+	// Released jobs, and the shared_ptr control blocks that counted their handles, kept for the next Submit
+	struct JobSystem::JobPool final
+	{
+		JobPool() = default;
+		JobPool(const JobPool&) = delete;
+		JobPool& operator=(const JobPool&) = delete;
+		JobPool(JobPool&&) = delete;
+		JobPool& operator=(JobPool&&) = delete;
+
+		~JobPool()
+		{
+			for (Job* job : FreeJobs)
+			{
+				delete job;
+			}
+
+			for (void* block : FreeBlocks)
+			{
+				::operator delete(block);
+			}
+		}
+
+		Job* AcquireJob()
+		{
+			{
+				lock_guard<mutex> lock(Mutex);
+				if (!FreeJobs.empty())
+				{
+					Job* job = FreeJobs.back();
+					FreeJobs.pop_back();
+					return job;
+				}
+			}
+
+			// Room for a few continuations up front, as a recycled job may be depended on where it never was before
+			auto job = make_unique<Job>();
+			job->Continuations.reserve(InitialContinuationCapacity);
+			return job.release();
+		}
+
+		void RecycleJob(Job* job)
+		{
+			job->Function = nullptr;
+			job->PendingDependencies = 1;
+			job->IsComplete = false;
+			job->Continuations.clear();
+			job->Exception = nullptr;
+
+			lock_guard<mutex> lock(Mutex);
+			FreeJobs.push_back(job);
+		}
+
+		// Every control block is the same type, so blocks are pooled at the first size asked for
+		void* AllocateBlock(size_t size)
+		{
+			{
+				lock_guard<mutex> lock(Mutex);
+				if (BlockSize == 0)
+				{
+					BlockSize = size;
+				}
+
+				if (size == BlockSize && !FreeBlocks.empty())
+				{
+					void* block = FreeBlocks.back();
+					FreeBlocks.pop_back();
+					return block;
+				}
+			}
+
+			return ::operator new(size);
+		}
+
+		void FreeBlock(void* block, size_t size)
+		{
+			{
+				lock_guard<mutex> lock(Mutex);
+				if (size == BlockSize)
+				{
+					FreeBlocks.push_back(block);
+					return;
+				}
+			}
+
+			::operator delete(block);
+		}
+
+		inline static const size_t InitialContinuationCapacity{ 4 };
+
+		mutex Mutex;
+		vector<Job*> FreeJobs;
+		vector<void*> FreeBlocks;
+		size_t BlockSize{ 0 };
+	};
+
+	// A handle's deleter, which returns the job to the pool instead of freeing it
+	struct JobSystem::JobRecycler final
+	{
+		void operator()(Job* job) const
+		{
+			Pool->RecycleJob(job);
+		}
+
+		shared_ptr<JobPool> Pool;
+	};
+
+	template <typename T>
+	struct JobSystem::JobAllocator final
+	{
+		using value_type = T;
+
+		explicit JobAllocator(const shared_ptr<JobPool>& pool) :
+			Pool(pool)
+		{
+		}
+
+		template <typename U>
+		JobAllocator(const JobAllocator<U>& other) :
+			Pool(other.Pool)
+		{
+		}
+
+		T* allocate(size_t count)
+		{
+			static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "Pooled blocks come from the default operator new.");
+			return static_cast<T*>(Pool->AllocateBlock(sizeof(T) * count));
+		}
+
+		void deallocate(T* block, size_t count)
+		{
+			Pool->FreeBlock(block, sizeof(T) * count);
+		}
+
+		template <typename U>
+		bool operator==(const JobAllocator<U>& other) const
+		{
+			return Pool == other.Pool;
+		}
+
+		template <typename U>
+		bool operator!=(const JobAllocator<U>& other) const
+		{
+			return Pool != other.Pool;
+		}
+
+		shared_ptr<JobPool> Pool;
+	};
+
+	JobSystem::JobSystem(uint32_t threadCount) :
+		mThreadCount(threadCount == 0 ? max(thread::hardware_concurrency(), 1U) : threadCount), mJobPool(make_shared<JobPool>())
+	{
+		mQueues.reserve(mThreadCount);
+		for (uint32_t i = 0; i < mThreadCount; ++i)
+		{
+			mQueues.push_back(make_unique<WorkQueue>());
+		}
+
+		mWorkers.reserve(mThreadCount - 1);
+		for (uint32_t i = 1; i < mThreadCount; ++i)
+		{
+			mWorkers.emplace_back(&JobSystem::WorkerLoop, this, i);
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			lock_guard<mutex> lock(mWakeMutex);
+			mStopping = true;
+		}
+
+		mWakeCondition.notify_all();
+		for (auto& worker : mWorkers)
+		{
+			worker.join();
+		}
+	}
+
+	uint32_t JobSystem::ThreadCount() const
+	{
+		return mThreadCount;
+	}
+
+	JobHandle JobSystem::Submit(function<void()> function, initializer_list<JobHandle> dependencies)
+	{
+		return Submit(move(function), span<const JobHandle>(dependencies.begin(), dependencies.size()));
+	}
+
+	JobHandle JobSystem::Submit(function<void()> function, span<const JobHandle> dependencies)
+	{
+		JobHandle job = AcquireJob();
+		job->Function = move(function);
+
+		for (const auto& dependency : dependencies)
+		{
+			if (dependency == nullptr)
+			{
+				continue;
+			}
+
+			// Completion is published under the same lock, so the dependency either sees this continuation or is already complete
+			lock_guard<mutex> lock(dependency->ContinuationMutex);
+			if (!dependency->IsComplete)
+			{
+				++job->PendingDependencies;
+				dependency->Continuations.push_back(job);
+			}
+		}
+
+		if (--job->PendingDependencies == 0)
+		{
+			Enqueue(job);
+		}
+
+		return job;
+	}
+
+	void JobSystem::Wait(const JobHandle& job)
+	{
+		if (job == nullptr)
+		{
+			return;
+		}
+
+		while (!job->IsComplete)
+		{
+			if (!RunQueuedJob())
+			{
+				this_thread::yield();
+			}
+		}
+
+		if (job->Exception != nullptr)
+		{
+			rethrow_exception(job->Exception);
+		}
+	}
+
+	void JobSystem::Wait(span<const JobHandle> jobs)
+	{
+		// Everything completes before anything is rethrown, so no job outlives state its caller is about to unwind
+		for (const auto& job : jobs)
+		{
+			while (job != nullptr && !job->IsComplete)
+			{
+				if (!RunQueuedJob())
+				{
+					this_thread::yield();
+				}
+			}
+		}
+
+		for (const auto& job : jobs)
+		{
+			if (job != nullptr && job->Exception != nullptr)
+			{
+				rethrow_exception(job->Exception);
+			}
+		}
+	}
+
+	void JobSystem::ParallelForRanges(size_t rangeCount, const function<void(size_t)>& range)
+	{
+		if (rangeCount == 1 || mThreadCount == SingleThreaded)
+		{
+			for (size_t i = 0; i < rangeCount; ++i)
+			{
+				range(i);
+			}
+
+			return;
+		}
+
+		vector<JobHandle> jobs;
+		jobs.reserve(rangeCount - 1);
+		for (size_t i = 1; i < rangeCount; ++i)
+		{
+			jobs.push_back(Submit([&range, i]() { range(i); }));
+		}
+
+		// The calling thread takes the first range rather than idling; the jobs reference range, so they all finish before anything propagates
+		exception_ptr firstRangeException;
+		try
+		{
+			range(0);
+		}
+		catch (...)
+		{
+			firstRangeException = current_exception();
+		}
+
+		Wait(jobs);
+		if (firstRangeException != nullptr)
+		{
+			rethrow_exception(firstRangeException);
+		}
+	}
+
+	JobHandle JobSystem::AcquireJob()
+	{
+		return JobHandle(mJobPool->AcquireJob(), JobRecycler{ mJobPool }, JobAllocator<Job>(mJobPool));
+	}
+
+	void JobSystem::Enqueue(JobHandle job)
+	{
+		// Counted before it is visible, so a thief can never take it while the count reads zero
+		{
+			lock_guard<mutex> lock(mWakeMutex);
+			++mQueuedJobCount;
+		}
+
+		{
+			WorkQueue& queue = *mQueues[CurrentQueueIndex()];
+			lock_guard<mutex> lock(queue.Mutex);
+			queue.PushBack(move(job));
+		}
+
+		mWakeCondition.notify_one();
+	}
+
+	bool JobSystem::RunQueuedJob()
+	{
+		const uint32_t queueIndex = CurrentQueueIndex();
+		JobHandle job;
+		{
+			WorkQueue& queue = *mQueues[queueIndex];
+			lock_guard<mutex> lock(queue.Mutex);
+			job = queue.PopBack();
+		}
+
+		for (uint32_t i = 1; job == nullptr && i < mThreadCount; ++i)
+		{
+			WorkQueue& victim = *mQueues[(queueIndex + i) % mThreadCount];
+			lock_guard<mutex> lock(victim.Mutex);
+			job = victim.PopFront();
+		}
+
+		if (job == nullptr)
+		{
+			return false;
+		}
+
+		--mQueuedJobCount;
+		Execute(job);
+
+		return true;
+	}
+
+	void JobSystem::Execute(const JobHandle& job)
+	{
+		try
+		{
+			job->Function();
+		}
+		catch (...)
+		{
+			job->Exception = current_exception();
+		}
+
+		job->Function = nullptr; // Release whatever the job captured now, rather than when the last handle goes
+
+		{
+			lock_guard<mutex> lock(job->ContinuationMutex);
+			job->IsComplete = true;
+		}
+
+		// Nothing is added once the job reads as complete, so the list is this thread's alone from here on
+		for (auto& continuation : job->Continuations)
+		{
+			if (--continuation->PendingDependencies == 0)
+			{
+				Enqueue(move(continuation));
+			}
+		}
+
+		job->Continuations.clear();
+	}
+
+	void JobSystem::WorkerLoop(uint32_t queueIndex)
+	{
+		sCurrentJobSystem = this;
+		sCurrentQueueIndex = queueIndex;
+		PROFILE_THREAD_NAME("Job Worker " + to_string(queueIndex));
+
+		for (;;)
+		{
+			if (RunQueuedJob())
+			{
+				continue;
+			}
+
+			unique_lock<mutex> lock(mWakeMutex);
+			mWakeCondition.wait(lock, [this]() { return mStopping || mQueuedJobCount > 0; });
+			if (mStopping)
+			{
+				return;
+			}
+		}
+	}
+
+	uint32_t JobSystem::CurrentQueueIndex() const
+	{
+		return (sCurrentJobSystem == this ? sCurrentQueueIndex : 0);
+	}
+
+	void JobSystem::WorkQueue::PushBack(JobHandle job)
+	{
+		if (Count == Slots.size())
+		{
+			vector<JobHandle> slots(max<size_t>(Slots.size() * 2, 16));
+			for (size_t i = 0; i < Count; ++i)
+			{
+				slots[i] = move(Slots[(Head + i) % Slots.size()]);
+			}
+
+			Slots.swap(slots);
+			Head = 0;
+		}
+
+		Slots[(Head + Count) % Slots.size()] = move(job);
+		++Count;
+	}
+
+	JobHandle JobSystem::WorkQueue::PopBack()
+	{
+		if (Count == 0)
+		{
+			return nullptr;
+		}
+
+		--Count;
+		return move(Slots[(Head + Count) % Slots.size()]);
+	}
+
+	JobHandle JobSystem::WorkQueue::PopFront()
+	{
+		if (Count == 0)
+		{
+			return nullptr;
+		}
+
+		JobHandle job = move(Slots[Head]);
+		Head = (Head + 1) % Slots.size();
+		--Count;
+
+		return job;
+	}
+}
\ No newline at end of file
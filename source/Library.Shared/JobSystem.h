@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <gsl\gsl>
+
+namespace Library
+{
+	struct Job final
+	{
+		std::function<void()> Function;
+		std::atomic<std::uint32_t> PendingDependencies{ 1 }; // The extra count is held by Submit until every dependency is registered
+		std::atomic<bool> IsComplete{ false };
+		std::mutex ContinuationMutex;
+		std::vector<std::shared_ptr<Job>> Continuations; // Jobs waiting on this one; keeps its capacity as the job is recycled
+		std::exception_ptr Exception;
+	};
+
+	using JobHandle = std::shared_ptr<Job>;
+
+	/// <summary>
+	/// Work-stealing task scheduler. Every thread owns a deque: it pushes and pops its own jobs at the back (most recent first, for cache warmth)
+	/// while idle threads steal from the front of the others' (oldest first, which tends to be the largest remaining work).
+	/// The constructing thread is one of the threads and runs jobs whenever it waits, so Wait never idles while work is queued.
+	/// A thread count of 1 starts no workers: jobs then run on the waiting thread in a deterministic order, which is the mode to debug in.
+	/// Jobs still queued when the system is destroyed are discarded; wait on them first.
+	/// A job goes back to the system's pool when its last handle is released, and its queues only ever grow,
+	/// so once the pool and queues have grown to a frame's worth of jobs, submitting allocates nothing.
+	/// Functions whose captures fit std::function's small-object buffer (a couple of pointers) keep that true.
+	/// </summary>
+	class JobSystem final
+	{
+	public:
+		inline static const std::uint32_t SingleThreaded{ 1 };
+
+		explicit JobSystem(std::uint32_t threadCount = 0); // 0 uses one thread per hardware thread
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+		JobSystem(JobSystem&&) = delete;
+		JobSystem& operator=(JobSystem&&) = delete;
+		~JobSystem();
+
+		std::uint32_t ThreadCount() const;
+
+		JobHandle Submit(std::function<void()> function, std::initializer_list<JobHandle> dependencies = {});
+		JobHandle Submit(std::function<void()> function, gsl::span<const JobHandle> dependencies);
+
+		/// <summary>
+		/// Runs queued jobs on the calling thread until the job completes, then rethrows anything the job threw.
+		/// </summary>
+		void Wait(const JobHandle& job);
+		void Wait(gsl::span<const JobHandle> jobs);
+
+		/// <summary>
+		/// Calls function(rangeBegin, rangeEnd) over [begin, end) in ranges of grainSize elements (the last may be shorter), and returns once all have run.
+		/// Each range is one job; the grain size trades scheduling overhead against load balance.
+		/// </summary>
+		template <typename Function>
+		void ParallelFor(std::size_t begin, std::size_t end, std::size_t grainSize, Function&& function);
+
+	private:
+		struct JobPool;
+		struct JobRecycler;
+
+		template <typename T>
+		struct JobAllocator;
+
+		// A ring the owning thread pushes and pops at the back, and thieves pop at the front
+		struct WorkQueue final
+		{
+			void PushBack(JobHandle job);
+			JobHandle PopBack();
+			JobHandle PopFront();
+
+			std::mutex Mutex;
+			std::vector<JobHandle> Slots; // Doubles when full and never shrinks
+			std::size_t Head{ 0 };
+			std::size_t Count{ 0 };
+		};
+
+		JobHandle AcquireJob();
+
+		void ParallelForRanges(std::size_t rangeCount, const std::function<void(std::size_t)>& range);
+		void Enqueue(JobHandle job);
+		bool RunQueuedJob();
+		void Execute(const JobHandle& job);
+		void WorkerLoop(std::uint32_t queueIndex);
+		std::uint32_t CurrentQueueIndex() const;
+
+		std::uint32_t mThreadCount;
+		std::shared_ptr<JobPool> mJobPool; // Shared with every handle, so a handle can outlive the system
+		std::vector<std::unique_ptr<WorkQueue>> mQueues; // Index 0 belongs to the constructing thread and any other thread that is not a worker
+		std::vector<std::thread> mWorkers;
+		std::mutex mWakeMutex;
+		std::condition_variable mWakeCondition;
+		std::atomic<std::uint32_t> mQueuedJobCount{ 0 };
+		bool mStopping{ false };
+	};
+
+	template <typename Function>
+	void JobSystem::ParallelFor(std::size_t begin, std::size_t end, std::size_t grainSize, Function&& function)
+	{
+		if (begin >= end)
+		{
+			return;
+		}
+
+		grainSize = std::max<std::size_t>(grainSize, 1);
+		const std::size_t rangeCount = (end - begin + grainSize - 1) / grainSize;
+		ParallelForRanges(rangeCount, [begin, end, grainSize, &function](std::size_t range)
+		{
+			const std::size_t rangeBegin = begin + range * grainSize;
+			function(rangeBegin, std::min(rangeBegin + grainSize, end));
+		});
+	}
+}
\ No newline at end of file
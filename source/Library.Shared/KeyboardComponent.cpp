@@ -22,11 +22,13 @@ namespace Library
 
 	const Keyboard::State& KeyboardComponent::CurrentState() const
 	{
+		ValidateRead();
 		return mCurrentState;
 	}
 
 	const Keyboard::State& KeyboardComponent::LastState() const
 	{
+		ValidateRead();
 		return mLastState;
 	}
 
@@ -42,23 +44,32 @@ namespace Library
 		mCurrentState = sKeyboard->GetState();
 	}
 
+	void KeyboardComponent::DeclareAccess(ComponentAccess&) const
+	{
+		// Reads only the keyboard device
+	}
+
 	bool KeyboardComponent::IsKeyUp(Keys key) const
 	{
+		ValidateRead();
 		return mCurrentState.IsKeyUp(static_cast<Keyboard::Keys>(key));
 	}
 
 	bool KeyboardComponent::IsKeyDown(Keys key) const
 	{
+		ValidateRead();
 		return mCurrentState.IsKeyDown(static_cast<Keyboard::Keys>(key));
 	}
 
 	bool KeyboardComponent::WasKeyUp(Keys key) const
 	{
+		ValidateRead();
 		return mLastState.IsKeyUp(static_cast<Keyboard::Keys>(key));
 	}
 
 	bool KeyboardComponent::WasKeyDown(Keys key) const
 	{
+		ValidateRead();
 		return mLastState.IsKeyDown(static_cast<Keyboard::Keys>(key));
 	}
 
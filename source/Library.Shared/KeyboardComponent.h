@@ -206,6 +206,7 @@ namespace Library
 
 		virtual void Initialize() override;
 		virtual void Update(const GameTime& gameTime) override;
+		virtual void DeclareAccess(ComponentAccess& access) const override;
 
 		bool IsKeyUp(Keys key) const;
 		bool IsKeyDown(Keys key) const;
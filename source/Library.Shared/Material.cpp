@@ -4,6 +4,7 @@
 #include "Game.h"
 #include "VertexShader.h"
 #include "PixelShader.h"
+#include "Profiler.h"
 
 using namespace std;
 using namespace std::placeholders;
@@ -179,6 +180,8 @@ namespace Library
 
 	void Material::BeginDraw()
 	{
+		PROFILE_FUNCTION();
+
 		auto direct3DDeviceContext = mGame->Direct3DDeviceContext();
 		direct3DDeviceContext->IASetPrimitiveTopology(mTopology);
 
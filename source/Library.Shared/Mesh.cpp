@@ -4,6 +4,8 @@
 #include "StreamHelper.h"
 #include "ModelMaterial.h"
 #include "Model.h"
+#include "DirectXHelper.h"
+#include <atomic>
 
 using namespace std;
 using namespace gsl;
@@ -11,15 +13,173 @@ using namespace DirectX;
 
 namespace Library
 {
-	Mesh::Mesh(Model& model, InputStreamHelper& streamHelper) :
+	namespace
+	{
+		atomic<uint64_t> sNextMeshId{ 1 };
+
+		struct EncodedStream final
+		{
+			MeshStreamSemantic Semantic;
+			uint32_t Channel;
+			uint32_t ComponentCount;
+			uint32_t ElementCount;
+			vector<uint8_t> Data;
+		};
+
+		void WriteEncoded(OutputStreamHelper& streamHelper, const vector<uint8_t>& encoded)
+		{
+			streamHelper << narrow_cast<uint32_t>(encoded.size());
+			streamHelper.Stream().write(reinterpret_cast<const char*>(encoded.data()), narrow_cast<streamsize>(encoded.size()));
+		}
+
+		void ReadEncoded(InputStreamHelper& streamHelper, uint32_t encodedSize, vector<uint8_t>& encoded)
+		{
+			encoded.resize(encodedSize);
+			if (!streamHelper.Stream().read(reinterpret_cast<char*>(encoded.data()), encodedSize))
+			{
+				throw GameException("Compressed mesh data is truncated.");
+			}
+		}
+	}
+
+	void MeshBounds::Merge(const MeshBounds& other)
+	{
+		XMStoreFloat3(&Minimum, XMVectorMin(XMLoadFloat3(&Minimum), XMLoadFloat3(&other.Minimum)));
+		XMStoreFloat3(&Maximum, XMVectorMax(XMLoadFloat3(&Maximum), XMLoadFloat3(&other.Maximum)));
+
+		const XMVECTOR center = XMLoadFloat3(&Center);
+		const XMVECTOR otherCenter = XMLoadFloat3(&other.Center);
+		const XMVECTOR offset = XMVectorSubtract(otherCenter, center);
+		const float distance = XMVectorGetX(XMVector3Length(offset));
+		if (distance + other.Radius <= Radius)
+		{
+			return;
+		}
+
+		if (distance + Radius <= other.Radius)
+		{
+			Center = other.Center;
+			Radius = other.Radius;
+			return;
+		}
+
+		// Smallest sphere touching the far sides of both
+		const float radius = (distance + Radius + other.Radius) * 0.5f;
+		XMStoreFloat3(&Center, XMVectorAdd(center, XMVectorScale(offset, (radius - Radius) / distance)));
+		Radius = radius;
+	}
+
+	MeshBounds MeshBounds::FromPositions(span<const XMFLOAT3> positions)
+	{
+		return FromPositions(reinterpret_cast<const byte*>(positions.data()), sizeof(XMFLOAT3), positions.size());
+	}
+
+	MeshBounds MeshBounds::FromPositions(const byte* firstPosition, size_t stride, size_t count)
+	{
+		MeshBounds bounds;
+		if (count == 0)
+		{
+			return bounds;
+		}
+
+		auto position = [&](size_t index)
+		{
+			return XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(firstPosition + index * stride));
+		};
+
+		XMVECTOR minimum = position(0);
+		XMVECTOR maximum = minimum;
+		for (size_t i = 1; i < count; ++i)
+		{
+			minimum = XMVectorMin(minimum, position(i));
+			maximum = XMVectorMax(maximum, position(i));
+		}
+
+		XMStoreFloat3(&bounds.Minimum, minimum);
+		XMStoreFloat3(&bounds.Maximum, maximum);
+
+		auto farthestFrom = [&](FXMVECTOR point)
+		{
+			size_t farthest = 0;
+			float farthestDistanceSquared = -1.0f;
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float distanceSquared = XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(position(i), point)));
+				if (distanceSquared > farthestDistanceSquared)
+				{
+					farthest = i;
+					farthestDistanceSquared = distanceSquared;
+				}
+			}
+
+			return farthest;
+		};
+
+		// Sphere around the box's center
+		const XMVECTOR boxCenter = XMVectorScale(XMVectorAdd(minimum, maximum), 0.5f);
+		const float boxRadius = XMVectorGetX(XMVector3Length(XMVectorSubtract(position(farthestFrom(boxCenter)), boxCenter)));
+
+		// Ritter's sphere: seed with the two most distant points found by a pair of sweeps, then grow to take in any stragglers
+		const size_t first = farthestFrom(position(0));
+		const size_t second = farthestFrom(position(first));
+		XMVECTOR ritterCenter = XMVectorScale(XMVectorAdd(position(first), position(second)), 0.5f);
+		float ritterRadius = XMVectorGetX(XMVector3Length(XMVectorSubtract(position(second), ritterCenter)));
+		for (size_t i = 0; i < count; ++i)
+		{
+			const XMVECTOR offset = XMVectorSubtract(position(i), ritterCenter);
+			const float distance = XMVectorGetX(XMVector3Length(offset));
+			if (distance > ritterRadius)
+			{
+				const float radius = (ritterRadius + distance) * 0.5f;
+				ritterCenter = XMVectorAdd(ritterCenter, XMVectorScale(offset, (radius - ritterRadius) / distance));
+				ritterRadius = radius;
+			}
+		}
+
+		if (ritterRadius < boxRadius)
+		{
+			XMStoreFloat3(&bounds.Center, ritterCenter);
+			bounds.Radius = ritterRadius;
+		}
+		else
+		{
+			XMStoreFloat3(&bounds.Center, boxCenter);
+			bounds.Radius = boxRadius;
+		}
+
+		return bounds;
+	}
+
+	Mesh::Mesh(Model& model, InputStreamHelper& streamHelper, uint32_t fileVersion, const InterleavedVertexLayout* interleavedLayout, pmr::memory_resource* streamResource) :
 		mModel(&model)
 	{
-		Load(streamHelper);
+		Load(streamHelper, fileVersion, interleavedLayout, streamResource);
+		if (interleavedLayout == nullptr)
+		{
+			mStreams = MeshStreams(mData, streamResource);
+		}
+	}
+
+	Mesh::Mesh(Model& model, MeshData&& meshData, pmr::memory_resource* streamResource) :
+		mModel(&model), mData(move(meshData)), mStreams(mData, streamResource)
+	{
+		ComputeBounds();
+	}
+
+	Mesh::UniqueId::UniqueId() noexcept :
+		Value(sNextMeshId.fetch_add(1, memory_order_relaxed))
+	{
+	}
+
+	Mesh::UniqueId::UniqueId(const UniqueId&) noexcept :
+		UniqueId()
+	{
 	}
 
-	Mesh::Mesh(Model& model, MeshData&& meshData) :
-		mModel(&model), mData(move(meshData))
+	Mesh::UniqueId& Mesh::UniqueId::operator=(const UniqueId&) noexcept
 	{
+		Value = sNextMeshId.fetch_add(1, memory_order_relaxed);
+		return *this;
 	}
 
 	Model& Mesh::GetModel()
@@ -37,34 +197,69 @@ namespace Library
 		return mData.Name;
 	}
 
-	const vector<XMFLOAT3>& Mesh::Vertices() const
+	uint64_t Mesh::Id() const
 	{
-		return mData.Vertices;
+		return mId.Value;
 	}
 
-	const vector<XMFLOAT3>& Mesh::Normals() const
+	uint32_t Mesh::VertexCount() const
 	{
-		return mData.Normals;
+		return (mStreams.IsEmpty() ? narrow_cast<uint32_t>(mData.Vertices.size()) : mStreams.VertexCount());
 	}
 
-	const vector<XMFLOAT3>& Mesh::Tangents() const
+	span<const XMFLOAT3> Mesh::Vertices() const
 	{
-		return mData.Tangents;
+		return (mStreams.IsEmpty() ? span<const XMFLOAT3>(mData.Vertices) : mStreams.Vertices());
 	}
 
-	const vector<XMFLOAT3>& Mesh::BiNormals() const
+	span<const XMFLOAT3> Mesh::Normals() const
 	{
-		return mData.BiNormals;
+		return (mStreams.IsEmpty() ? span<const XMFLOAT3>(mData.Normals) : mStreams.Normals());
 	}
 
-	const vector<vector<XMFLOAT3>>& Mesh::TextureCoordinates() const
+	span<const XMFLOAT3> Mesh::Tangents() const
 	{
-		return mData.TextureCoordinates;
+		return (mStreams.IsEmpty() ? span<const XMFLOAT3>(mData.Tangents) : mStreams.Tangents());
 	}
 
-	const vector<vector<XMFLOAT4>>& Mesh::VertexColors() const
+	span<const XMFLOAT3> Mesh::BiNormals() const
 	{
-		return mData.VertexColors;
+		return (mStreams.IsEmpty() ? span<const XMFLOAT3>(mData.BiNormals) : mStreams.BiNormals());
+	}
+
+	uint32_t Mesh::TextureCoordinateChannelCount() const
+	{
+		return (mStreams.IsEmpty() ? narrow_cast<uint32_t>(mData.TextureCoordinates.size()) : mStreams.TextureCoordinateChannelCount());
+	}
+
+	span<const XMFLOAT3> Mesh::TextureCoordinates(uint32_t channel) const
+	{
+		if (mStreams.IsEmpty())
+		{
+			return (channel < mData.TextureCoordinates.size() ? span<const XMFLOAT3>(mData.TextureCoordinates[channel]) : span<const XMFLOAT3>());
+		}
+
+		return mStreams.TextureCoordinates(channel);
+	}
+
+	uint32_t Mesh::VertexColorChannelCount() const
+	{
+		return (mStreams.IsEmpty() ? narrow_cast<uint32_t>(mData.VertexColors.size()) : mStreams.VertexColorChannelCount());
+	}
+
+	span<const XMFLOAT4> Mesh::VertexColors(uint32_t channel) const
+	{
+		if (mStreams.IsEmpty())
+		{
+			return (channel < mData.VertexColors.size() ? span<const XMFLOAT4>(mData.VertexColors[channel]) : span<const XMFLOAT4>());
+		}
+
+		return mStreams.VertexColors(channel);
+	}
+
+	const MeshStreams& Mesh::Streams() const
+	{
+		return mStreams;
 	}
 
 	uint32_t Mesh::FaceCount() const
@@ -77,59 +272,198 @@ namespace Library
 		return mData.Indices;
 	}
 
-	void Mesh::CreateIndexBuffer(ID3D11Device& device, gsl::not_null<ID3D11Buffer**> indexBuffer)
+	vector<MeshLod> Mesh::Lods() const
+	{
+		// Meshes without a LOD chain present their whole index list as the only level.
+		if (mData.Lods.empty())
+		{
+			return vector<MeshLod>{ MeshLod{ 0, narrow_cast<uint32_t>(mData.Indices.size()), 0.0f } };
+		}
+
+		return mData.Lods;
+	}
+
+	uint32_t Mesh::TriangleCount(uint32_t lodIndex) const
 	{
-		D3D11_BUFFER_DESC indexBufferDesc{ 0 };
-		indexBufferDesc.ByteWidth = narrow_cast<uint32_t>(sizeof(uint32_t) * mData.Indices.size());
-		indexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-		indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+		if (mData.Lods.empty())
+		{
+			assert(lodIndex == 0);
+			return narrow_cast<uint32_t>(mData.Indices.size() / 3);
+		}
+
+		return mData.Lods.at(lodIndex).IndexCount / 3;
+	}
 
-		D3D11_SUBRESOURCE_DATA indexSubResourceData{ 0 };
-		indexSubResourceData.pSysMem = &mData.Indices[0];
+	const MeshBounds& Mesh::Bounds() const
+	{
+		return mData.Bounds;
+	}
 
-		ThrowIfFailed(device.CreateBuffer(&indexBufferDesc, &indexSubResourceData, indexBuffer), "ID3D11Device::CreateBuffer() failed.");
+	const vector<Meshlet>& Mesh::Meshlets() const
+	{
+		return mData.Meshlets;
 	}
 
-	void Mesh::Save(OutputStreamHelper& streamHelper) const
+	DXGI_FORMAT Mesh::IndexFormat() const
 	{
+		// Every index must be addressable with 16 bits; triangle lists have no strip-cut value to reserve.
+		return (VertexCount() <= uint32_t(numeric_limits<uint16_t>::max()) + 1 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT);
+	}
+
+	vector<uint16_t> Mesh::ShortIndices() const
+	{
+		assert(IndexFormat() == DXGI_FORMAT_R16_UINT);
+
+		vector<uint16_t> indices;
+		indices.reserve(mData.Indices.size());
+		transform(mData.Indices.begin(), mData.Indices.end(), back_inserter(indices), [](uint32_t index)
+		{
+			return narrow_cast<uint16_t>(index);
+		});
+
+		return indices;
+	}
+
+	MeshData& Mesh::Data()
+	{
+		if (!mStreams.IsEmpty())
+		{
+			mStreams.Unpack(mData);
+			mStreams.Clear();
+		}
+
+		// The caller may edit the mesh, so anything cached against its old contents must not be found again
+		mId = UniqueId();
+
+		return mData;
+	}
+
+	void Mesh::CreateIndexBuffer(ID3D11Device& device, gsl::not_null<ID3D11Buffer**> indexBuffer) const
+	{
+		if (IndexFormat() == DXGI_FORMAT_R16_UINT)
+		{
+			const vector<uint16_t> indices = ShortIndices();
+			Library::CreateIndexBuffer(&device, span<const uint16_t>(indices), indexBuffer);
+		}
+		else
+		{
+			Library::CreateIndexBuffer(&device, span<const uint32_t>(mData.Indices), indexBuffer);
+		}
+	}
+
+	void Mesh::Save(OutputStreamHelper& streamHelper, MeshEncoding encoding) const
+	{
+		// Interleaved vertices keep no per-stream arrays to write, and the file would hold indices into vertices it doesn't have
+		if (mStreams.Layout().VertexFormat != nullptr)
+		{
+			throw GameException("A mesh loaded into an interleaved vertex layout cannot be saved until Data() unpacks its streams.");
+		}
+
 		string materialName = (mData.Material != nullptr ? mData.Material->Name() : "");
 		streamHelper << materialName;
 
 		// Serialize name
 		streamHelper << mData.Name;
 
+		// Serialize vertex streams
+		streamHelper << static_cast<uint32_t>(encoding);
+		if (encoding == MeshEncoding::Compressed)
+		{
+			SaveCompressedStreams(streamHelper);
+		}
+		else
+		{
+			SaveStreams(streamHelper);
+		}
+
+		// Serialize indices, compressed or at the narrowest width that addresses every vertex
+		streamHelper << mData.FaceCount;
+		if (encoding == MeshEncoding::Compressed)
+		{
+			streamHelper << narrow_cast<uint32_t>(mData.Indices.size());
+			WriteEncoded(streamHelper, MeshCodec::EncodeIndices(mData.Indices));
+		}
+		else
+		{
+			const bool use16BitIndices = (IndexFormat() == DXGI_FORMAT_R16_UINT);
+			streamHelper << IndexFormatSize(IndexFormat());
+			streamHelper << narrow_cast<uint32_t>(mData.Indices.size());
+			for (const uint32_t& index : mData.Indices)
+			{
+				if (use16BitIndices)
+				{
+					streamHelper << narrow_cast<uint16_t>(index);
+				}
+				else
+				{
+					streamHelper << index;
+				}
+			}
+		}
+
+		// Serialize levels of detail
+		streamHelper << narrow_cast<uint32_t>(mData.Lods.size());
+		for (const MeshLod& lod : mData.Lods)
+		{
+			streamHelper << lod.StartIndex << lod.IndexCount << lod.Error;
+		}
+
+		// Serialize meshlets
+		streamHelper << narrow_cast<uint32_t>(mData.Meshlets.size());
+		for (const Meshlet& meshlet : mData.Meshlets)
+		{
+			streamHelper << meshlet.StartIndex << meshlet.IndexCount << meshlet.VertexCount;
+			streamHelper << meshlet.Center.x << meshlet.Center.y << meshlet.Center.z << meshlet.Radius;
+			streamHelper << meshlet.ConeAxis.x << meshlet.ConeAxis.y << meshlet.ConeAxis.z << meshlet.ConeCutoff;
+		}
+
+		// Serialize bounds, computed from the vertices being written whenever they are at hand
+		const auto vertices = Vertices();
+		const MeshBounds bounds = (vertices.empty() ? mData.Bounds : MeshBounds::FromPositions(vertices));
+		streamHelper << bounds.Minimum.x << bounds.Minimum.y << bounds.Minimum.z;
+		streamHelper << bounds.Maximum.x << bounds.Maximum.y << bounds.Maximum.z;
+		streamHelper << bounds.Center.x << bounds.Center.y << bounds.Center.z << bounds.Radius;
+	}
+
+	void Mesh::SaveStreams(OutputStreamHelper& streamHelper) const
+	{
 		// Serialize vertices
-		streamHelper << narrow_cast<uint32_t>(mData.Vertices.size());
-		for (const XMFLOAT3& vertex : mData.Vertices)
+		const auto vertices = Vertices();
+		streamHelper << narrow_cast<uint32_t>(vertices.size());
+		for (const XMFLOAT3& vertex : vertices)
 		{
 			streamHelper << vertex.x << vertex.y << vertex.z;
 		}
 
 		// Serialize normals
-		streamHelper << narrow_cast<uint32_t>(mData.Normals.size());
-		for (const XMFLOAT3& normal : mData.Normals)
+		const auto normals = Normals();
+		streamHelper << narrow_cast<uint32_t>(normals.size());
+		for (const XMFLOAT3& normal : normals)
 		{
 			streamHelper << normal.x << normal.y << normal.z;
 		}
 
 		// Serialize tangents
-		streamHelper << narrow_cast<uint32_t>(mData.Tangents.size());
-		for (const XMFLOAT3& tangents : mData.Tangents)
+		const auto tangents = Tangents();
+		streamHelper << narrow_cast<uint32_t>(tangents.size());
+		for (const XMFLOAT3& tangent : tangents)
 		{
-			streamHelper << tangents.x << tangents.y << tangents.z;
+			streamHelper << tangent.x << tangent.y << tangent.z;
 		}
 
 		// Serialize binormals
-		streamHelper << narrow_cast<uint32_t>(mData.BiNormals.size());
-		for (const XMFLOAT3& binormal : mData.BiNormals)
+		const auto binormals = BiNormals();
+		streamHelper << narrow_cast<uint32_t>(binormals.size());
+		for (const XMFLOAT3& binormal : binormals)
 		{
 			streamHelper << binormal.x << binormal.y << binormal.z;
 		}
 
 		// Serialize texture coordinates
-		streamHelper << narrow_cast<uint32_t>(mData.TextureCoordinates.size());
-		for (const auto& uvList : mData.TextureCoordinates)
+		streamHelper << TextureCoordinateChannelCount();
+		for (uint32_t channel = 0; channel < TextureCoordinateChannelCount(); ++channel)
 		{
+			const auto uvList = TextureCoordinates(channel);
 			streamHelper << narrow_cast<uint32_t>(uvList.size());
 			for (const XMFLOAT3& uv : uvList)
 			{
@@ -138,26 +472,53 @@ namespace Library
 		}
 
 		// Serialize vertex colors
-		streamHelper << narrow_cast<uint32_t>(mData.VertexColors.size());
-		for (const auto& vertexColorList : mData.VertexColors)
+		streamHelper << VertexColorChannelCount();
+		for (uint32_t channel = 0; channel < VertexColorChannelCount(); ++channel)
 		{
-			streamHelper << vertexColorList.size();
+			const auto vertexColorList = VertexColors(channel);
+			streamHelper << narrow_cast<uint32_t>(vertexColorList.size());
 			for (const XMFLOAT4& vertexColor : vertexColorList)
 			{
 				streamHelper << vertexColor.x << vertexColor.y << vertexColor.z << vertexColor.w;
 			}
 		}
+	}
 
-		// Serialize indices
-		streamHelper << mData.FaceCount;
-		streamHelper << narrow_cast<uint32_t>(mData.Indices.size());
-		for (const uint32_t& index : mData.Indices)
+	void Mesh::SaveCompressedStreams(OutputStreamHelper& streamHelper) const
+	{
+		vector<EncodedStream> streams;
+		auto encodeStream = [&streams](MeshStreamSemantic semantic, uint32_t channel, auto elements)
 		{
-			streamHelper << index;
+			if (!elements.empty())
+			{
+				using Element = typename decltype(elements)::element_type;
+				streams.push_back({ semantic, channel, sizeof(Element) / sizeof(float), narrow_cast<uint32_t>(elements.size()), MeshCodec::EncodeVertices(reinterpret_cast<const byte*>(elements.data()), sizeof(Element), elements.size()) });
+			}
+		};
+
+		encodeStream(MeshStreamSemantic::Position, 0, Vertices());
+		encodeStream(MeshStreamSemantic::Normal, 0, Normals());
+		encodeStream(MeshStreamSemantic::Tangent, 0, Tangents());
+		encodeStream(MeshStreamSemantic::BiNormal, 0, BiNormals());
+		for (uint32_t channel = 0; channel < TextureCoordinateChannelCount(); ++channel)
+		{
+			encodeStream(MeshStreamSemantic::TextureCoordinate, channel, TextureCoordinates(channel));
+		}
+
+		for (uint32_t channel = 0; channel < VertexColorChannelCount(); ++channel)
+		{
+			encodeStream(MeshStreamSemantic::Color, channel, VertexColors(channel));
+		}
+
+		streamHelper << narrow_cast<uint32_t>(Vertices().size()) << narrow_cast<uint32_t>(streams.size());
+		for (const EncodedStream& stream : streams)
+		{
+			streamHelper << static_cast<uint32_t>(stream.Semantic) << stream.Channel << stream.ComponentCount << stream.ElementCount;
+			WriteEncoded(streamHelper, stream.Data);
 		}
 	}
 
-	void Mesh::Load(InputStreamHelper& streamHelper)
+	void Mesh::Load(InputStreamHelper& streamHelper, uint32_t fileVersion, const InterleavedVertexLayout* interleavedLayout, pmr::memory_resource* streamResource)
 	{
 		// Deserialize material reference
 		{
@@ -177,6 +538,155 @@ namespace Library
 		// Deserialize name
 		streamHelper >> mData.Name;
 
+		// Deserialize vertex streams
+		MeshEncoding encoding = MeshEncoding::Raw;
+		if (fileVersion >= 6)
+		{
+			uint32_t encodingValue;
+			streamHelper >> encodingValue;
+			encoding = static_cast<MeshEncoding>(encodingValue);
+			if (encoding != MeshEncoding::Raw && encoding != MeshEncoding::Compressed)
+			{
+				throw GameException("Unsupported mesh encoding.");
+			}
+		}
+
+		if (encoding == MeshEncoding::Compressed)
+		{
+			LoadCompressedStreams(streamHelper, interleavedLayout, streamResource);
+		}
+		else if (interleavedLayout != nullptr)
+		{
+			LoadInterleavedStreams(streamHelper, *interleavedLayout, streamResource);
+		}
+		else
+		{
+			LoadStreams(streamHelper);
+		}
+
+		// Deserialize indexes
+		{
+			streamHelper >> mData.FaceCount;
+			if (encoding == MeshEncoding::Compressed)
+			{
+				uint32_t indexCount;
+				uint32_t encodedSize;
+				streamHelper >> indexCount >> encodedSize;
+				vector<uint8_t> encoded;
+				ReadEncoded(streamHelper, encodedSize, encoded);
+				mData.Indices.resize(indexCount);
+				MeshCodec::DecodeIndices(encoded, mData.Indices);
+			}
+			else
+			{
+				uint32_t indexSize = sizeof(uint32_t);
+				if (fileVersion >= 2)
+				{
+					streamHelper >> indexSize;
+					if (indexSize != sizeof(uint16_t) && indexSize != sizeof(uint32_t))
+					{
+						throw GameException("Unsupported index size.");
+					}
+				}
+
+				uint32_t indexCount;
+				streamHelper >> indexCount;
+				mData.Indices.reserve(indexCount);
+				for (uint32_t i = 0; i < indexCount; i++)
+				{
+					if (indexSize == sizeof(uint16_t))
+					{
+						uint16_t index;
+						streamHelper >> index;
+						mData.Indices.push_back(index);
+					}
+					else
+					{
+						uint32_t index;
+						streamHelper >> index;
+						mData.Indices.push_back(index);
+					}
+				}
+			}
+		}
+
+		// Deserialize levels of detail
+		if (fileVersion >= 3)
+		{
+			uint32_t lodCount;
+			streamHelper >> lodCount;
+			mData.Lods.reserve(lodCount);
+			for (uint32_t i = 0; i < lodCount; i++)
+			{
+				MeshLod lod;
+				streamHelper >> lod.StartIndex >> lod.IndexCount >> lod.Error;
+				if (uint64_t(lod.StartIndex) + lod.IndexCount > mData.Indices.size())
+				{
+					throw GameException("Mesh level of detail is out of range.");
+				}
+
+				mData.Lods.push_back(lod);
+			}
+		}
+
+		// Deserialize meshlets
+		if (fileVersion >= 4)
+		{
+			uint32_t meshletCount;
+			streamHelper >> meshletCount;
+			mData.Meshlets.reserve(meshletCount);
+			for (uint32_t i = 0; i < meshletCount; i++)
+			{
+				Meshlet meshlet;
+				streamHelper >> meshlet.StartIndex >> meshlet.IndexCount >> meshlet.VertexCount;
+				streamHelper >> meshlet.Center.x >> meshlet.Center.y >> meshlet.Center.z >> meshlet.Radius;
+				streamHelper >> meshlet.ConeAxis.x >> meshlet.ConeAxis.y >> meshlet.ConeAxis.z >> meshlet.ConeCutoff;
+				if (uint64_t(meshlet.StartIndex) + meshlet.IndexCount > mData.Indices.size())
+				{
+					throw GameException("Meshlet is out of range.");
+				}
+
+				mData.Meshlets.push_back(meshlet);
+			}
+		}
+
+		// Deserialize bounds
+		if (fileVersion >= 5)
+		{
+			MeshBounds& bounds = mData.Bounds;
+			streamHelper >> bounds.Minimum.x >> bounds.Minimum.y >> bounds.Minimum.z;
+			streamHelper >> bounds.Maximum.x >> bounds.Maximum.y >> bounds.Maximum.z;
+			streamHelper >> bounds.Center.x >> bounds.Center.y >> bounds.Center.z >> bounds.Radius;
+		}
+		else
+		{
+			ComputeBounds();
+		}
+	}
+
+	void Mesh::ComputeBounds()
+	{
+		const InterleavedVertexLayout& layout = mStreams.Layout();
+		if (layout.VertexFormat == nullptr)
+		{
+			mData.Bounds = MeshBounds::FromPositions(Vertices());
+			return;
+		}
+
+		const auto position = find_if(layout.Bindings.begin(), layout.Bindings.end(), [](const VertexStreamBinding& binding)
+		{
+			return binding.Semantic == MeshStreamSemantic::Position;
+		});
+
+		if (position != layout.Bindings.end())
+		{
+			const span<const byte> vertices = mStreams.InterleavedVertices(layout.VertexFormat);
+			mData.Bounds = MeshBounds::FromPositions(vertices.data() + position->Offset, layout.VertexSize, mStreams.VertexCount());
+		}
+	}
+
+	void Mesh::LoadStreams(InputStreamHelper& streamHelper)
+	{
 		// Deserialize vertices
 		{
 			uint32_t vertexCount;
@@ -278,19 +788,308 @@ namespace Library
 				}
 			}
 		}
+	}
+
+	void Mesh::LoadInterleavedStreams(InputStreamHelper& streamHelper, const InterleavedVertexLayout& layout, pmr::memory_resource* streamResource)
+	{
+		assert(layout.Bindings.size() <= 32);
+
+		uint32_t vertexCount;
+		streamHelper >> vertexCount;
+		MeshStreams streams(layout, vertexCount, streamResource);
+		const span<byte> vertices = streams.InterleavedVertices();
+		istream& stream = streamHelper.Stream();
+		uint32_t boundStreams = 0;
 
-		// Deserialize indexes	
+		// Each bound element is read straight into its place in the vertex; streams the declaration does not use are skipped.
+		auto readStream = [&](MeshStreamSemantic semantic, uint32_t channel, uint32_t elementCount, uint32_t componentCount)
 		{
-			streamHelper >> mData.FaceCount;
-			uint32_t indexCount;
-			streamHelper >> indexCount;
-			mData.Indices.reserve(indexCount);
-			for (uint32_t i = 0; i < indexCount; i++)
+			const auto binding = find_if(layout.Bindings.begin(), layout.Bindings.end(), [semantic, channel](const VertexStreamBinding& candidate)
+			{
+				return (candidate.Semantic == semantic && candidate.Channel == channel);
+			});
+
+			if (binding == layout.Bindings.end() || elementCount == 0)
+			{
+				stream.ignore(streamsize(sizeof(float)) * elementCount * componentCount);
+				return;
+			}
+
+			if (elementCount != vertexCount)
+			{
+				throw GameException("Mesh stream does not match the mesh's vertex count.");
+			}
+
+			float element[4]{ 0.0f, 0.0f, 0.0f, 1.0f };
+			const size_t writeSize = sizeof(float) * binding->ComponentCount;
+			byte* destination = vertices.data() + binding->Offset;
+			for (uint32_t i = 0; i < elementCount; ++i, destination += layout.VertexSize)
+			{
+				stream.read(reinterpret_cast<char*>(element), streamsize(sizeof(float)) * componentCount);
+				memcpy(destination, element, writeSize);
+			}
+
+			boundStreams |= (1U << (binding - layout.Bindings.begin()));
+		};
+
+		readStream(MeshStreamSemantic::Position, 0, vertexCount, 3);
+
+		uint32_t elementCount;
+		streamHelper >> elementCount;
+		readStream(MeshStreamSemantic::Normal, 0, elementCount, 3);
+		streamHelper >> elementCount;
+		readStream(MeshStreamSemantic::Tangent, 0, elementCount, 3);
+		streamHelper >> elementCount;
+		readStream(MeshStreamSemantic::BiNormal, 0, elementCount, 3);
+
+		// Empty channels are dropped here as well, so channel numbers match the per-stream path.
+		uint32_t channelCount;
+		streamHelper >> channelCount;
+		for (uint32_t i = 0, channel = 0; i < channelCount; i++)
+		{
+			streamHelper >> elementCount;
+			if (elementCount > 0)
+			{
+				readStream(MeshStreamSemantic::TextureCoordinate, channel++, elementCount, 3);
+			}
+		}
+
+		streamHelper >> channelCount;
+		for (uint32_t i = 0, channel = 0; i < channelCount; i++)
+		{
+			streamHelper >> elementCount;
+			if (elementCount > 0)
+			{
+				readStream(MeshStreamSemantic::Color, channel++, elementCount, 4);
+			}
+		}
+
+		if (vertexCount > 0 && boundStreams != (1ULL << layout.Bindings.size()) - 1)
+		{
+			throw GameException("Mesh is missing a stream required by the vertex declaration.");
+		}
+
+		mStreams = move(streams);
+	}
+
+	void Mesh::LoadCompressedStreams(InputStreamHelper& streamHelper, const InterleavedVertexLayout* interleavedLayout, pmr::memory_resource* streamResource)
+	{
+		assert(interleavedLayout == nullptr || interleavedLayout->Bindings.size() <= 32);
+
+		uint32_t vertexCount;
+		uint32_t streamCount;
+		streamHelper >> vertexCount >> streamCount;
+		MeshStreams streams = (interleavedLayout != nullptr ? MeshStreams(*interleavedLayout, vertexCount, streamResource) : MeshStreams());
+		vector<uint8_t> encoded;
+		uint32_t boundStreams = 0;
+
+		for (uint32_t i = 0; i < streamCount; ++i)
+		{
+			uint32_t semanticValue;
+			uint32_t channel;
+			uint32_t componentCount;
+			uint32_t elementCount;
+			uint32_t encodedSize;
+			streamHelper >> semanticValue >> channel >> componentCount >> elementCount >> encodedSize;
+			const auto semantic = static_cast<MeshStreamSemantic>(semanticValue);
+			if (semantic >= MeshStreamSemantic::Interleaved || componentCount != (semantic == MeshStreamSemantic::Color ? 4U : 3U))
 			{
-				uint32_t index;
-				streamHelper >> index;
-				mData.Indices.push_back(index);
+				throw GameException("Compressed mesh data is corrupt.");
 			}
+
+			const size_t elementSize = sizeof(float) * componentCount;
+			if (interleavedLayout == nullptr)
+			{
+				// Each stream decodes into its MeshData vector, which the constructor then packs
+				ReadEncoded(streamHelper, encodedSize, encoded);
+				auto decodeStream = [&](auto& elements)
+				{
+					elements.resize(elementCount);
+					MeshCodec::DecodeVertices(encoded, elementSize, elementCount, reinterpret_cast<byte*>(elements.data()), elementSize, elementSize);
+				};
+
+				switch (semantic)
+				{
+				case MeshStreamSemantic::Position:
+					decodeStream(mData.Vertices);
+					break;
+
+				case MeshStreamSemantic::Normal:
+					decodeStream(mData.Normals);
+					break;
+
+				case MeshStreamSemantic::Tangent:
+					decodeStream(mData.Tangents);
+					break;
+
+				case MeshStreamSemantic::BiNormal:
+					decodeStream(mData.BiNormals);
+					break;
+
+				case MeshStreamSemantic::TextureCoordinate:
+					decodeStream(mData.TextureCoordinates.emplace_back());
+					break;
+
+				default:
+					decodeStream(mData.VertexColors.emplace_back());
+					break;
+				}
+
+				continue;
+			}
+
+			// Bound streams decode straight into their place in the vertex, as LoadInterleavedStreams reads them
+			const InterleavedVertexLayout& layout = *interleavedLayout;
+			const auto binding = find_if(layout.Bindings.begin(), layout.Bindings.end(), [semantic, channel](const VertexStreamBinding& candidate)
+			{
+				return (candidate.Semantic == semantic && candidate.Channel == channel);
+			});
+
+			if (binding == layout.Bindings.end() || elementCount == 0)
+			{
+				streamHelper.Stream().ignore(encodedSize);
+				continue;
+			}
+
+			if (elementCount != vertexCount)
+			{
+				throw GameException("Mesh stream does not match the mesh's vertex count.");
+			}
+
+			ReadEncoded(streamHelper, encodedSize, encoded);
+			const span<byte> vertices = streams.InterleavedVertices();
+			byte* destination = vertices.data() + binding->Offset;
+			MeshCodec::DecodeVertices(encoded, elementSize, elementCount, destination, layout.VertexSize, sizeof(float) * min(componentCount, binding->ComponentCount));
+			if (binding->ComponentCount == 4 && componentCount < 4)
+			{
+				const float w = 1.0f;
+				for (uint32_t j = 0; j < vertexCount; ++j)
+				{
+					memcpy(destination + size_t(j) * layout.VertexSize + sizeof(float) * 3, &w, sizeof(w));
+				}
+			}
+
+			boundStreams |= (1U << (binding - layout.Bindings.begin()));
 		}
+
+		if (interleavedLayout != nullptr)
+		{
+			if (vertexCount > 0 && boundStreams != (1ULL << interleavedLayout->Bindings.size()) - 1)
+			{
+				throw GameException("Mesh is missing a stream required by the vertex declaration.");
+			}
+
+			mStreams = move(streams);
+		}
+	}
+
+	uint32_t MeshLod::Select(const vector<MeshLod>& lods, float pixelsPerUnit, float maxPixelError)
+	{
+		// Levels are ordered finest first with non-decreasing error, so the last one within budget is the coarsest acceptable.
+		uint32_t selectedLod = 0;
+		for (uint32_t i = 1; i < lods.size(); ++i)
+		{
+			if (lods[i].Error * pixelsPerUnit > maxPixelError)
+			{
+				break;
+			}
+
+			selectedLod = i;
+		}
+
+		return selectedLod;
+	}
+
+	float MeshLod::PixelsPerUnit(float distance, float verticalFieldOfView, float viewportHeight)
+	{
+		// Inside the near field every level would be too coarse; report an unbounded projection so level 0 is chosen.
+		if (distance <= numeric_limits<float>::epsilon())
+		{
+			return numeric_limits<float>::max();
+		}
+
+		return viewportHeight / (2.0f * tan(verticalFieldOfView * 0.5f) * distance);
+	}
+
+	void Meshlet::ComputeBounds(const MeshData& meshData)
+	{
+		const span<const uint32_t> indices = span<const uint32_t>(meshData.Indices).subspan(StartIndex, IndexCount);
+		if (indices.empty())
+		{
+			return;
+		}
+
+		XMVECTOR minimum = XMLoadFloat3(&meshData.Vertices[indices[0]]);
+		XMVECTOR maximum = minimum;
+		for (uint32_t index : indices)
+		{
+			const XMVECTOR position = XMLoadFloat3(&meshData.Vertices[index]);
+			minimum = XMVectorMin(minimum, position);
+			maximum = XMVectorMax(maximum, position);
+		}
+
+		const XMVECTOR center = XMVectorScale(XMVectorAdd(minimum, maximum), 0.5f);
+		Radius = 0.0f;
+		for (uint32_t index : indices)
+		{
+			Radius = max(Radius, XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&meshData.Vertices[index]), center))));
+		}
+
+		XMStoreFloat3(&Center, center);
+
+		// Without authored normals the front side is unknown, so the cone is left disabled.
+		ConeAxis = XMFLOAT3(0.0f, 0.0f, 0.0f);
+		ConeCutoff = 1.0f;
+		if (meshData.Normals.size() != meshData.Vertices.size())
+		{
+			return;
+		}
+
+		// Winding conventions vary between sources, so the vertex normals decide which side of each triangle is the front.
+		vector<XMVECTOR> triangleNormals;
+		triangleNormals.reserve(indices.size() / 3);
+		XMVECTOR axis = XMVectorZero();
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			const XMVECTOR p0 = XMLoadFloat3(&meshData.Vertices[indices[i]]);
+			const XMVECTOR p1 = XMLoadFloat3(&meshData.Vertices[indices[i + 1]]);
+			const XMVECTOR p2 = XMLoadFloat3(&meshData.Vertices[indices[i + 2]]);
+			XMVECTOR normal = XMVector3Cross(XMVectorSubtract(p1, p0), XMVectorSubtract(p2, p0));
+
+			const XMVECTOR vertexNormals = XMVectorAdd(XMLoadFloat3(&meshData.Normals[indices[i]]), XMVectorAdd(XMLoadFloat3(&meshData.Normals[indices[i + 1]]), XMLoadFloat3(&meshData.Normals[indices[i + 2]])));
+			if (XMVectorGetX(XMVector3Dot(normal, vertexNormals)) < 0.0f)
+			{
+				normal = XMVectorNegate(normal);
+			}
+
+			// Degenerate triangles have no normal and cannot be seen from either side.
+			if (XMVectorGetX(XMVector3LengthSq(normal)) > 0.0f)
+			{
+				normal = XMVector3Normalize(normal);
+				triangleNormals.push_back(normal);
+				axis = XMVectorAdd(axis, normal);
+			}
+		}
+
+		if (XMVectorGetX(XMVector3LengthSq(axis)) <= numeric_limits<float>::epsilon())
+		{
+			return;
+		}
+
+		axis = XMVector3Normalize(axis);
+		float minimumDot = 1.0f;
+		for (const XMVECTOR& normal : triangleNormals)
+		{
+			minimumDot = min(minimumDot, XMVectorGetX(XMVector3Dot(axis, normal)));
+		}
+
+		// Normals spread over (nearly) a hemisphere leave some triangle facing every viewpoint.
+		if (minimumDot <= 0.1f)
+		{
+			return;
+		}
+
+		XMStoreFloat3(&ConeAxis, axis);
+		ConeCutoff = sqrt(1.0f - minimumDot * minimumDot);
 	}
 }
\ No newline at end of file
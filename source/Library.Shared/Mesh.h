@@ -2,6 +2,8 @@
 
 #include <gsl\gsl>
 #include <d3d11.h>
+#include "MeshStreams.h"
+#include "MeshCodec.h"
 
 namespace Library
 {
@@ -10,6 +12,55 @@ namespace Library
     class ModelMaterial;
 	class OutputStreamHelper;
 	class InputStreamHelper;
+	struct MeshData;
+
+	struct MeshLod final
+	{
+		std::uint32_t StartIndex{ 0 }; // Relative to the mesh's first index
+		std::uint32_t IndexCount{ 0 };
+		float Error{ 0.0f }; // Geometric deviation from the full-detail mesh, in object space units
+
+		static std::uint32_t Select(const std::vector<MeshLod>& lods, float pixelsPerUnit, float maxPixelError = DefaultMaxPixelError);
+		static float PixelsPerUnit(float distance, float verticalFieldOfView, float viewportHeight);
+
+		inline static const float DefaultMaxPixelError{ 1.0f };
+	};
+
+	/// <summary>
+	/// A cluster of the full-detail level's triangles, stored contiguously in the index list, with bounds for culling.
+	/// The normal cone rejects the cluster when the camera sees only the back of its triangles.
+	/// </summary>
+	struct Meshlet final
+	{
+		std::uint32_t StartIndex{ 0 };
+		std::uint32_t IndexCount{ 0 };
+		std::uint32_t VertexCount{ 0 };
+		DirectX::XMFLOAT3 Center{ 0.0f, 0.0f, 0.0f };
+		float Radius{ 0.0f };
+		DirectX::XMFLOAT3 ConeAxis{ 0.0f, 0.0f, 0.0f };
+		float ConeCutoff{ 1.0f }; // Sine of the widest normal's angle from the axis; 1 never culls
+
+		void ComputeBounds(const MeshData& meshData);
+
+		inline static const std::uint32_t MaxVertexCount{ 64 };
+		inline static const std::uint32_t MaxTriangleCount{ 124 };
+	};
+
+	/// <summary>
+	/// Object-space bounds of a mesh's vertices, written with the model so loading needs no pass over the vertices.
+	/// </summary>
+	struct MeshBounds final
+	{
+		DirectX::XMFLOAT3 Minimum{ 0.0f, 0.0f, 0.0f };
+		DirectX::XMFLOAT3 Maximum{ 0.0f, 0.0f, 0.0f };
+		DirectX::XMFLOAT3 Center{ 0.0f, 0.0f, 0.0f }; // Of the bounding sphere, which need not be the box's center
+		float Radius{ 0.0f };
+
+		void Merge(const MeshBounds& other);
+
+		static MeshBounds FromPositions(gsl::span<const DirectX::XMFLOAT3> positions);
+		static MeshBounds FromPositions(const std::byte* firstPosition, std::size_t stride, std::size_t count);
+	};
 
 	struct MeshData final
 	{
@@ -23,13 +74,16 @@ namespace Library
 		std::vector<std::vector<DirectX::XMFLOAT4>> VertexColors;
 		std::uint32_t FaceCount{ 0 };
 		std::vector<std::uint32_t> Indices;
+		std::vector<MeshLod> Lods; // Index ranges over the shared vertices, finest first; empty when the mesh has a single level
+		std::vector<Meshlet> Meshlets; // Partition of the full-detail level; empty when the mesh was not clustered
+		MeshBounds Bounds;
 	};
 
     class Mesh final
     {
     public:
-		Mesh(Library::Model& model, InputStreamHelper& streamHelper);
-		Mesh(Library::Model& model, MeshData&& meshData);
+		Mesh(Library::Model& model, InputStreamHelper& streamHelper, std::uint32_t fileVersion, const InterleavedVertexLayout* interleavedLayout = nullptr, std::pmr::memory_resource* streamResource = std::pmr::get_default_resource());
+		Mesh(Library::Model& model, MeshData&& meshData, std::pmr::memory_resource* streamResource = std::pmr::get_default_resource());
 		Mesh(const Mesh&) = default;
 		Mesh(Mesh&&) = default;
 		Mesh& operator=(const Mesh&) = default;
@@ -39,23 +93,53 @@ namespace Library
 		Library::Model& GetModel();
         std::shared_ptr<ModelMaterial> GetMaterial();
         const std::string& Name() const;
+		std::uint64_t Id() const; // Never reused, so it identifies this mesh's contents where its address may not; copies, assignments and Data() draw a new one
 
-		const std::vector<DirectX::XMFLOAT3>& Vertices() const;
-		const std::vector<DirectX::XMFLOAT3>& Normals() const;
-		const std::vector<DirectX::XMFLOAT3>& Tangents() const;
-		const std::vector<DirectX::XMFLOAT3>& BiNormals() const;
-		const std::vector<std::vector<DirectX::XMFLOAT3>>& TextureCoordinates() const;
-		const std::vector<std::vector<DirectX::XMFLOAT4>>& VertexColors() const;
+		std::uint32_t VertexCount() const;
+		gsl::span<const DirectX::XMFLOAT3> Vertices() const; // Empty, like the other streams, when the mesh was loaded interleaved
+		gsl::span<const DirectX::XMFLOAT3> Normals() const;
+		gsl::span<const DirectX::XMFLOAT3> Tangents() const;
+		gsl::span<const DirectX::XMFLOAT3> BiNormals() const;
+		std::uint32_t TextureCoordinateChannelCount() const;
+		gsl::span<const DirectX::XMFLOAT3> TextureCoordinates(std::uint32_t channel = 0) const;
+		std::uint32_t VertexColorChannelCount() const;
+		gsl::span<const DirectX::XMFLOAT4> VertexColors(std::uint32_t channel = 0) const;
+		const MeshStreams& Streams() const;
 		std::uint32_t FaceCount() const;
 		const std::vector<std::uint32_t>& Indices() const;
+		std::vector<MeshLod> Lods() const;
+		std::uint32_t TriangleCount(std::uint32_t lodIndex = 0) const;
+		const MeshBounds& Bounds() const;
+		const std::vector<Meshlet>& Meshlets() const;
+		DXGI_FORMAT IndexFormat() const;
+		std::vector<std::uint16_t> ShortIndices() const;
+		MeshData& Data(); // Unpacks the vertex streams into MeshData's vectors for editing
 
-        void CreateIndexBuffer(ID3D11Device& device, gsl::not_null<ID3D11Buffer**> indexBuffer);
-		void Save(OutputStreamHelper& streamHelper) const;
+        void CreateIndexBuffer(ID3D11Device& device, gsl::not_null<ID3D11Buffer**> indexBuffer) const;
+		void Save(OutputStreamHelper& streamHelper, MeshEncoding encoding = MeshEncoding::Raw) const; // Throws for a mesh still in an interleaved layout; Data() unpacks it
 
     private:
-		void Load(InputStreamHelper& streamHelper);
+		void Load(InputStreamHelper& streamHelper, std::uint32_t fileVersion, const InterleavedVertexLayout* interleavedLayout, std::pmr::memory_resource* streamResource);
+		void LoadStreams(InputStreamHelper& streamHelper);
+		void ComputeBounds();
+		void LoadInterleavedStreams(InputStreamHelper& streamHelper, const InterleavedVertexLayout& layout, std::pmr::memory_resource* streamResource);
+		void LoadCompressedStreams(InputStreamHelper& streamHelper, const InterleavedVertexLayout* interleavedLayout, std::pmr::memory_resource* streamResource);
+		void SaveStreams(OutputStreamHelper& streamHelper) const;
+		void SaveCompressedStreams(OutputStreamHelper& streamHelper) const;
+
+		struct UniqueId final
+		{
+			UniqueId() noexcept;
+			UniqueId(const UniqueId&) noexcept;
+			UniqueId& operator=(const UniqueId&) noexcept;
+			~UniqueId() = default;
+
+			std::uint64_t Value;
+		};
 
         gsl::not_null<Library::Model*> mModel;
-		MeshData mData;
+		MeshData mData; // Vertex stream vectors are empty while mStreams holds them
+		MeshStreams mStreams;
+		UniqueId mId;
     };
 }
\ No newline at end of file
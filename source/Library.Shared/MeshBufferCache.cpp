@@ -0,0 +1,168 @@
+#include "pch.h"
+#include "MeshBufferCache.h"
+#include "Mesh.h"
+#include "DirectXHelper.h"
+
+using namespace std;
+using namespace gsl;
+
+namespace Library
+{
+	namespace
+	{
+		template <typename Map>
+		void EraseExpired(Map& entries)
+		{
+			for (auto it = entries.begin(); it != entries.end();)
+			{
+				it = (it->second.expired() ? entries.erase(it) : next(it));
+			}
+		}
+	}
+
+	struct MeshBufferCache::IndexRange final
+	{
+		IndexRange(const shared_ptr<GeometryBufferPool>& pool, const GeometryIndexAllocation& allocation) :
+			Pool(pool), Allocation(allocation)
+		{
+		}
+
+		IndexRange(const IndexRange&) = delete;
+		IndexRange& operator=(const IndexRange&) = delete;
+
+		~IndexRange()
+		{
+			Pool->Free(Allocation);
+		}
+
+		shared_ptr<GeometryBufferPool> Pool; // Keeps the pages alive while any mesh still draws from them, past a Clear()
+		GeometryIndexAllocation Allocation;
+	};
+
+	struct MeshBufferCache::PooledMeshBuffers final
+	{
+		PooledMeshBuffers(const shared_ptr<GeometryBufferPool>& pool, const GeometryVertexAllocation& allocation) :
+			Pool(pool), VertexAllocation(allocation)
+		{
+		}
+
+		PooledMeshBuffers(const PooledMeshBuffers&) = delete;
+		PooledMeshBuffers& operator=(const PooledMeshBuffers&) = delete;
+
+		~PooledMeshBuffers()
+		{
+			Pool->Free(VertexAllocation);
+		}
+
+		MeshBuffers Buffers;
+		shared_ptr<GeometryBufferPool> Pool;
+		GeometryVertexAllocation VertexAllocation;
+		shared_ptr<const IndexRange> Indices;
+	};
+
+	MeshBufferCache::MeshBufferCache() :
+		mPool(make_shared<GeometryBufferPool>())
+	{
+	}
+
+	size_t MeshBufferCache::LiveEntryCount() const
+	{
+		return narrow_cast<size_t>(count_if(mEntries.begin(), mEntries.end(), [](const auto& entry)
+		{
+			return !entry.second.expired();
+		}));
+	}
+
+	GeometryBufferPoolStatistics MeshBufferCache::PoolStatistics() const
+	{
+		return mPool->Statistics();
+	}
+
+	void MeshBufferCache::Clear()
+	{
+		mEntries.clear();
+		mIndexRanges.clear();
+		mPool = make_shared<GeometryBufferPool>();
+		mHits = 0;
+		mMisses = 0;
+		mBytesUploaded = 0;
+		mBytesSaved = 0;
+	}
+
+	shared_ptr<const MeshBuffers> MeshBufferCache::Find(const Key& key)
+	{
+		auto it = mEntries.find(key);
+		if (it == mEntries.end())
+		{
+			return nullptr;
+		}
+
+		auto buffers = it->second.lock();
+		if (buffers == nullptr)
+		{
+			mEntries.erase(it);
+			return nullptr;
+		}
+
+		++mHits;
+		mBytesSaved += uint64_t(buffers->VertexSize) * buffers->VertexCount + uint64_t(IndexFormatSize(buffers->IndexFormat)) * buffers->IndexCount;
+
+		return buffers;
+	}
+
+	shared_ptr<const MeshBuffers> MeshBufferCache::Insert(const Key& key, not_null<ID3D11Device*> device, const Mesh& mesh, const GeometryVertexAllocation& vertexAllocation)
+	{
+		// Own the vertex range first so it is returned to the pool if the index upload throws.
+		auto pooledBuffers = make_shared<PooledMeshBuffers>(mPool, vertexAllocation);
+		++mMisses;
+		mBytesUploaded += uint64_t(vertexAllocation.VertexSize) * vertexAllocation.VertexCount;
+
+		// Mesh ids are never reused, so entries for released meshes are swept out on a miss instead of being overwritten.
+		EraseExpired(mEntries);
+		EraseExpired(mIndexRanges);
+
+		// Indices do not depend on the vertex declaration, so every declaration of a mesh shares one index range.
+		const DXGI_FORMAT indexFormat = mesh.IndexFormat();
+		const uint64_t indexBytes = uint64_t(IndexFormatSize(indexFormat)) * mesh.Indices().size();
+		auto& indexRange = mIndexRanges[mesh.Id()];
+		pooledBuffers->Indices = indexRange.lock();
+		if (pooledBuffers->Indices != nullptr)
+		{
+			mBytesSaved += indexBytes;
+		}
+		else
+		{
+			GeometryIndexAllocation indexAllocation;
+			if (indexFormat == DXGI_FORMAT_R16_UINT)
+			{
+				const vector<uint16_t> indices = mesh.ShortIndices();
+				indexAllocation = mPool->AllocateIndices(device, span<const uint16_t>(indices));
+			}
+			else
+			{
+				indexAllocation = mPool->AllocateIndices(device, span<const uint32_t>(mesh.Indices()));
+			}
+
+			pooledBuffers->Indices = make_shared<const IndexRange>(mPool, indexAllocation);
+			indexRange = pooledBuffers->Indices;
+			mBytesUploaded += indexBytes;
+		}
+
+		const GeometryIndexAllocation& indexAllocation = pooledBuffers->Indices->Allocation;
+		MeshBuffers& buffers = pooledBuffers->Buffers;
+		buffers.VertexBuffer = vertexAllocation.Buffer;
+		buffers.IndexBuffer = indexAllocation.Buffer;
+		buffers.VertexSize = vertexAllocation.VertexSize;
+		buffers.VertexCount = vertexAllocation.VertexCount;
+		buffers.Lods = mesh.Lods();
+		buffers.IndexCount = buffers.Lods.front().IndexCount;
+		buffers.IndexFormat = indexAllocation.IndexFormat;
+		buffers.StartIndexLocation = indexAllocation.StartIndexLocation;
+		buffers.BaseVertexLocation = vertexAllocation.BaseVertexLocation;
+
+		shared_ptr<const MeshBuffers> result(pooledBuffers, &pooledBuffers->Buffers);
+		mEntries[key] = result;
+
+		return result;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <d3d11.h>
+#include <gsl\gsl>
+#include "GeometryBufferPool.h"
+#include "Mesh.h"
+
+namespace Library
+{
+	struct MeshBuffers final
+	{
+		ID3D11Buffer* VertexBuffer{ nullptr };
+		ID3D11Buffer* IndexBuffer{ nullptr };
+		std::uint32_t VertexSize{ 0 };
+		std::uint32_t VertexCount{ 0 };
+		std::uint32_t IndexCount{ 0 }; // Full-detail level; coarser levels follow it in the same index range
+		DXGI_FORMAT IndexFormat{ DXGI_FORMAT_R32_UINT };
+		std::uint32_t StartIndexLocation{ 0 };
+		std::uint32_t BaseVertexLocation{ 0 };
+		std::vector<MeshLod> Lods; // Always holds at least the full-detail level
+	};
+
+	class MeshBufferCache final
+	{
+	public:
+		MeshBufferCache();
+		MeshBufferCache(const MeshBufferCache&) = delete;
+		MeshBufferCache& operator=(const MeshBufferCache&) = delete;
+		MeshBufferCache(MeshBufferCache&&) = default;
+		MeshBufferCache& operator=(MeshBufferCache&&) = default;
+		~MeshBufferCache() = default;
+
+		template <typename T>
+		std::shared_ptr<const MeshBuffers> Get(gsl::not_null<ID3D11Device*> device, const Mesh& mesh);
+
+		std::uint32_t Hits() const;
+		std::uint32_t Misses() const;
+		std::uint64_t BytesUploaded() const;
+		std::uint64_t BytesSaved() const;
+		std::size_t LiveEntryCount() const;
+		GeometryBufferPoolStatistics PoolStatistics() const;
+
+		void Clear(); // Buffers still held keep their pool pages alive until they are released
+
+	private:
+		struct IndexRange;
+		struct PooledMeshBuffers;
+		using Key = std::pair<std::uint64_t, const D3D11_INPUT_ELEMENT_DESC*>; // Mesh::Id(), since a destroyed mesh's address can be reused while its buffers are still held
+
+		std::shared_ptr<const MeshBuffers> Find(const Key& key);
+		std::shared_ptr<const MeshBuffers> Insert(const Key& key, gsl::not_null<ID3D11Device*> device, const Mesh& mesh, const GeometryVertexAllocation& vertexAllocation);
+
+		std::shared_ptr<GeometryBufferPool> mPool;
+		std::map<Key, std::weak_ptr<const MeshBuffers>> mEntries;
+		std::map<std::uint64_t, std::weak_ptr<const IndexRange>> mIndexRanges;
+		std::uint32_t mHits{ 0 };
+		std::uint32_t mMisses{ 0 };
+		std::uint64_t mBytesUploaded{ 0 };
+		std::uint64_t mBytesSaved{ 0 };
+	};
+}
+
+#include "MeshBufferCache.inl"
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+#include "MeshBufferCache.h"
+
+namespace Library
+{
+	template <typename T>
+	inline std::shared_ptr<const MeshBuffers> MeshBufferCache::Get(gsl::not_null<ID3D11Device*> device, const Mesh& mesh)
+	{
+		// Each vertex declaration owns a distinct static input element array, so its address identifies the layout.
+		const Key key(mesh.Id(), T::InputElements.data());
+		auto buffers = Find(key);
+		if (buffers != nullptr)
+		{
+			return buffers;
+		}
+
+		// A mesh loaded for this declaration is uploaded from its own storage, without building vertices first.
+		const auto interleavedVertices = mesh.Streams().InterleavedVertices(T::InputElements.data());
+		if (!interleavedVertices.empty())
+		{
+			const gsl::span<const T> vertices(reinterpret_cast<const T*>(interleavedVertices.data()), mesh.VertexCount());
+			return Insert(key, device, mesh, mPool->AllocateVertices<T>(device, vertices));
+		}
+
+		std::vector<T> vertices;
+		T::CreateVertices(mesh, vertices);
+		return Insert(key, device, mesh, mPool->AllocateVertices<T>(device, vertices));
+	}
+
+	inline std::uint32_t MeshBufferCache::Hits() const
+	{
+		return mHits;
+	}
+
+	inline std::uint32_t MeshBufferCache::Misses() const
+	{
+		return mMisses;
+	}
+
+	inline std::uint64_t MeshBufferCache::BytesUploaded() const
+	{
+		return mBytesUploaded;
+	}
+
+	inline std::uint64_t MeshBufferCache::BytesSaved() const
+	{
+		return mBytesSaved;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,311 @@
+#include "pch.h"
+#include "MeshCodec.h"
+#include "GameException.h"
+#if defined(_XM_SSE_INTRINSICS_)
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+using namespace gsl;
+
+namespace Library
+{
+	namespace
+	{
+		const size_t GroupSize = 16;
+		const uint32_t GroupBits[] = { 0, 2, 4, 8 };
+		const size_t GroupByteCounts[] = { 0, 4, 8, 16 };
+
+		[[noreturn]] void ThrowCorrupt()
+		{
+			throw GameException("Compressed mesh data is corrupt.");
+		}
+
+		uint8_t ZigZag(uint8_t delta)
+		{
+			return static_cast<uint8_t>((delta << 1) ^ (static_cast<int8_t>(delta) >> 7));
+		}
+
+		void EncodePlane(const uint8_t* plane, size_t count, uint8_t& previous, vector<uint8_t>& encoded)
+		{
+			const size_t groupCount = (count + GroupSize - 1) / GroupSize;
+			const size_t headerStart = encoded.size();
+			encoded.resize(headerStart + (groupCount + 3) / 4, 0);
+
+			for (size_t group = 0; group < groupCount; ++group)
+			{
+				uint8_t values[GroupSize]{ 0 };
+				uint8_t maxValue = 0;
+				const size_t groupStart = group * GroupSize;
+				const size_t valueCount = min(GroupSize, count - groupStart);
+				for (size_t i = 0; i < valueCount; ++i)
+				{
+					const uint8_t value = plane[groupStart + i];
+					values[i] = ZigZag(static_cast<uint8_t>(value - previous));
+					maxValue = max(maxValue, values[i]);
+					previous = value;
+				}
+
+				const uint32_t code = (maxValue == 0 ? 0 : (maxValue < 4 ? 1 : (maxValue < 16 ? 2 : 3)));
+				encoded[headerStart + group / 4] |= static_cast<uint8_t>(code << ((group % 4) * 2));
+				if (code == 0)
+				{
+					continue;
+				}
+
+				// Earlier values take the higher bits of each byte
+				const uint32_t bits = GroupBits[code];
+				const uint32_t valuesPerByte = 8 / bits;
+				const size_t dataStart = encoded.size();
+				encoded.resize(dataStart + GroupByteCounts[code], 0);
+				for (uint32_t i = 0; i < GroupSize; ++i)
+				{
+					encoded[dataStart + i / valuesPerByte] |= static_cast<uint8_t>(values[i] << (8 - bits * (i % valuesPerByte + 1)));
+				}
+			}
+		}
+
+#if defined(_XM_SSE_INTRINSICS_)
+		__m128i UnpackGroup(const uint8_t* data, uint32_t bits)
+		{
+			switch (bits)
+			{
+			case 0:
+				return _mm_setzero_si128();
+
+			case 2:
+			{
+				int32_t packed;
+				memcpy(&packed, data, sizeof(packed));
+				const __m128i source = _mm_cvtsi32_si128(packed);
+				const __m128i mask = _mm_set1_epi8(3);
+				const __m128i first = _mm_and_si128(_mm_srli_epi16(source, 6), mask);
+				const __m128i second = _mm_and_si128(_mm_srli_epi16(source, 4), mask);
+				const __m128i third = _mm_and_si128(_mm_srli_epi16(source, 2), mask);
+				const __m128i fourth = _mm_and_si128(source, mask);
+
+				return _mm_unpacklo_epi16(_mm_unpacklo_epi8(first, second), _mm_unpacklo_epi8(third, fourth));
+			}
+
+			case 4:
+			{
+				const __m128i source = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+				const __m128i mask = _mm_set1_epi8(15);
+
+				return _mm_unpacklo_epi8(_mm_and_si128(_mm_srli_epi16(source, 4), mask), _mm_and_si128(source, mask));
+			}
+
+			default:
+				return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+			}
+		}
+
+		uint8_t DecodeGroup(const uint8_t* data, uint32_t bits, uint8_t previous, uint8_t* output)
+		{
+			__m128i values = UnpackGroup(data, bits);
+
+			// Undo the zigzag, (v >> 1) ^ -(v & 1), then take the running sum of the deltas on top of the previous group's last value
+			const __m128i halves = _mm_and_si128(_mm_srli_epi16(values, 1), _mm_set1_epi8(0x7F));
+			values = _mm_xor_si128(halves, _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(values, _mm_set1_epi8(1))));
+			values = _mm_add_epi8(values, _mm_slli_si128(values, 1));
+			values = _mm_add_epi8(values, _mm_slli_si128(values, 2));
+			values = _mm_add_epi8(values, _mm_slli_si128(values, 4));
+			values = _mm_add_epi8(values, _mm_slli_si128(values, 8));
+			values = _mm_add_epi8(values, _mm_set1_epi8(static_cast<char>(previous)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output), values);
+
+			return output[GroupSize - 1];
+		}
+#else
+		uint8_t DecodeGroup(const uint8_t* data, uint32_t bits, uint8_t previous, uint8_t* output)
+		{
+			const uint32_t valuesPerByte = (bits > 0 ? 8 / bits : 0);
+			const uint32_t mask = (1U << bits) - 1;
+			for (uint32_t i = 0; i < GroupSize; ++i)
+			{
+				const uint32_t value = (bits > 0 ? (data[i / valuesPerByte] >> (8 - bits * (i % valuesPerByte + 1))) & mask : 0);
+				previous = static_cast<uint8_t>(previous + ((value >> 1) ^ (0U - (value & 1))));
+				output[i] = previous;
+			}
+
+			return previous;
+		}
+#endif
+
+		// Planes are decoded in whole groups, so plane must have room for the count rounded up to GroupSize.
+		const uint8_t* DecodePlane(const uint8_t* data, const uint8_t* end, size_t count, uint8_t& previous, uint8_t* plane)
+		{
+			const size_t groupCount = (count + GroupSize - 1) / GroupSize;
+			const size_t headerSize = (groupCount + 3) / 4;
+			if (size_t(end - data) < headerSize)
+			{
+				ThrowCorrupt();
+			}
+
+			const uint8_t* header = data;
+			data += headerSize;
+			for (size_t group = 0; group < groupCount; ++group)
+			{
+				const uint32_t code = (header[group / 4] >> ((group % 4) * 2)) & 3;
+				if (size_t(end - data) < GroupByteCounts[code])
+				{
+					ThrowCorrupt();
+				}
+
+				previous = DecodeGroup(data, GroupBits[code], previous, plane + group * GroupSize);
+				data += GroupByteCounts[code];
+			}
+
+			return data;
+		}
+
+		const uint8_t* SkipPlane(const uint8_t* data, const uint8_t* end, size_t count)
+		{
+			const size_t groupCount = (count + GroupSize - 1) / GroupSize;
+			const size_t headerSize = (groupCount + 3) / 4;
+			if (size_t(end - data) < headerSize)
+			{
+				ThrowCorrupt();
+			}
+
+			size_t dataSize = 0;
+			for (size_t group = 0; group < groupCount; ++group)
+			{
+				dataSize += GroupByteCounts[(data[group / 4] >> ((group % 4) * 2)) & 3];
+			}
+
+			if (size_t(end - data) - headerSize < dataSize)
+			{
+				ThrowCorrupt();
+			}
+
+			return data + headerSize + dataSize;
+		}
+	}
+
+	vector<uint8_t> MeshCodec::EncodeIndices(span<const uint32_t> indices)
+	{
+		vector<uint8_t> encoded;
+		encoded.reserve(indices.size() * 2);
+
+		uint32_t previous = 0;
+		for (uint32_t index : indices)
+		{
+			const int32_t delta = static_cast<int32_t>(index - previous);
+			uint32_t value = (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+			while (value >= 0x80)
+			{
+				encoded.push_back(static_cast<uint8_t>(value | 0x80));
+				value >>= 7;
+			}
+
+			encoded.push_back(static_cast<uint8_t>(value));
+			previous = index;
+		}
+
+		return encoded;
+	}
+
+	void MeshCodec::DecodeIndices(span<const uint8_t> encoded, span<uint32_t> indices)
+	{
+		const uint8_t* data = encoded.data();
+		const uint8_t* end = data + encoded.size();
+
+		uint32_t previous = 0;
+		for (uint32_t& index : indices)
+		{
+			uint32_t value = 0;
+			for (uint32_t shift = 0; ; shift += 7)
+			{
+				if (data == end || shift > 28)
+				{
+					ThrowCorrupt();
+				}
+
+				const uint8_t encodedByte = *data++;
+				value |= uint32_t(encodedByte & 0x7F) << shift;
+				if ((encodedByte & 0x80) == 0)
+				{
+					break;
+				}
+			}
+
+			previous += (value >> 1) ^ (0U - (value & 1));
+			index = previous;
+		}
+
+		if (data != end)
+		{
+			ThrowCorrupt();
+		}
+	}
+
+	vector<uint8_t> MeshCodec::EncodeVertices(const byte* elements, size_t elementSize, size_t elementCount)
+	{
+		assert(elementSize > 0 && elementSize <= MaxElementSize);
+
+		vector<uint8_t> encoded;
+		encoded.reserve(elementSize * elementCount / 2);
+
+		uint8_t previous[MaxElementSize]{ 0 };
+		vector<uint8_t> plane(BlockElementCount);
+		for (size_t blockStart = 0; blockStart < elementCount; blockStart += BlockElementCount)
+		{
+			const size_t blockCount = min(BlockElementCount, elementCount - blockStart);
+			for (size_t k = 0; k < elementSize; ++k)
+			{
+				const byte* source = elements + blockStart * elementSize + k;
+				for (size_t i = 0; i < blockCount; ++i, source += elementSize)
+				{
+					plane[i] = static_cast<uint8_t>(*source);
+				}
+
+				EncodePlane(plane.data(), blockCount, previous[k], encoded);
+			}
+		}
+
+		return encoded;
+	}
+
+	void MeshCodec::DecodeVertices(span<const uint8_t> encoded, size_t elementSize, size_t elementCount, byte* destination, size_t destinationStride, size_t writeSize)
+	{
+		assert(elementSize > 0 && elementSize <= MaxElementSize && writeSize <= elementSize);
+
+		const uint8_t* data = encoded.data();
+		const uint8_t* end = data + encoded.size();
+
+		uint8_t previous[MaxElementSize]{ 0 };
+		vector<uint8_t> planes(writeSize * BlockElementCount);
+		for (size_t blockStart = 0; blockStart < elementCount; blockStart += BlockElementCount)
+		{
+			const size_t blockCount = min(BlockElementCount, elementCount - blockStart);
+			for (size_t k = 0; k < elementSize; ++k)
+			{
+				data = (k < writeSize ? DecodePlane(data, end, blockCount, previous[k], planes.data() + k * BlockElementCount) : SkipPlane(data, end, blockCount));
+			}
+
+			// Transpose the planes back into elements, a 32-bit component at a time where the write allows it
+			byte* element = destination + blockStart * destinationStride;
+			const size_t wordCount = writeSize / sizeof(uint32_t);
+			for (size_t i = 0; i < blockCount; ++i, element += destinationStride)
+			{
+				const uint8_t* plane = planes.data() + i;
+				for (size_t word = 0; word < wordCount; ++word, plane += 4 * BlockElementCount)
+				{
+					const uint32_t value = uint32_t(plane[0]) | (uint32_t(plane[BlockElementCount]) << 8) | (uint32_t(plane[2 * BlockElementCount]) << 16) | (uint32_t(plane[3 * BlockElementCount]) << 24);
+					memcpy(element + word * sizeof(uint32_t), &value, sizeof(value));
+				}
+
+				for (size_t k = wordCount * sizeof(uint32_t); k < writeSize; ++k)
+				{
+					element[k] = static_cast<byte>(planes[k * BlockElementCount + i]);
+				}
+			}
+		}
+
+		if (data != end)
+		{
+			ThrowCorrupt();
+		}
+	}
+}
\ No newline at end of file
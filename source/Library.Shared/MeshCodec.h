@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <gsl\gsl>
+
+namespace Library
+{
+	enum class MeshEncoding : std::uint32_t
+	{
+		Raw,
+		Compressed // Vertex streams and indices through MeshCodec
+	};
+
+	/// <summary>
+	/// Lossless codec for a mesh's vertex streams and indices in model files.
+	/// Indices are delta coded against the previous index, zigzagged and written as varints, which pays off once the
+	/// vertex cache optimizer has ordered neighbouring triangles to reuse recently referenced vertices.
+	/// Vertex streams are transposed into byte planes, so exponents, sign bits and mantissas are each coded with their peers.
+	/// Each plane is delta coded between consecutive elements, and every group of 16 deltas is stored at the smallest of 0, 2, 4 or 8 bits
+	/// that holds it. Groups decode with SSE2 where DirectXMath uses it.
+	/// </summary>
+	class MeshCodec final
+	{
+	public:
+		inline static const std::size_t BlockElementCount{ 256 }; // Elements decoded together, so a block's planes stay in L1
+		inline static const std::size_t MaxElementSize{ 64 };
+
+		static std::vector<std::uint8_t> EncodeIndices(gsl::span<const std::uint32_t> indices);
+		static void DecodeIndices(gsl::span<const std::uint8_t> encoded, gsl::span<std::uint32_t> indices);
+
+		static std::vector<std::uint8_t> EncodeVertices(const std::byte* elements, std::size_t elementSize, std::size_t elementCount);
+
+		/// <summary>
+		/// Decodes elementCount elements into destination, destinationStride bytes apart.
+		/// Only the first writeSize bytes of each element are stored, so a stream can land directly in a narrower slot of an interleaved vertex.
+		/// </summary>
+		static void DecodeVertices(gsl::span<const std::uint8_t> encoded, std::size_t elementSize, std::size_t elementCount, std::byte* destination, std::size_t destinationStride, std::size_t writeSize);
+
+		MeshCodec() = delete;
+		MeshCodec(const MeshCodec&) = delete;
+		MeshCodec& operator=(const MeshCodec&) = delete;
+		MeshCodec(MeshCodec&&) = delete;
+		MeshCodec& operator=(MeshCodec&&) = delete;
+		~MeshCodec() = default;
+	};
+}
\ No newline at end of file
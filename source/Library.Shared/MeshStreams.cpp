@@ -0,0 +1,392 @@
+#include "pch.h"
+#include "MeshStreams.h"
+#include "Mesh.h"
+
+using namespace std;
+using namespace gsl;
+using namespace DirectX;
+
+namespace Library
+{
+	namespace
+	{
+		const size_t StorageAlignment = alignof(XMFLOAT4);
+
+		size_t DescriptorTableSize(uint32_t streamCount)
+		{
+			return (sizeof(MeshStreamDescriptor) * streamCount + StorageAlignment - 1) & ~(StorageAlignment - 1);
+		}
+	}
+
+	MeshStreams::MeshStreams(MeshData& meshData, pmr::memory_resource* resource) :
+		mResource(resource)
+	{
+		assert(resource != nullptr);
+
+		struct Source
+		{
+			MeshStreamSemantic Semantic;
+			uint32_t Channel;
+			const void* Data;
+			size_t Count;
+		};
+
+		vector<Source> sources;
+		auto addSource = [&sources](MeshStreamSemantic semantic, uint32_t channel, const auto& elements)
+		{
+			if (!elements.empty())
+			{
+				sources.push_back({ semantic, channel, elements.data(), elements.size() });
+			}
+		};
+
+		addSource(MeshStreamSemantic::Position, 0, meshData.Vertices);
+		addSource(MeshStreamSemantic::Normal, 0, meshData.Normals);
+		addSource(MeshStreamSemantic::Tangent, 0, meshData.Tangents);
+		addSource(MeshStreamSemantic::BiNormal, 0, meshData.BiNormals);
+
+		// Empty channels are dropped, as they are when a mesh is loaded, so channel numbers stay dense.
+		uint32_t channel = 0;
+		for (const auto& textureCoordinates : meshData.TextureCoordinates)
+		{
+			addSource(MeshStreamSemantic::TextureCoordinate, channel, textureCoordinates);
+			channel += (textureCoordinates.empty() ? 0 : 1);
+		}
+
+		channel = 0;
+		for (const auto& vertexColors : meshData.VertexColors)
+		{
+			addSource(MeshStreamSemantic::Color, channel, vertexColors);
+			channel += (vertexColors.empty() ? 0 : 1);
+		}
+
+		if (sources.empty())
+		{
+			return;
+		}
+
+		mStreamCount = narrow<uint32_t>(sources.size());
+		size_t size = sizeof(MeshStreamDescriptor) * mStreamCount;
+		vector<MeshStreamDescriptor> descriptors;
+		descriptors.reserve(sources.size());
+		for (const Source& source : sources)
+		{
+			size = (size + StorageAlignment - 1) & ~(StorageAlignment - 1);
+			descriptors.push_back({ source.Semantic, source.Channel, narrow<uint32_t>(size), narrow<uint32_t>(source.Count) });
+			size += size_t(ElementSize(source.Semantic)) * source.Count;
+		}
+
+		mSize = size;
+		mStorage = static_cast<byte*>(mResource->allocate(mSize, StorageAlignment));
+		memcpy(mStorage, descriptors.data(), sizeof(MeshStreamDescriptor) * mStreamCount);
+		for (size_t i = 0; i < sources.size(); ++i)
+		{
+			memcpy(mStorage + descriptors[i].Offset, sources[i].Data, size_t(ElementSize(sources[i].Semantic)) * sources[i].Count);
+		}
+
+		// The packed copy is now the only one.
+		meshData.Vertices = vector<XMFLOAT3>();
+		meshData.Normals = vector<XMFLOAT3>();
+		meshData.Tangents = vector<XMFLOAT3>();
+		meshData.BiNormals = vector<XMFLOAT3>();
+		meshData.TextureCoordinates = vector<vector<XMFLOAT3>>();
+		meshData.VertexColors = vector<vector<XMFLOAT4>>();
+	}
+
+	MeshStreams::MeshStreams(const InterleavedVertexLayout& layout, uint32_t vertexCount, pmr::memory_resource* resource) :
+		mResource(resource), mLayout(layout)
+	{
+		assert(resource != nullptr && layout.VertexFormat != nullptr && layout.VertexSize > 0);
+
+		if (vertexCount == 0)
+		{
+			return;
+		}
+
+		const MeshStreamDescriptor descriptor{ MeshStreamSemantic::Interleaved, 0, narrow<uint32_t>(DescriptorTableSize(1)), vertexCount };
+		mStreamCount = 1;
+		mSize = descriptor.Offset + size_t(layout.VertexSize) * vertexCount;
+		mStorage = static_cast<byte*>(mResource->allocate(mSize, StorageAlignment));
+		memcpy(mStorage, &descriptor, sizeof(descriptor));
+
+		// Members the declaration does not bind from a stream start out zeroed.
+		memset(mStorage + descriptor.Offset, 0, mSize - descriptor.Offset);
+	}
+
+	MeshStreams::MeshStreams(const MeshStreams& rhs)
+	{
+		CopyFrom(rhs);
+	}
+
+	MeshStreams::MeshStreams(MeshStreams&& rhs) noexcept :
+		mResource(rhs.mResource), mStorage(rhs.mStorage), mSize(rhs.mSize), mStreamCount(rhs.mStreamCount), mLayout(rhs.mLayout)
+	{
+		rhs.mStorage = nullptr;
+		rhs.mSize = 0;
+		rhs.mStreamCount = 0;
+	}
+
+	MeshStreams& MeshStreams::operator=(const MeshStreams& rhs)
+	{
+		if (this != &rhs)
+		{
+			Clear();
+			CopyFrom(rhs);
+		}
+
+		return *this;
+	}
+
+	MeshStreams& MeshStreams::operator=(MeshStreams&& rhs) noexcept
+	{
+		if (this != &rhs)
+		{
+			Clear();
+			mResource = rhs.mResource;
+			mStorage = rhs.mStorage;
+			mSize = rhs.mSize;
+			mStreamCount = rhs.mStreamCount;
+			mLayout = rhs.mLayout;
+			rhs.mStorage = nullptr;
+			rhs.mSize = 0;
+			rhs.mStreamCount = 0;
+		}
+
+		return *this;
+	}
+
+	MeshStreams::~MeshStreams()
+	{
+		Clear();
+	}
+
+	bool MeshStreams::IsEmpty() const
+	{
+		return (mStreamCount == 0);
+	}
+
+	size_t MeshStreams::SizeInBytes() const
+	{
+		return mSize;
+	}
+
+	span<const MeshStreamDescriptor> MeshStreams::Descriptors() const
+	{
+		return span<const MeshStreamDescriptor>(reinterpret_cast<const MeshStreamDescriptor*>(mStorage), mStreamCount);
+	}
+
+	uint32_t MeshStreams::VertexCount() const
+	{
+		for (const MeshStreamDescriptor& descriptor : Descriptors())
+		{
+			if (descriptor.Semantic == MeshStreamSemantic::Position || descriptor.Semantic == MeshStreamSemantic::Interleaved)
+			{
+				return descriptor.Count;
+			}
+		}
+
+		return 0;
+	}
+
+	span<const XMFLOAT3> MeshStreams::Vertices() const
+	{
+		return Stream<XMFLOAT3>(MeshStreamSemantic::Position, 0);
+	}
+
+	span<const XMFLOAT3> MeshStreams::Normals() const
+	{
+		return Stream<XMFLOAT3>(MeshStreamSemantic::Normal, 0);
+	}
+
+	span<const XMFLOAT3> MeshStreams::Tangents() const
+	{
+		return Stream<XMFLOAT3>(MeshStreamSemantic::Tangent, 0);
+	}
+
+	span<const XMFLOAT3> MeshStreams::BiNormals() const
+	{
+		return Stream<XMFLOAT3>(MeshStreamSemantic::BiNormal, 0);
+	}
+
+	uint32_t MeshStreams::TextureCoordinateChannelCount() const
+	{
+		return ChannelCount(MeshStreamSemantic::TextureCoordinate);
+	}
+
+	span<const XMFLOAT3> MeshStreams::TextureCoordinates(uint32_t channel) const
+	{
+		return Stream<XMFLOAT3>(MeshStreamSemantic::TextureCoordinate, channel);
+	}
+
+	uint32_t MeshStreams::VertexColorChannelCount() const
+	{
+		return ChannelCount(MeshStreamSemantic::Color);
+	}
+
+	span<const XMFLOAT4> MeshStreams::VertexColors(uint32_t channel) const
+	{
+		return Stream<XMFLOAT4>(MeshStreamSemantic::Color, channel);
+	}
+
+	const InterleavedVertexLayout& MeshStreams::Layout() const
+	{
+		return mLayout;
+	}
+
+	span<const byte> MeshStreams::InterleavedVertices(const D3D11_INPUT_ELEMENT_DESC* vertexFormat) const
+	{
+		if (mStreamCount == 0 || mLayout.VertexFormat != vertexFormat)
+		{
+			return span<const byte>();
+		}
+
+		const MeshStreamDescriptor& descriptor = Descriptors()[0];
+		return span<const byte>(mStorage + descriptor.Offset, size_t(mLayout.VertexSize) * descriptor.Count);
+	}
+
+	span<byte> MeshStreams::InterleavedVertices()
+	{
+		const auto vertices = static_cast<const MeshStreams&>(*this).InterleavedVertices(mLayout.VertexFormat);
+		return span<byte>(const_cast<byte*>(vertices.data()), vertices.size());
+	}
+
+	void MeshStreams::Unpack(MeshData& meshData) const
+	{
+		if (mLayout.VertexFormat != nullptr)
+		{
+			// Recover the streams the declaration carries; the rest were never loaded.
+			const auto vertices = InterleavedVertices(mLayout.VertexFormat);
+			const uint32_t vertexCount = VertexCount();
+			auto unpackStream = [&](const VertexStreamBinding& binding, auto& elements)
+			{
+				elements.resize(vertexCount);
+				for (uint32_t i = 0; i < vertexCount; ++i)
+				{
+					memcpy(&elements[i], vertices.data() + size_t(i) * mLayout.VertexSize + binding.Offset, sizeof(float) * min<size_t>(binding.ComponentCount, sizeof(elements[i]) / sizeof(float)));
+				}
+			};
+
+			for (const VertexStreamBinding& binding : mLayout.Bindings)
+			{
+				switch (binding.Semantic)
+				{
+				case MeshStreamSemantic::Position:
+					unpackStream(binding, meshData.Vertices);
+					break;
+
+				case MeshStreamSemantic::Normal:
+					unpackStream(binding, meshData.Normals);
+					break;
+
+				case MeshStreamSemantic::Tangent:
+					unpackStream(binding, meshData.Tangents);
+					break;
+
+				case MeshStreamSemantic::BiNormal:
+					unpackStream(binding, meshData.BiNormals);
+					break;
+
+				case MeshStreamSemantic::TextureCoordinate:
+					meshData.TextureCoordinates.resize(max<size_t>(meshData.TextureCoordinates.size(), size_t(binding.Channel) + 1));
+					unpackStream(binding, meshData.TextureCoordinates[binding.Channel]);
+					break;
+
+				case MeshStreamSemantic::Color:
+					meshData.VertexColors.resize(max<size_t>(meshData.VertexColors.size(), size_t(binding.Channel) + 1));
+					unpackStream(binding, meshData.VertexColors[binding.Channel]);
+					break;
+
+				default:
+					break;
+				}
+			}
+
+			return;
+		}
+
+		auto assign = [](auto& elements, const auto& stream)
+		{
+			elements.assign(stream.begin(), stream.end());
+		};
+
+		assign(meshData.Vertices, Vertices());
+		assign(meshData.Normals, Normals());
+		assign(meshData.Tangents, Tangents());
+		assign(meshData.BiNormals, BiNormals());
+
+		meshData.TextureCoordinates.resize(TextureCoordinateChannelCount());
+		for (uint32_t channel = 0; channel < meshData.TextureCoordinates.size(); ++channel)
+		{
+			assign(meshData.TextureCoordinates[channel], TextureCoordinates(channel));
+		}
+
+		meshData.VertexColors.resize(VertexColorChannelCount());
+		for (uint32_t channel = 0; channel < meshData.VertexColors.size(); ++channel)
+		{
+			assign(meshData.VertexColors[channel], VertexColors(channel));
+		}
+	}
+
+	void MeshStreams::Clear()
+	{
+		if (mStorage != nullptr)
+		{
+			mResource->deallocate(mStorage, mSize, StorageAlignment);
+			mStorage = nullptr;
+		}
+
+		mSize = 0;
+		mStreamCount = 0;
+		mLayout = InterleavedVertexLayout();
+	}
+
+	template <typename T>
+	span<const T> MeshStreams::Stream(MeshStreamSemantic semantic, uint32_t channel) const
+	{
+		for (const MeshStreamDescriptor& descriptor : Descriptors())
+		{
+			if (descriptor.Semantic == semantic && descriptor.Channel == channel)
+			{
+				return span<const T>(reinterpret_cast<const T*>(mStorage + descriptor.Offset), descriptor.Count);
+			}
+		}
+
+		return span<const T>();
+	}
+
+	uint32_t MeshStreams::ChannelCount(MeshStreamSemantic semantic) const
+	{
+		const auto descriptors = Descriptors();
+		return narrow_cast<uint32_t>(count_if(descriptors.begin(), descriptors.end(), [semantic](const MeshStreamDescriptor& descriptor) { return descriptor.Semantic == semantic; }));
+	}
+
+	uint32_t MeshStreams::ElementSize(MeshStreamSemantic semantic) const
+	{
+		switch (semantic)
+		{
+		case MeshStreamSemantic::Color:
+			return sizeof(XMFLOAT4);
+
+		case MeshStreamSemantic::Interleaved:
+			return mLayout.VertexSize;
+
+		default:
+			return sizeof(XMFLOAT3);
+		}
+	}
+
+	void MeshStreams::CopyFrom(const MeshStreams& rhs)
+	{
+		// Like the pmr containers, a copy does not inherit the source's arena.
+		mResource = pmr::get_default_resource();
+		if (rhs.mStorage != nullptr)
+		{
+			mStorage = static_cast<byte*>(mResource->allocate(rhs.mSize, StorageAlignment));
+			memcpy(mStorage, rhs.mStorage, rhs.mSize);
+		}
+
+		mSize = rhs.mSize;
+		mStreamCount = rhs.mStreamCount;
+		mLayout = rhs.mLayout;
+	}
+}
\ No newline at end of file
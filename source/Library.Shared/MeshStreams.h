@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <memory_resource>
+#include <gsl\gsl>
+#include <DirectXMath.h>
+#include <d3d11.h>
+
+namespace Library
+{
+	struct MeshData;
+
+	enum class MeshStreamSemantic : std::uint32_t
+	{
+		Position,
+		Normal,
+		Tangent,
+		BiNormal,
+		TextureCoordinate,
+		Color,
+		Interleaved // Whole vertices of one declaration
+	};
+
+	struct MeshStreamDescriptor final
+	{
+		MeshStreamSemantic Semantic{ MeshStreamSemantic::Position };
+		std::uint32_t Channel{ 0 };
+		std::uint32_t Offset{ 0 }; // In bytes, from the start of the allocation
+		std::uint32_t Count{ 0 };
+	};
+
+	struct VertexStreamBinding final
+	{
+		MeshStreamSemantic Semantic{ MeshStreamSemantic::Position };
+		std::uint32_t Channel{ 0 };
+		std::uint32_t Offset{ 0 }; // In bytes, within the vertex
+		std::uint32_t ComponentCount{ 0 }; // Floats written; a fourth component beyond a three-component stream is 1
+	};
+
+	/// <summary>
+	/// Where a vertex declaration places each mesh stream, so a loader can write finished vertices without per-stream arrays.
+	/// </summary>
+	struct InterleavedVertexLayout final
+	{
+		const D3D11_INPUT_ELEMENT_DESC* VertexFormat{ nullptr }; // Identifies the declaration
+		std::uint32_t VertexSize{ 0 };
+		gsl::span<const VertexStreamBinding> Bindings;
+
+		template <typename T>
+		static InterleavedVertexLayout For()
+		{
+			return InterleavedVertexLayout{ T::InputElements.data(), T::VertexSize(), T::StreamBindings() };
+		}
+	};
+
+	/// <summary>
+	/// A mesh's vertex streams packed into a single allocation: a descriptor table followed by each stream's elements, back to back.
+	/// Vertex declarations that interleave several streams walk one contiguous block instead of a dozen separate heap blocks.
+	/// The block comes from the supplied memory resource, so a loader can place every mesh of a model in one arena.
+	/// A mesh loaded for a known vertex declaration instead holds a single interleaved stream, ready to be uploaded as is.
+	/// </summary>
+	class MeshStreams final
+	{
+	public:
+		MeshStreams() = default;
+		explicit MeshStreams(MeshData& meshData, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+		MeshStreams(const InterleavedVertexLayout& layout, std::uint32_t vertexCount, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+		MeshStreams(const MeshStreams& rhs);
+		MeshStreams(MeshStreams&& rhs) noexcept;
+		MeshStreams& operator=(const MeshStreams& rhs);
+		MeshStreams& operator=(MeshStreams&& rhs) noexcept;
+		~MeshStreams();
+
+		bool IsEmpty() const;
+		std::size_t SizeInBytes() const;
+		gsl::span<const MeshStreamDescriptor> Descriptors() const;
+		std::uint32_t VertexCount() const;
+
+		gsl::span<const DirectX::XMFLOAT3> Vertices() const;
+		gsl::span<const DirectX::XMFLOAT3> Normals() const;
+		gsl::span<const DirectX::XMFLOAT3> Tangents() const;
+		gsl::span<const DirectX::XMFLOAT3> BiNormals() const;
+		std::uint32_t TextureCoordinateChannelCount() const;
+		gsl::span<const DirectX::XMFLOAT3> TextureCoordinates(std::uint32_t channel) const;
+		std::uint32_t VertexColorChannelCount() const;
+		gsl::span<const DirectX::XMFLOAT4> VertexColors(std::uint32_t channel) const;
+		const InterleavedVertexLayout& Layout() const;
+		gsl::span<const std::byte> InterleavedVertices(const D3D11_INPUT_ELEMENT_DESC* vertexFormat) const;
+		gsl::span<std::byte> InterleavedVertices();
+
+		void Unpack(MeshData& meshData) const;
+		void Clear();
+
+	private:
+		template <typename T>
+		gsl::span<const T> Stream(MeshStreamSemantic semantic, std::uint32_t channel) const;
+		std::uint32_t ChannelCount(MeshStreamSemantic semantic) const;
+		std::uint32_t ElementSize(MeshStreamSemantic semantic) const;
+		void CopyFrom(const MeshStreams& rhs);
+
+		std::pmr::memory_resource* mResource{ nullptr };
+		std::byte* mStorage{ nullptr };
+		std::size_t mSize{ 0 };
+		std::uint32_t mStreamCount{ 0 };
+		InterleavedVertexLayout mLayout; // Empty unless the streams are interleaved
+	};
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include "pch.h"
+#include "MeshletCuller.h"
+#include "Camera.h"
+#include "Mesh.h"
+#include "DirectXHelper.h"
+
+using namespace std;
+using namespace gsl;
+using namespace winrt;
+using namespace DirectX;
+
+namespace Library
+{
+	MeshletCuller::MeshletCuller(DXGI_FORMAT indexFormat, uint32_t initialIndexCapacity) :
+		mIndexFormat(indexFormat), mIndexCapacity(initialIndexCapacity),
+		mFrustumPlanes{}, mCameraPosition(0.0f, 0.0f, 0.0f)
+	{
+		assert(indexFormat == DXGI_FORMAT_R16_UINT || indexFormat == DXGI_FORMAT_R32_UINT);
+		mIndices.reserve(initialIndexCapacity);
+	}
+
+	ID3D11Buffer* MeshletCuller::IndexBuffer() const
+	{
+		return mIndexBuffer.get();
+	}
+
+	DXGI_FORMAT MeshletCuller::IndexFormat() const
+	{
+		return mIndexFormat;
+	}
+
+	const MeshletCullStatistics& MeshletCuller::Statistics() const
+	{
+		return mStatistics;
+	}
+
+	void MeshletCuller::Begin(const Camera& camera)
+	{
+		mIndices.clear();
+		mStatistics = MeshletCullStatistics();
+		mCameraPosition = camera.Position();
+
+		// Planes are the sums and differences of the view-projection matrix's columns (Gribb and Hartmann), with D3D's 0 <= z <= w clip range.
+		XMFLOAT4X4 viewProjection;
+		XMStoreFloat4x4(&viewProjection, XMMatrixTranspose(camera.ViewProjectionMatrix()));
+		const XMVECTOR x = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(viewProjection.m[0]));
+		const XMVECTOR y = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(viewProjection.m[1]));
+		const XMVECTOR z = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(viewProjection.m[2]));
+		const XMVECTOR w = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(viewProjection.m[3]));
+
+		const XMVECTOR planes[] = { XMVectorAdd(w, x), XMVectorSubtract(w, x), XMVectorAdd(w, y), XMVectorSubtract(w, y), z, XMVectorSubtract(w, z) };
+		for (size_t i = 0; i < mFrustumPlanes.size(); ++i)
+		{
+			XMStoreFloat4(&mFrustumPlanes[i], XMPlaneNormalize(planes[i]));
+		}
+	}
+
+	MeshletDraw MeshletCuller::Cull(const Mesh& mesh, FXMMATRIX worldMatrix)
+	{
+		const auto& meshlets = mesh.Meshlets();
+		const auto& indices = mesh.Indices();
+		MeshletDraw draw{ narrow<uint32_t>(mIndices.size()), 0 };
+
+		// Spheres are tested in world space and cones in the mesh's own space, where the meshlet data lives
+		const float worldScale = max({ XMVectorGetX(XMVector3Length(worldMatrix.r[0])), XMVectorGetX(XMVector3Length(worldMatrix.r[1])), XMVectorGetX(XMVector3Length(worldMatrix.r[2])) });
+
+		// The mesh's stored bounding sphere rejects a mesh that is wholly off screen without visiting its meshlets
+		const MeshBounds& bounds = mesh.Bounds();
+		const XMVECTOR worldMeshCenter = XMVector3TransformCoord(XMLoadFloat3(&bounds.Center), worldMatrix);
+		const float worldMeshRadius = bounds.Radius * worldScale;
+		const bool meshOutsideFrustum = any_of(mFrustumPlanes.begin(), mFrustumPlanes.end(), [&](const XMFLOAT4& plane)
+		{
+			return XMVectorGetX(XMPlaneDotCoord(XMLoadFloat4(&plane), worldMeshCenter)) < -worldMeshRadius;
+		});
+
+		if (meshOutsideFrustum)
+		{
+			const uint32_t meshletCount = narrow_cast<uint32_t>(meshlets.size());
+			mStatistics.MeshletCount += meshletCount;
+			mStatistics.FrustumCulledCount += meshletCount;
+			return draw;
+		}
+
+		const XMMATRIX inverseWorldMatrix = XMMatrixInverse(nullptr, worldMatrix);
+		const XMVECTOR localCameraPosition = XMVector3TransformCoord(XMLoadFloat3(&mCameraPosition), inverseWorldMatrix);
+
+		for (const Meshlet& meshlet : meshlets)
+		{
+			++mStatistics.MeshletCount;
+
+			const XMVECTOR center = XMLoadFloat3(&meshlet.Center);
+			const XMVECTOR worldCenter = XMVector3TransformCoord(center, worldMatrix);
+			const float worldRadius = meshlet.Radius * worldScale;
+			const bool outsideFrustum = any_of(mFrustumPlanes.begin(), mFrustumPlanes.end(), [&](const XMFLOAT4& plane)
+			{
+				return XMVectorGetX(XMPlaneDotCoord(XMLoadFloat4(&plane), worldCenter)) < -worldRadius;
+			});
+
+			if (outsideFrustum)
+			{
+				++mStatistics.FrustumCulledCount;
+				continue;
+			}
+
+			// The whole cluster faces away when the view direction lies inside the normal cone, widened by the sphere's angular size
+			if (meshlet.ConeCutoff < 1.0f)
+			{
+				const XMVECTOR viewDirection = XMVectorSubtract(center, localCameraPosition);
+				const float viewDistance = XMVectorGetX(XMVector3Length(viewDirection));
+				if (XMVectorGetX(XMVector3Dot(viewDirection, XMLoadFloat3(&meshlet.ConeAxis))) >= meshlet.ConeCutoff * viewDistance + meshlet.Radius)
+				{
+					++mStatistics.BackfaceCulledCount;
+					continue;
+				}
+			}
+
+			mIndices.insert(mIndices.end(), indices.begin() + meshlet.StartIndex, indices.begin() + meshlet.StartIndex + meshlet.IndexCount);
+			draw.IndexCount += meshlet.IndexCount;
+		}
+
+		mStatistics.SubmittedIndexCount += draw.IndexCount;
+
+		return draw;
+	}
+
+	void MeshletCuller::End(ID3D11DeviceContext& deviceContext)
+	{
+		if (mIndices.empty())
+		{
+			return;
+		}
+
+		const uint32_t indexSize = (mIndexFormat == DXGI_FORMAT_R16_UINT ? sizeof(uint16_t) : sizeof(uint32_t));
+		if (mIndexBuffer == nullptr || mIndices.size() > mIndexCapacity)
+		{
+			while (mIndices.size() > mIndexCapacity)
+			{
+				mIndexCapacity *= 2;
+			}
+
+			com_ptr<ID3D11Device> device;
+			deviceContext.GetDevice(device.put());
+
+			D3D11_BUFFER_DESC indexBufferDesc{ 0 };
+			indexBufferDesc.ByteWidth = mIndexCapacity * indexSize;
+			indexBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+			indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+			indexBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+			mIndexBuffer = nullptr;
+			ThrowIfFailed(device->CreateBuffer(&indexBufferDesc, nullptr, mIndexBuffer.put()), "ID3D11Device::CreateBuffer() failed.");
+		}
+
+		D3D11_MAPPED_SUBRESOURCE mappedResource;
+		ThrowIfFailed(deviceContext.Map(mIndexBuffer.get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource), "ID3D11DeviceContext::Map() failed.");
+		if (mIndexFormat == DXGI_FORMAT_R16_UINT)
+		{
+			// 16-bit meshes only ever hold indices that fit
+			transform(mIndices.begin(), mIndices.end(), static_cast<uint16_t*>(mappedResource.pData), [](uint32_t index)
+			{
+				return static_cast<uint16_t>(index);
+			});
+		}
+		else
+		{
+			memcpy(mappedResource.pData, mIndices.data(), mIndices.size() * sizeof(uint32_t));
+		}
+
+		deviceContext.Unmap(mIndexBuffer.get(), 0);
+	}
+}
\ No newline at end of file
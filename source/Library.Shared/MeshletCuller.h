@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include <gsl\gsl>
+#include <winrt\Windows.Foundation.h>
+
+namespace Library
+{
+	class Camera;
+	class Mesh;
+
+	struct MeshletDraw final
+	{
+		std::uint32_t StartIndexLocation{ 0 }; // Into the culler's index buffer
+		std::uint32_t IndexCount{ 0 }; // 0 when every meshlet was culled
+	};
+
+	struct MeshletCullStatistics final
+	{
+		std::uint32_t MeshletCount{ 0 };
+		std::uint32_t FrustumCulledCount{ 0 };
+		std::uint32_t BackfaceCulledCount{ 0 };
+		std::uint32_t SubmittedIndexCount{ 0 };
+	};
+
+	/// <summary>
+	/// Culls a mesh's meshlets against the view frustum and their normal cones on the CPU and compacts the surviving triangles
+	/// into a dynamic index buffer, which is refilled once per frame between Begin() and End().
+	/// The indices keep the mesh's vertex numbering, so draws use the mesh's usual vertex buffer and base vertex location.
+	/// </summary>
+	class MeshletCuller final
+	{
+	public:
+		inline static const std::uint32_t DefaultIndexCapacity{ 64 * 1024 };
+
+		explicit MeshletCuller(DXGI_FORMAT indexFormat, std::uint32_t initialIndexCapacity = DefaultIndexCapacity);
+		MeshletCuller(const MeshletCuller&) = delete;
+		MeshletCuller& operator=(const MeshletCuller&) = delete;
+		MeshletCuller(MeshletCuller&&) = default;
+		MeshletCuller& operator=(MeshletCuller&&) = default;
+		~MeshletCuller() = default;
+
+		ID3D11Buffer* IndexBuffer() const;
+		DXGI_FORMAT IndexFormat() const;
+		const MeshletCullStatistics& Statistics() const;
+
+		void Begin(const Camera& camera);
+
+		/// <summary>
+		/// Appends the triangles of the mesh's visible meshlets. The world matrix must not scale non-uniformly, because the cone test runs in the mesh's space.
+		/// </summary>
+		MeshletDraw Cull(const Mesh& mesh, DirectX::FXMMATRIX worldMatrix);
+		void End(ID3D11DeviceContext& deviceContext);
+
+	private:
+		winrt::com_ptr<ID3D11Buffer> mIndexBuffer;
+		DXGI_FORMAT mIndexFormat;
+		std::uint32_t mIndexCapacity;
+		std::vector<std::uint32_t> mIndices;
+		std::array<DirectX::XMFLOAT4, 6> mFrustumPlanes;
+		DirectX::XMFLOAT3 mCameraPosition;
+		MeshletCullStatistics mStatistics;
+	};
+}
\ No newline at end of file
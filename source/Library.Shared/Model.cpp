@@ -4,6 +4,9 @@
 #include "StreamHelper.h"
 #include "GameException.h"
 #include "ModelMaterial.h"
+#include <atomic>
+#include <future>
+#include <thread>
 
 using namespace std;
 using namespace gsl;
@@ -18,9 +21,9 @@ namespace Library
 		Load(filename);
 	}
 
-	Model::Model(ifstream& file)
+	Model::Model(istream& stream, const InterleavedVertexLayout* interleavedLayout)
 	{
-		Load(file);
+		Load(stream, interleavedLayout);
 	}
 
 	Model::Model(ModelData&& modelData) :
@@ -48,12 +51,28 @@ namespace Library
 		return mData.Materials;
 	}
 
+	MeshBounds Model::Bounds() const
+	{
+		if (mData.Meshes.empty())
+		{
+			return MeshBounds();
+		}
+
+		MeshBounds bounds = mData.Meshes.front()->Bounds();
+		for_each(mData.Meshes.begin() + 1, mData.Meshes.end(), [&bounds](const shared_ptr<Mesh>& mesh)
+		{
+			bounds.Merge(mesh->Bounds());
+		});
+
+		return bounds;
+	}
+
 	ModelData& Model::Data()
 	{
 		return mData;
 	}
 
-	void Model::Save(const string& filename) const
+	void Model::Save(const string& filename, MeshEncoding meshEncoding) const
 	{
 		ofstream file(filename.c_str(), ios::binary);
 		if (!file.good())
@@ -61,12 +80,13 @@ namespace Library
 			throw exception("Could not open file.");
 		}
 
-		Save(file);
+		Save(file, meshEncoding);
 	}
 
-	void Model::Save(ofstream& file) const
+	void Model::Save(ostream& stream, MeshEncoding meshEncoding) const
 	{
-		OutputStreamHelper streamHelper(file);
+		OutputStreamHelper streamHelper(stream);
+		streamHelper << FileSignature << CurrentFileVersion;
 
 		// Serialize materials
 		streamHelper << narrow_cast<uint32_t>(mData.Materials.size());
@@ -75,11 +95,17 @@ namespace Library
 			material->Save(streamHelper);
 		}
 
-		// Serialize meshes
+		// Serialize meshes as size-prefixed records, so a loader can read them all and then decode them in parallel
 		streamHelper << narrow_cast<uint32_t>(mData.Meshes.size());
 		for (auto& mesh : mData.Meshes)
 		{
-			mesh->Save(streamHelper);
+			ostringstream meshStream(ios::binary);
+			OutputStreamHelper meshStreamHelper(meshStream);
+			mesh->Save(meshStreamHelper, meshEncoding);
+
+			const string record = meshStream.str();
+			streamHelper << narrow_cast<uint32_t>(record.size());
+			stream.write(record.data(), narrow_cast<streamsize>(record.size()));
 		}
 	}
 
@@ -94,13 +120,26 @@ namespace Library
 		Load(file);
 	}
 
-	void Model::Load(ifstream& file)
+	void Model::Load(istream& stream, const InterleavedVertexLayout* interleavedLayout)
 	{
-		InputStreamHelper streamHelper(file);
+		InputStreamHelper streamHelper(stream);
 
-		// Desrialize materials
+		// Files written before versioning began with the material count
+		uint32_t fileVersion = LegacyFileVersion;
 		uint32_t materialCount;
 		streamHelper >> materialCount;
+		if (materialCount == FileSignature)
+		{
+			streamHelper >> fileVersion;
+			if (fileVersion > CurrentFileVersion)
+			{
+				throw GameException("Unsupported model file version.");
+			}
+
+			streamHelper >> materialCount;
+		}
+
+		// Desrialize materials
 		mData.Materials.reserve(materialCount);
 		for (uint32_t i = 0; i < materialCount; i++)
 		{
@@ -110,10 +149,55 @@ namespace Library
 		// Desrialize meshes
 		uint32_t meshCount;
 		streamHelper >> meshCount;
-		mData.Meshes.reserve(meshCount);
-		for (uint32_t i = 0; i < meshCount; i++)
+		if (fileVersion < 6)
+		{
+			mData.Meshes.reserve(meshCount);
+			for (uint32_t i = 0; i < meshCount; i++)
+			{
+				mData.Meshes.emplace_back(make_shared<Mesh>(*this, streamHelper, fileVersion, interleavedLayout));
+			}
+
+			return;
+		}
+
+		// Meshes are size-prefixed records: read them all, then decode them in parallel, one mesh per task
+		vector<vector<char>> records(meshCount);
+		for (vector<char>& record : records)
+		{
+			uint32_t recordSize;
+			streamHelper >> recordSize;
+			record.resize(recordSize);
+			if (!stream.read(record.data(), recordSize))
+			{
+				throw GameException("Model file is truncated.");
+			}
+		}
+
+		mData.Meshes.resize(meshCount);
+		atomic<size_t> nextMesh{ 0 };
+		auto loadMeshes = [&]()
+		{
+			for (size_t meshIndex = nextMesh++; meshIndex < meshCount; meshIndex = nextMesh++)
+			{
+				MemoryStreamBuffer streamBuffer(records[meshIndex]);
+				istream meshStream(&streamBuffer);
+				InputStreamHelper meshStreamHelper(meshStream);
+				mData.Meshes[meshIndex] = make_shared<Mesh>(*this, meshStreamHelper, fileVersion, interleavedLayout);
+			}
+		};
+
+		// The calling thread takes a share of the meshes as well
+		const size_t workerCount = min<size_t>(max(thread::hardware_concurrency(), 1U), meshCount);
+		vector<future<void>> workers;
+		for (size_t i = 1; i < workerCount; ++i)
+		{
+			workers.push_back(async(launch::async, loadMeshes));
+		}
+
+		loadMeshes();
+		for (future<void>& worker : workers)
 		{
-			mData.Meshes.emplace_back(make_shared<Mesh>(*this, streamHelper));
+			worker.get();
 		}
 	}
 }
\ No newline at end of file
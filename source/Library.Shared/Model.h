@@ -1,10 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <map>
 #include <string>
 #include <fstream>
 #include "RTTI.h"
+#include "MeshCodec.h"
 
 namespace Library
 {
@@ -13,6 +15,8 @@ namespace Library
     class ModelMaterial;
 	class OutputStreamHelper;
 	class InputStreamHelper;
+	struct InterleavedVertexLayout;
+	struct MeshBounds;
 
 	struct ModelData final
 	{
@@ -25,9 +29,13 @@ namespace Library
 		RTTI_DECLARATIONS(Model, RTTI)
 
     public:
+		inline static const std::uint32_t FileSignature{ 0x4C444F4D }; // "MODL"
+		inline static const std::uint32_t LegacyFileVersion{ 1 };
+		inline static const std::uint32_t CurrentFileVersion{ 6 };
+
 		Model() = default;
 		Model(const std::string& filename);
-		Model(std::ifstream& file);
+		Model(std::istream& stream, const InterleavedVertexLayout* interleavedLayout = nullptr);
 		Model(ModelData&& modelData);
 		Model(const Model&) = default;
 		Model(Model&&) = default;
@@ -40,15 +48,16 @@ namespace Library
 
         const std::vector<std::shared_ptr<Mesh>>& Meshes() const;
 		const std::vector<std::shared_ptr<ModelMaterial>>& Materials() const;
+		MeshBounds Bounds() const;
 
 		ModelData& Data();
 
-		void Save(const std::string& filename) const;
-		void Save(std::ofstream& file) const;
+		void Save(const std::string& filename, MeshEncoding meshEncoding = MeshEncoding::Raw) const;
+		void Save(std::ostream& stream, MeshEncoding meshEncoding = MeshEncoding::Raw) const;
 
     private:
 		void Load(const std::string& filename);
-		void Load(std::ifstream& file);
+		void Load(std::istream& stream, const InterleavedVertexLayout* interleavedLayout = nullptr);
 
 		ModelData mData;
     };
@@ -1,6 +1,8 @@
 #include "pch.h"
 #include "ModelReader.h"
 #include "Utility.h"
+#include "StreamHelper.h"
+#include "Mesh.h"
 
 using namespace std;
 
@@ -15,6 +17,21 @@ namespace Library
 
 	shared_ptr<Model> ModelReader::_Read(const wstring& assetName)
 	{
-		return make_shared<Model>(Utility::ToString(assetName));
+		vector<char> modelData;
+		Utility::LoadBinaryFile(assetName, modelData);
+
+		MemoryStreamBuffer streamBuffer(modelData);
+		istream stream(&streamBuffer);
+		return make_shared<Model>(stream);
+	}
+
+	shared_ptr<Model> ModelReader::ReadInterleaved(const wstring& assetName, const InterleavedVertexLayout& layout)
+	{
+		vector<char> modelData;
+		Utility::LoadBinaryFile(assetName, modelData);
+
+		MemoryStreamBuffer streamBuffer(modelData);
+		istream stream(&streamBuffer);
+		return make_shared<Model>(stream, &layout);
 	}
 }
\ No newline at end of file
@@ -17,6 +17,8 @@ namespace Library
 		ModelReader& operator=(ModelReader&&) = default;
 		~ModelReader() = default;
 
+		static std::shared_ptr<Model> ReadInterleaved(const std::wstring& assetName, const InterleavedVertexLayout& layout);
+
 	protected:
 		virtual std::shared_ptr<Model> _Read(const std::wstring& assetName) override;
 	};
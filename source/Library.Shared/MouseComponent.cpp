@@ -26,11 +26,13 @@ namespace Library
 
 	const Mouse::State& MouseComponent::CurrentState() const
 	{
+		ValidateRead();
 		return mCurrentState;
 	}
 
 	const Mouse::State& MouseComponent::LastState() const
 	{
+		ValidateRead();
 		return mLastState;
 	}
 
@@ -46,6 +48,11 @@ namespace Library
 		mCurrentState = sMouse->GetState();
 	}
 
+	void MouseComponent::DeclareAccess(ComponentAccess&) const
+	{
+		// Reads only the mouse device
+	}
+
 	void MouseComponent::SetWindow(HWND window)
 	{
 		sMouse->SetWindow(window);
@@ -53,16 +60,19 @@ namespace Library
 
 	int MouseComponent::X() const
 	{
+		ValidateRead();
 		return mCurrentState.x;
 	}
 
 	int MouseComponent::Y() const
 	{
+		ValidateRead();
 		return mCurrentState.y;
 	}
 
 	int MouseComponent::Wheel() const
 	{
+		ValidateRead();
 		return mCurrentState.scrollWheelValue;
 	}
 
@@ -103,6 +113,7 @@ namespace Library
 
 	MouseModes MouseComponent::Mode() const
 	{
+		ValidateRead();
 		auto state = sMouse->GetState();
 		return static_cast<MouseModes>(state.positionMode);
 	}
@@ -114,6 +125,7 @@ namespace Library
 
 	bool MouseComponent::GetButtonState(const Mouse::State& state, MouseButtons button) const
 	{
+		ValidateRead();
 		switch (button)
 		{
 			case Library::MouseButtons::Left:
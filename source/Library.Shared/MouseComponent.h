@@ -46,6 +46,7 @@ namespace Library
 
 		virtual void Initialize() override;
 		virtual void Update(const GameTime& gameTime) override;
+		virtual void DeclareAccess(Library::ComponentAccess& access) const override;
 		void SetWindow(HWND window);
 
 		int X() const;
@@ -19,10 +19,9 @@ namespace Library
 
 	shared_ptr<PixelShader> PixelShaderReader::_Read(const wstring& assetName)
 	{
-		com_ptr<ID3D11PixelShader> pixelShader;
 		vector<char> compiledPixelShader;
 		Utility::LoadBinaryFile(assetName, compiledPixelShader);
-		ThrowIfFailed(mGame->Direct3DDevice()->CreatePixelShader(compiledPixelShader.data(), compiledPixelShader.size(), nullptr, pixelShader.put()), "ID3D11Device::CreatedPixelShader() failed.");
+		com_ptr<ID3D11PixelShader> pixelShader = mGame->ShaderCache().GetPixelShader(mGame->Direct3DDevice(), compiledPixelShader);
 		
 		return shared_ptr<PixelShader>(new PixelShader(move(pixelShader)));
 	}
@@ -0,0 +1,249 @@
+#include "pch.h"
+#include "Profiler.h"
+#include "GameException.h"
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+namespace Library
+{
+	namespace
+	{
+		// Fields are written by the owning thread and read by a trace writer at any time, so each is atomic; relaxed access costs nothing extra on x86/x64.
+		struct ProfileEvent final
+		{
+			atomic<const char*> Name{ nullptr };
+			atomic<int64_t> StartTicks{ 0 };
+			atomic<int64_t> EndTicks{ 0 };
+			atomic<uint32_t> Depth{ 0 };
+		};
+
+		// A single-writer ring. The writer claims a slot before filling it and commits it after,
+		// so a reader knows which of the slots it copied may have been overwritten meanwhile.
+		struct ThreadBuffer final
+		{
+			uint32_t ThreadId{ 0 };
+			string Name; // Guarded by the registry's mutex
+			unique_ptr<ProfileEvent[]> Events{ make_unique<ProfileEvent[]>(Profiler::ThreadBufferCapacity) };
+			atomic<uint64_t> ClaimedCount{ 0 };
+			atomic<uint64_t> CommittedCount{ 0 };
+			uint32_t Depth{ 0 }; // Owning thread only
+		};
+
+		int64_t Ticks()
+		{
+			// The time-stamp counter is several times cheaper to read than the system clock, and is constant-rate on every CPU the game supports
+#if defined(_M_X64) || defined(_M_IX86)
+			return static_cast<int64_t>(__rdtsc());
+#else
+			return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+		}
+
+		int64_t ClockNanoseconds()
+		{
+			return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		struct ThreadBufferRegistry final
+		{
+			mutex Mutex;
+			vector<unique_ptr<ThreadBuffer>> Buffers; // Never released, so a buffer outlives its thread and its zones stay in traces
+			const int64_t OriginTicks{ Ticks() }; // Ticks are converted to time against the clock over the whole run
+			const int64_t OriginNanoseconds{ ClockNanoseconds() };
+		};
+
+		struct TraceEvent final
+		{
+			const char* Name;
+			int64_t StartTicks;
+			int64_t EndTicks;
+			uint32_t Depth;
+		};
+
+		atomic<bool> sIsRecording{ true };
+		thread_local ThreadBuffer* sThreadBuffer{ nullptr };
+
+		ThreadBufferRegistry& Registry()
+		{
+			static ThreadBufferRegistry registry;
+			return registry;
+		}
+
+		ThreadBuffer& CurrentThreadBuffer()
+		{
+			if (sThreadBuffer == nullptr)
+			{
+				auto& registry = Registry();
+				lock_guard<mutex> lock(registry.Mutex);
+				auto buffer = make_unique<ThreadBuffer>();
+				buffer->ThreadId = static_cast<uint32_t>(registry.Buffers.size() + 1);
+				sThreadBuffer = buffer.get();
+				registry.Buffers.push_back(move(buffer));
+			}
+
+			return *sThreadBuffer;
+		}
+
+		void WriteEscaped(ostream& stream, const char* text)
+		{
+			for (; *text != '\0'; ++text)
+			{
+				if (*text == '"' || *text == '\\')
+				{
+					stream << '\\';
+				}
+
+				stream << *text;
+			}
+		}
+
+		vector<TraceEvent> CopyEvents(const ThreadBuffer& buffer)
+		{
+			const uint64_t capacity = Profiler::ThreadBufferCapacity;
+			const uint64_t committedCount = buffer.CommittedCount.load(memory_order_acquire);
+			const uint64_t first = (committedCount > capacity ? committedCount - capacity : 0);
+
+			vector<TraceEvent> events;
+			events.reserve(static_cast<size_t>(committedCount - first));
+			for (uint64_t i = first; i < committedCount; ++i)
+			{
+				const ProfileEvent& event = buffer.Events[static_cast<size_t>(i % capacity)];
+				events.push_back({ event.Name.load(memory_order_relaxed), event.StartTicks.load(memory_order_relaxed), event.EndTicks.load(memory_order_relaxed), event.Depth.load(memory_order_relaxed) });
+			}
+
+			// Anything the writer claimed a full ring beyond may have been overwritten while it was copied
+			atomic_thread_fence(memory_order_acquire);
+			const uint64_t claimedCount = buffer.ClaimedCount.load(memory_order_relaxed);
+			const uint64_t firstIntact = (claimedCount > capacity ? claimedCount - capacity : 0);
+			if (firstIntact > first)
+			{
+				events.erase(events.begin(), events.begin() + static_cast<ptrdiff_t>(min(firstIntact - first, static_cast<uint64_t>(events.size()))));
+			}
+
+			// Zones are recorded as they close, children first; traces list them parents first
+			sort(events.begin(), events.end(), [](const TraceEvent& lhs, const TraceEvent& rhs)
+			{
+				return (lhs.StartTicks != rhs.StartTicks ? lhs.StartTicks < rhs.StartTicks : lhs.Depth < rhs.Depth);
+			});
+
+			return events;
+		}
+	}
+
+	bool Profiler::IsRecording()
+	{
+		return sIsRecording.load(memory_order_relaxed);
+	}
+
+	void Profiler::SetRecording(bool recording)
+	{
+		sIsRecording = recording;
+	}
+
+	void Profiler::SetThreadName(const string& name)
+	{
+		ThreadBuffer& buffer = CurrentThreadBuffer();
+		lock_guard<mutex> lock(Registry().Mutex);
+		buffer.Name = name;
+	}
+
+	size_t Profiler::WriteChromeTrace(ostream& stream)
+	{
+		vector<pair<uint32_t, string>> threads;
+		vector<pair<uint32_t, vector<TraceEvent>>> threadEvents;
+		{
+			auto& registry = Registry();
+			lock_guard<mutex> lock(registry.Mutex);
+			for (const auto& buffer : registry.Buffers)
+			{
+				threads.emplace_back(buffer->ThreadId, buffer->Name);
+				threadEvents.emplace_back(buffer->ThreadId, CopyEvents(*buffer));
+			}
+		}
+
+		const double elapsedTicks = static_cast<double>(Ticks() - Registry().OriginTicks);
+		const double elapsedNanoseconds = static_cast<double>(ClockNanoseconds() - Registry().OriginNanoseconds);
+		const double microsecondsPerTick = (elapsedTicks > 0.0 ? elapsedNanoseconds / elapsedTicks : 1.0) * 1.0e-3;
+
+		// Timestamps are microseconds from the earliest zone written
+		int64_t originTicks = numeric_limits<int64_t>::max();
+		for (const auto& [threadId, events] : threadEvents)
+		{
+			if (!events.empty())
+			{
+				originTicks = min(originTicks, events.front().StartTicks);
+			}
+		}
+
+		size_t eventCount = 0;
+		const char* separator = "";
+		stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		for (const auto& [threadId, name] : threads)
+		{
+			stream << separator << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadId << ",\"args\":{\"name\":\"";
+			WriteEscaped(stream, (name.empty() ? ("Thread " + to_string(threadId)).c_str() : name.c_str()));
+			stream << "\"}}";
+			separator = ",";
+		}
+
+		stream << fixed << setprecision(3);
+		for (const auto& [threadId, events] : threadEvents)
+		{
+			for (const TraceEvent& event : events)
+			{
+				stream << separator << "\n{\"name\":\"";
+				WriteEscaped(stream, event.Name);
+				stream << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << threadId;
+				stream << ",\"ts\":" << static_cast<double>(event.StartTicks - originTicks) * microsecondsPerTick << ",\"dur\":" << static_cast<double>(event.EndTicks - event.StartTicks) * microsecondsPerTick << "}";
+				separator = ",";
+				++eventCount;
+			}
+		}
+
+		stream << "\n]}\n";
+
+		return eventCount;
+	}
+
+	size_t Profiler::WriteChromeTrace(const wstring& filename)
+	{
+		ofstream file(filename, ios::trunc);
+		if (!file.good())
+		{
+			throw GameException("Could not open the profiler trace for writing.");
+		}
+
+		return WriteChromeTrace(file);
+	}
+
+	int64_t Profiler::BeginZone()
+	{
+		++CurrentThreadBuffer().Depth;
+		return Ticks();
+	}
+
+	void Profiler::EndZone(const char* name, int64_t startTicks)
+	{
+		const int64_t endTicks = Ticks();
+		ThreadBuffer& buffer = CurrentThreadBuffer();
+		--buffer.Depth;
+
+		const uint64_t index = buffer.ClaimedCount.load(memory_order_relaxed);
+		buffer.ClaimedCount.store(index + 1, memory_order_relaxed);
+		atomic_thread_fence(memory_order_release);
+
+		ProfileEvent& event = buffer.Events[static_cast<size_t>(index % ThreadBufferCapacity)];
+		event.Name.store(name, memory_order_relaxed);
+		event.StartTicks.store(startTicks, memory_order_relaxed);
+		event.EndTicks.store(endTicks, memory_order_relaxed);
+		event.Depth.store(buffer.Depth, memory_order_relaxed);
+
+		buffer.CommittedCount.store(index + 1, memory_order_release);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Define PROFILING_ENABLED as 0 to compile every zone out; the macros below then expand to nothing.
+#if !defined(PROFILING_ENABLED)
+#define PROFILING_ENABLED 1
+#endif
+
+namespace Library
+{
+	/// <summary>
+	/// CPU frame profiler. Each thread records the zones it closes into its own ring buffer, with no locks or allocation once its first zone is recorded,
+	/// and the most recent zones of every thread can be written out as Chrome trace-event JSON (chrome://tracing, Perfetto) at any time.
+	/// Zones nest, and a trace shows them as a hierarchy per thread.
+	/// Zone names are not copied, so they have to outlive the profiler: string literals, __FUNCTION__, or RTTI type names.
+	/// </summary>
+	class Profiler final
+	{
+	public:
+		inline static const std::size_t ThreadBufferCapacity{ 1 << 14 }; // Zones kept per thread; the oldest are overwritten
+
+		static bool IsRecording();
+		static void SetRecording(bool recording);
+
+		/// <summary>
+		/// Names the calling thread in traces. Threads that aren't named show as their thread ID.
+		/// </summary>
+		static void SetThreadName(const std::string& name);
+
+		/// <summary>
+		/// Writes every thread's buffered zones. Threads keep recording while this runs.
+		/// </summary>
+		/// <returns>The number of zones written.</returns>
+		static std::size_t WriteChromeTrace(std::ostream& stream);
+		static std::size_t WriteChromeTrace(const std::wstring& filename);
+
+		static std::int64_t BeginZone();
+		static void EndZone(const char* name, std::int64_t startTicks);
+
+		Profiler() = delete;
+		Profiler(const Profiler&) = delete;
+		Profiler& operator=(const Profiler&) = delete;
+		Profiler(Profiler&&) = delete;
+		Profiler& operator=(Profiler&&) = delete;
+		~Profiler() = default;
+	};
+
+	class ProfileZone final
+	{
+	public:
+		explicit ProfileZone(const char* name) :
+			mName(name), mIsRecording(Profiler::IsRecording()), mStartTicks(mIsRecording ? Profiler::BeginZone() : 0)
+		{
+		}
+
+		ProfileZone(const ProfileZone&) = delete;
+		ProfileZone& operator=(const ProfileZone&) = delete;
+		ProfileZone(ProfileZone&&) = delete;
+		ProfileZone& operator=(ProfileZone&&) = delete;
+
+		~ProfileZone()
+		{
+			if (mIsRecording)
+			{
+				Profiler::EndZone(mName, mStartTicks);
+			}
+		}
+
+	private:
+		const char* mName;
+		bool mIsRecording;
+		std::int64_t mStartTicks;
+	};
+}
+
+#if PROFILING_ENABLED
+#define PROFILE_CONCATENATE_IMPLEMENTATION(Lhs, Rhs) Lhs##Rhs
+#define PROFILE_CONCATENATE(Lhs, Rhs) PROFILE_CONCATENATE_IMPLEMENTATION(Lhs, Rhs)
+#define PROFILE_ZONE(Name) Library::ProfileZone PROFILE_CONCATENATE(profileZone, __LINE__)(Name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__FUNCTION__)
+#define PROFILE_THREAD_NAME(Name) Library::Profiler::SetThreadName(Name)
+#else
+#define PROFILE_ZONE(Name)
+#define PROFILE_FUNCTION()
+#define PROFILE_THREAD_NAME(Name)
+#endif
\ No newline at end of file
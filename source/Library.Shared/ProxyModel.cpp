@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "ProxyModel.h"
+#include "ComponentScheduler.h"
 #include "Game.h"
 #include "GameException.h"
 #include "Utility.h"
@@ -8,6 +9,7 @@
 #include "RasterizerStates.h"
 #include "Model.h"
 #include "Mesh.h"
+#include "ModelReader.h"
 
 using namespace std;
 using namespace gsl;
@@ -24,6 +26,13 @@ namespace Library
 	{
 	}
 
+	ProxyModel::ProxyModel(Game& game, const shared_ptr<Camera>& camera, const shared_ptr<Model>& model, float scale) :
+		DrawableGameComponent(game, camera),
+		mModel(model), mScale(scale),
+		mMaterial(*mGame)
+	{
+	}
+
 	const XMFLOAT3& ProxyModel::Position() const
 	{
 		return mPosition;
@@ -121,11 +130,13 @@ namespace Library
 
 	void ProxyModel::Initialize()
 	{
-		const auto model = mGame->Content().Load<Model>(Utility::ToWideString(mModelFileName));
+		// Proxies are only ever drawn with VertexPosition, so their files are read straight into that layout
+		const auto model = (mModel != nullptr ? mModel : mGame->Content().Load<Model>(Utility::ToWideString(mModelFileName), false, [](wstring& assetName)
+		{
+			return ModelReader::ReadInterleaved(assetName, InterleavedVertexLayout::For<VertexPosition>());
+		}));
 		Mesh* mesh = model->Meshes().at(0).get();
-		VertexPosition::CreateVertexBuffer(mGame->Direct3DDevice(), *mesh, not_null<ID3D11Buffer**>(mVertexBuffer.put()));
-		mesh->CreateIndexBuffer(*mGame->Direct3DDevice(), not_null<ID3D11Buffer**>(mIndexBuffer.put()));
-		mIndexCount = narrow<uint32_t>(mesh->Indices().size());
+		mMeshBuffers = mGame->BufferCache().Get<VertexPosition>(mGame->Direct3DDevice(), *mesh);
 
 		mMaterial.Initialize();
 
@@ -150,6 +161,11 @@ namespace Library
 		}
 	}
 
+	void ProxyModel::DeclareAccess(ComponentAccess& access) const
+	{
+		access.Reads(mCamera.get()); // The camera's callbacks update this model's material
+	}
+
 	void ProxyModel::Draw(const GameTime&)
 	{
 		if (mUpdateMaterial)
@@ -163,12 +179,12 @@ namespace Library
 		if (mDisplayWireframe)
 		{
 			mGame->Direct3DDeviceContext()->RSSetState(RasterizerStates::Wireframe.get());
-			mMaterial.DrawIndexed(not_null<ID3D11Buffer*>(mVertexBuffer.get()), not_null<ID3D11Buffer*>(mIndexBuffer.get()), mIndexCount);
+			mMaterial.DrawIndexed(not_null<ID3D11Buffer*>(mMeshBuffers->VertexBuffer), not_null<ID3D11Buffer*>(mMeshBuffers->IndexBuffer), mMeshBuffers->IndexCount, mMeshBuffers->IndexFormat, mMeshBuffers->StartIndexLocation, mMeshBuffers->BaseVertexLocation);
 			mGame->Direct3DDeviceContext()->RSSetState(nullptr);
 		}
 		else
 		{
-			mMaterial.DrawIndexed(not_null<ID3D11Buffer*>(mVertexBuffer.get()), not_null<ID3D11Buffer*>(mIndexBuffer.get()), mIndexCount);
+			mMaterial.DrawIndexed(not_null<ID3D11Buffer*>(mMeshBuffers->VertexBuffer), not_null<ID3D11Buffer*>(mMeshBuffers->IndexBuffer), mMeshBuffers->IndexCount, mMeshBuffers->IndexFormat, mMeshBuffers->StartIndexLocation, mMeshBuffers->BaseVertexLocation);
 		}
 	}
 }
\ No newline at end of file
@@ -12,6 +12,8 @@
 namespace Library
 {
 	class Mesh;
+	class Model;
+	struct MeshBuffers;
 
 	class ProxyModel final : public DrawableGameComponent
 	{
@@ -19,6 +21,7 @@ namespace Library
 
 	public:
 		ProxyModel(Game& game, const std::shared_ptr<Camera>& camera, const std::string& modelFileName, float scale = 1.0f);
+		ProxyModel(Game& game, const std::shared_ptr<Camera>& camera, const std::shared_ptr<Model>& model, float scale = 1.0f);
 		ProxyModel(const ProxyModel&) = delete;
 		ProxyModel(ProxyModel&&) = default;
 		ProxyModel& operator=(const ProxyModel&) = delete;		
@@ -48,6 +51,7 @@ namespace Library
 
 		virtual void Initialize() override;
 		virtual void Update(const GameTime& gameTime) override;		
+		virtual void DeclareAccess(ComponentAccess& access) const override;
 		virtual void Draw(const GameTime& gameTime) override;
 
 	private:
@@ -58,10 +62,9 @@ namespace Library
 		DirectX::XMFLOAT3 mRight{ Vector3Helper::Right };
 		BasicMaterial mMaterial;
 		std::string mModelFileName;
+		std::shared_ptr<Model> mModel; // Used instead of mModelFileName when set, e.g. for generated geometry
 		float mScale;
-		winrt::com_ptr<ID3D11Buffer> mVertexBuffer;
-		winrt::com_ptr<ID3D11Buffer> mIndexBuffer;		
-		std::uint32_t mIndexCount{ 0 };
+		std::shared_ptr<const MeshBuffers> mMeshBuffers;
 		bool mDisplayWireframe{ true };
 		bool mUpdateWorldMatrix{ true };
 		bool mUpdateMaterial{ true };
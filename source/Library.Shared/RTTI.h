@@ -1,38 +1,128 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <cstdint>
+#include <cstddef>
 
 namespace Library
 {
+	/// <summary>
+	/// Run-time type information without a walk up the hierarchy.
+	/// Every type has a constant TypeInfo, and a constant table of its ancestors' TypeInfos indexed by depth, from RTTI down to itself.
+	/// An object is a T exactly when its table has T's TypeInfo at T's depth, which is a single comparison whatever the hierarchy's depth.
+	/// A type's ID is the address of its TypeInfo with its depth in the low bits, which alignment leaves clear, so IDs are fixed at link time
+	/// and need no run-time registration, and an ID is checked against the single table slot its depth names without being read back as a TypeInfo.
+	/// </summary>
 	class RTTI
 	{
 	public:
 		using IdType = std::uint64_t;
 
+		struct alignas(16) TypeInfo final
+		{
+			const char* Name;
+			std::size_t Depth; // RTTI itself is 0
+		};
+
+		struct AncestorTable final
+		{
+			const TypeInfo* const* Types; // Indexed by depth; the last is the type itself
+			std::size_t Count;
+		};
+
+		inline static constexpr std::size_t MaxDepth{ 15 }; // The most an ID's low bits can hold
+		inline static constexpr TypeInfo sTypeInfo{ "RTTI", 0 };
+		inline static constexpr std::array<const TypeInfo*, 1> sAncestors{ &sTypeInfo };
+
 		virtual ~RTTI() = default;
 
 		virtual std::uint64_t TypeIdInstance() const = 0;
+		virtual AncestorTable Ancestors() const = 0;
 
-		virtual RTTI* QueryInterface(const IdType)
+		static IdType IdOf(const TypeInfo& typeInfo)
 		{
-			return nullptr;
+			return reinterpret_cast<IdType>(&typeInfo) | typeInfo.Depth;
 		}
 
-		virtual bool Is(IdType) const
+		template <std::size_t Count>
+		static constexpr std::array<const TypeInfo*, Count + 1> AppendAncestor(const std::array<const TypeInfo*, Count>& ancestors, const TypeInfo* type)
 		{
-			return false;
+			std::array<const TypeInfo*, Count + 1> table{};
+			for (std::size_t i = 0; i < Count; ++i)
+			{
+				table[i] = ancestors[i];
+			}
+
+			table[Count] = type;
+			return table;
 		}
 
-		virtual bool Is(const std::string&) const
+		static constexpr bool NamesEqual(const char* lhs, const char* rhs)
 		{
+			while (*lhs != '\0' && *lhs == *rhs)
+			{
+				++lhs;
+				++rhs;
+			}
+
+			return *lhs == *rhs;
+		}
+
+		bool Is(const TypeInfo& typeInfo) const
+		{
+			const AncestorTable ancestors = Ancestors();
+			return (typeInfo.Depth > 0 && typeInfo.Depth < ancestors.Count && ancestors.Types[typeInfo.Depth] == &typeInfo);
+		}
+
+		/// <summary>
+		/// An ID is never read back as a TypeInfo, so any value is safe to pass.
+		/// </summary>
+		bool Is(IdType id) const
+		{
+			const std::size_t depth = static_cast<std::size_t>(id & MaxDepth);
+			const AncestorTable ancestors = Ancestors();
+			return (depth > 0 && depth < ancestors.Count && IdOf(*ancestors.Types[depth]) == id);
+		}
+
+		bool Is(const std::string& name) const
+		{
+			const AncestorTable ancestors = Ancestors();
+			for (std::size_t depth = 1; depth < ancestors.Count; ++depth)
+			{
+				if (name == ancestors.Types[depth]->Name)
+				{
+					return true;
+				}
+			}
+
 			return false;
 		}
 
+		template <typename T>
+		bool Is() const
+		{
+			return Is(T::sTypeInfo);
+		}
+
+		/// <summary>
+		/// The instance's own TypeInfo, whose Name lives as long as the program.
+		/// </summary>
+		const TypeInfo& TypeInfoInstance() const
+		{
+			const AncestorTable ancestors = Ancestors();
+			return *ancestors.Types[ancestors.Count - 1];
+		}
+
+		RTTI* QueryInterface(const IdType id)
+		{
+			return (Is(id) ? this : nullptr);
+		}
+
 		template <typename T>
 		T* As() const
 		{
-			return (Is(T::TypeIdClass()) ? reinterpret_cast<T*>(const_cast<RTTI*>(this)) : nullptr);
+			return (Is(T::sTypeInfo) ? reinterpret_cast<T*>(const_cast<RTTI*>(this)) : nullptr);
 		}
 
 		virtual std::string ToString() const
@@ -46,25 +136,17 @@ namespace Library
 		}
 	};
 
-#define RTTI_DECLARATIONS(Type, ParentType)																				 \
-		public:																											 \
-			static std::string TypeName() { return std::string(#Type); }												 \
-			static IdType TypeIdClass() { return sRunTimeTypeId; }												 \
-			virtual IdType TypeIdInstance() const override { return Type::TypeIdClass(); }						 \
-			virtual Library::RTTI* QueryInterface(const IdType id) override										 \
-            {																											 \
-				return (id == sRunTimeTypeId ? reinterpret_cast<Library::RTTI*>(this) : ParentType::QueryInterface(id)); \
-            }																											 \
-			virtual bool Is(IdType id) const override															 \
-			{																											 \
-				return (id == sRunTimeTypeId ? true : ParentType::Is(id));												 \
-			}																											 \
-			virtual bool Is(const std::string& name) const override														 \
-			{																											 \
-				return (name == TypeName() ? true : ParentType::Is(name));												 \
-			}																											 \
-			private:																									 \
-				static IdType sRunTimeTypeId;
-
-#define RTTI_DEFINITIONS(Type) RTTI::IdType Type::sRunTimeTypeId = reinterpret_cast<RTTI::IdType>(&Type::sRunTimeTypeId);
+#define RTTI_DECLARATIONS(Type, ParentType)																					\
+		public:																												\
+			inline static constexpr Library::RTTI::TypeInfo sTypeInfo{ #Type, ParentType::sTypeInfo.Depth + 1 };			\
+			inline static constexpr auto sAncestors{ Library::RTTI::AppendAncestor(ParentType::sAncestors, &sTypeInfo) };	\
+			static_assert(sTypeInfo.Depth <= Library::RTTI::MaxDepth, #Type " is deeper than an RTTI ID can record.");		\
+			static std::string TypeName() { return std::string(#Type); }													\
+			static IdType TypeIdClass() { return Library::RTTI::IdOf(sTypeInfo); }											\
+			virtual IdType TypeIdInstance() const override { return Type::TypeIdClass(); }									\
+			virtual Library::RTTI::AncestorTable Ancestors() const override { return { sAncestors.data(), sAncestors.size() }; }	\
+		private:
+
+// Everything is defined by the declarations; this catches a type that inherited its parent's instead of declaring its own.
+#define RTTI_DEFINITIONS(Type) static_assert(Library::RTTI::NamesEqual(Type::sTypeInfo.Name, #Type), #Type " is missing RTTI_DECLARATIONS.");
 }
\ No newline at end of file
@@ -1,22 +1,42 @@
 #include "pch.h"
 #include "ServiceContainer.h"
+#include "GameException.h"
+#include <atomic>
+
+using namespace std;
 
 namespace Library
 {
-	void ServiceContainer::AddService(uint64_t typeId, void* service)
+	void ServiceContainer::Seal()
 	{
-		mServices.insert(std::pair<uint64_t, void*>(typeId, service));
+		mIsSealed = true;
 	}
 
-	void ServiceContainer::RemoveService(uint64_t typeId)
+	void ServiceContainer::Clear()
 	{
-		mServices.erase(typeId);
+		mServices.clear();
+		mIsSealed = false;
 	}
 
-	void* ServiceContainer::GetService(uint64_t typeId) const
+	size_t ServiceContainer::NextSlot()
 	{
-		std::map<uint64_t, void*>::const_iterator it = mServices.find(typeId);
+		// Slots are handed out as types are first named, which can be on any thread
+		static atomic<size_t> sNextSlot{ 0 };
+		return sNextSlot++;
+	}
+
+	void ServiceContainer::SetSlot(size_t slot, void* service)
+	{
+		if (mIsSealed)
+		{
+			throw GameException("Services can't be added or removed once the game is initialized.");
+		}
+
+		if (slot >= mServices.size())
+		{
+			mServices.resize(slot + 1, nullptr);
+		}
 
-		return (it != mServices.end() ? it->second : nullptr);
+		mServices[slot] = service;
 	}
-}
+}
\ No newline at end of file
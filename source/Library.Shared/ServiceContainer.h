@@ -1,17 +1,44 @@
 #pragma once
 
-#include <map>
-#include <cstdint>
+#include <cstddef>
+#include <vector>
 
 namespace Library
 {
+	/// <summary>
+	/// Game-wide services, registered and retrieved by type.
+	/// Each service type gets a dense slot index the first time it is named, so a lookup is an index into an array,
+	/// and a service only ever comes back as the type it was registered as.
+	/// Once sealed, which Game does at the end of Initialize, services can't change, and any thread can read them.
+	/// Clear, which Game does in Shutdown, removes them all and unseals the container, so the game can be initialized again.
+	/// </summary>
 	class ServiceContainer final
 	{
 	public:
-		void AddService(std::uint64_t typeId, void* service);
-		void RemoveService(std::uint64_t typeId);
-		void* GetService(std::uint64_t typeId) const;
+		template <typename T>
+		void AddService(T& service);
 
-		std::map<std::uint64_t, void*> mServices;
+		template <typename T>
+		void RemoveService();
+
+		template <typename T>
+		T* GetService() const;
+
+		void Seal();
+		bool IsSealed() const;
+		void Clear(); // Not while other threads may still be reading services
+
+	private:
+		template <typename T>
+		static std::size_t Slot();
+
+		static std::size_t NextSlot();
+
+		void SetSlot(std::size_t slot, void* service);
+
+		std::vector<void*> mServices;
+		bool mIsSealed{ false };
 	};
-}
\ No newline at end of file
+}
+
+#include "ServiceContainer.inl"
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+#include "ServiceContainer.h"
+
+namespace Library
+{
+	template <typename T>
+	inline void ServiceContainer::AddService(T& service)
+	{
+		SetSlot(Slot<T>(), &service);
+	}
+
+	template <typename T>
+	inline void ServiceContainer::RemoveService()
+	{
+		SetSlot(Slot<T>(), nullptr);
+	}
+
+	template <typename T>
+	inline T* ServiceContainer::GetService() const
+	{
+		const std::size_t slot = Slot<T>();
+		return (slot < mServices.size() ? static_cast<T*>(mServices[slot]) : nullptr);
+	}
+
+	inline bool ServiceContainer::IsSealed() const
+	{
+		return mIsSealed;
+	}
+
+	template <typename T>
+	inline std::size_t ServiceContainer::Slot()
+	{
+		static const std::size_t slot = NextSlot();
+		return slot;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "pch.h"
+#include "ShaderObjectCache.h"
+#include "GameException.h"
+
+using namespace std;
+using namespace gsl;
+using namespace winrt;
+
+namespace Library
+{
+	com_ptr<ID3D11VertexShader> ShaderObjectCache::GetVertexShader(not_null<ID3D11Device*> device, span<const char> bytecode)
+	{
+		const Key key(HashBytes(bytecode.data(), bytecode.size()), bytecode.size());
+		return GetOrCreate(mVertexShaders, key, string_view(bytecode.data(), bytecode.size()), [&]()
+		{
+			com_ptr<ID3D11VertexShader> vertexShader;
+			ThrowIfFailed(device->CreateVertexShader(bytecode.data(), bytecode.size(), nullptr, vertexShader.put()), "ID3D11Device::CreateVertexShader() failed.");
+			return vertexShader;
+		});
+	}
+
+	com_ptr<ID3D11PixelShader> ShaderObjectCache::GetPixelShader(not_null<ID3D11Device*> device, span<const char> bytecode)
+	{
+		const Key key(HashBytes(bytecode.data(), bytecode.size()), bytecode.size());
+		return GetOrCreate(mPixelShaders, key, string_view(bytecode.data(), bytecode.size()), [&]()
+		{
+			com_ptr<ID3D11PixelShader> pixelShader;
+			ThrowIfFailed(device->CreatePixelShader(bytecode.data(), bytecode.size(), nullptr, pixelShader.put()), "ID3D11Device::CreatePixelShader() failed.");
+			return pixelShader;
+		});
+	}
+
+	com_ptr<ID3D11InputLayout> ShaderObjectCache::GetInputLayout(not_null<ID3D11Device*> device, span<const D3D11_INPUT_ELEMENT_DESC> inputElementDescriptions, span<const char> vertexShaderBytecode)
+	{
+		const Key key(HashBytes(vertexShaderBytecode.data(), vertexShaderBytecode.size()), HashInputElements(inputElementDescriptions));
+		return GetOrCreate(mInputLayouts, key, InputLayoutSource(inputElementDescriptions, vertexShaderBytecode), [&]()
+		{
+			com_ptr<ID3D11InputLayout> inputLayout;
+			ThrowIfFailed(device->CreateInputLayout(inputElementDescriptions.data(), narrow_cast<uint32_t>(inputElementDescriptions.size()), vertexShaderBytecode.data(), vertexShaderBytecode.size(), inputLayout.put()), "ID3D11Device::CreateInputLayout() failed.");
+			return inputLayout;
+		});
+	}
+
+	uint32_t ShaderObjectCache::Hits() const
+	{
+		return mHits;
+	}
+
+	uint32_t ShaderObjectCache::Misses() const
+	{
+		return mMisses;
+	}
+
+	size_t ShaderObjectCache::EntryCount() const
+	{
+		lock_guard<mutex> lock(mMutex);
+		return mEntryCount;
+	}
+
+	void ShaderObjectCache::Clear()
+	{
+		lock_guard<mutex> lock(mMutex);
+		mVertexShaders.clear();
+		mPixelShaders.clear();
+		mInputLayouts.clear();
+		mEntryCount = 0;
+	}
+
+	template <typename T, typename CreateFunction>
+	com_ptr<T> ShaderObjectCache::GetOrCreate(EntryMap<T>& entries, const Key& key, string_view source, CreateFunction create)
+	{
+		auto findSource = [&source](const vector<Entry<T>>& bucket)
+		{
+			return find_if(bucket.begin(), bucket.end(), [&source](const Entry<T>& entry) { return entry.Source == source; });
+		};
+
+		{
+			lock_guard<mutex> lock(mMutex);
+			auto it = entries.find(key);
+			if (it != entries.end())
+			{
+				auto entry = findSource(it->second);
+				if (entry != it->second.end())
+				{
+					++mHits;
+					return entry->Object;
+				}
+			}
+		}
+
+		// The device is free-threaded, so creation runs unlocked. When two threads race for the same source, the first insertion wins.
+		com_ptr<T> object = create();
+		++mMisses;
+
+		lock_guard<mutex> lock(mMutex);
+		auto& bucket = entries[key];
+		auto entry = findSource(bucket);
+		if (entry != bucket.end())
+		{
+			return entry->Object;
+		}
+
+		bucket.push_back({ string(source), move(object) });
+		++mEntryCount;
+
+		return bucket.back().Object;
+	}
+
+	uint64_t ShaderObjectCache::HashBytes(const void* data, size_t size, uint64_t hash)
+	{
+		// FNV-1a
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash = (hash ^ bytes[i]) * HashPrime;
+		}
+
+		return hash;
+	}
+
+	uint64_t ShaderObjectCache::HashInputElements(span<const D3D11_INPUT_ELEMENT_DESC> inputElementDescriptions)
+	{
+		// Semantic names are hashed by content; equal element sets declared in different arrays share a layout.
+		uint64_t hash = HashOffsetBasis;
+		for (const D3D11_INPUT_ELEMENT_DESC& element : inputElementDescriptions)
+		{
+			hash = HashBytes(element.SemanticName, strlen(element.SemanticName) + 1, hash);
+			const uint32_t values[] = { element.SemanticIndex, static_cast<uint32_t>(element.Format), element.InputSlot, element.AlignedByteOffset, static_cast<uint32_t>(element.InputSlotClass), element.InstanceDataStepRate };
+			hash = HashBytes(values, sizeof(values), hash);
+		}
+
+		return hash;
+	}
+
+	string ShaderObjectCache::InputLayoutSource(span<const D3D11_INPUT_ELEMENT_DESC> inputElementDescriptions, span<const char> vertexShaderBytecode)
+	{
+		// Laid out as HashInputElements reads the elements, with semantic names by content
+		string source(vertexShaderBytecode.data(), vertexShaderBytecode.size());
+		for (const D3D11_INPUT_ELEMENT_DESC& element : inputElementDescriptions)
+		{
+			source.append(element.SemanticName, strlen(element.SemanticName) + 1);
+			const uint32_t values[] = { element.SemanticIndex, static_cast<uint32_t>(element.Format), element.InputSlot, element.AlignedByteOffset, static_cast<uint32_t>(element.InputSlotClass), element.InstanceDataStepRate };
+			source.append(reinterpret_cast<const char*>(values), sizeof(values));
+		}
+
+		return source;
+	}
+}
\ No newline at end of file
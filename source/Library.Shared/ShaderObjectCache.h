@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <d3d11.h>
+#include <gsl\gsl>
+#include <winrt\Windows.Foundation.h>
+
+namespace Library
+{
+	/// <summary>
+	/// Process-wide cache of shader objects keyed by a hash of their bytecode, and of input layouts keyed by (bytecode hash, input element set),
+	/// so materials that share a vertex format and shader share one input layout.
+	/// A hash only finds candidates: each entry keeps the bytes it was created from, and a hit has to match them exactly.
+	/// Lookups are thread-safe and objects are created outside the lock, so shaders can be created from worker threads.
+	/// </summary>
+	class ShaderObjectCache final
+	{
+	public:
+		ShaderObjectCache() = default;
+		ShaderObjectCache(const ShaderObjectCache&) = delete;
+		ShaderObjectCache& operator=(const ShaderObjectCache&) = delete;
+		ShaderObjectCache(ShaderObjectCache&&) = delete;
+		ShaderObjectCache& operator=(ShaderObjectCache&&) = delete;
+		~ShaderObjectCache() = default;
+
+		winrt::com_ptr<ID3D11VertexShader> GetVertexShader(gsl::not_null<ID3D11Device*> device, gsl::span<const char> bytecode);
+		winrt::com_ptr<ID3D11PixelShader> GetPixelShader(gsl::not_null<ID3D11Device*> device, gsl::span<const char> bytecode);
+		winrt::com_ptr<ID3D11InputLayout> GetInputLayout(gsl::not_null<ID3D11Device*> device, gsl::span<const D3D11_INPUT_ELEMENT_DESC> inputElementDescriptions, gsl::span<const char> vertexShaderBytecode);
+
+		template <typename T>
+		winrt::com_ptr<ID3D11InputLayout> GetInputLayout(gsl::not_null<ID3D11Device*> device, gsl::span<const char> vertexShaderBytecode)
+		{
+			return GetInputLayout(device, T::InputElements, vertexShaderBytecode);
+		}
+
+		std::uint32_t Hits() const;
+		std::uint32_t Misses() const;
+		std::size_t EntryCount() const;
+
+		void Clear();
+
+	private:
+		using Key = std::pair<std::uint64_t, std::uint64_t>;
+
+		template <typename T>
+		struct Entry final
+		{
+			std::string Source; // The bytecode, and for an input layout its elements after it
+			winrt::com_ptr<T> Object;
+		};
+
+		template <typename T>
+		using EntryMap = std::map<Key, std::vector<Entry<T>>>; // Entries whose keys collide share a bucket
+
+		template <typename T, typename CreateFunction>
+		winrt::com_ptr<T> GetOrCreate(EntryMap<T>& entries, const Key& key, std::string_view source, CreateFunction create);
+
+		static std::uint64_t HashBytes(const void* data, std::size_t size, std::uint64_t hash = HashOffsetBasis);
+		static std::uint64_t HashInputElements(gsl::span<const D3D11_INPUT_ELEMENT_DESC> inputElementDescriptions);
+		static std::string InputLayoutSource(gsl::span<const D3D11_INPUT_ELEMENT_DESC> inputElementDescriptions, gsl::span<const char> vertexShaderBytecode);
+
+		inline static const std::uint64_t HashOffsetBasis{ 14695981039346656037ULL };
+		inline static const std::uint64_t HashPrime{ 1099511628211ULL };
+
+		mutable std::mutex mMutex;
+		EntryMap<ID3D11VertexShader> mVertexShaders;
+		EntryMap<ID3D11PixelShader> mPixelShaders;
+		EntryMap<ID3D11InputLayout> mInputLayouts;
+		std::size_t mEntryCount{ 0 };
+		std::atomic<std::uint32_t> mHits{ 0 };
+		std::atomic<std::uint32_t> mMisses{ 0 };
+	};
+}
\ No newline at end of file
@@ -1,9 +1,11 @@
 #include "pch.h"
 #include "Skybox.h"
+#include "ComponentScheduler.h"
 #include "Game.h"
 #include "GameException.h"
 #include "FirstPersonCamera.h"
 #include "Model.h"
+#include "GeometryGenerator.h"
 #include "Mesh.h"
 #include "SkyboxMaterial.h"
 #include "VertexDeclarations.h"
@@ -26,11 +28,9 @@ namespace Library
 
 	void Skybox::Initialize()
 	{
-		const auto model = mGame->Content().Load<Model>(L"Models\\Sphere.obj.bin");
+		const auto model = GeometryGenerator::LoadSphere(mGame->Content());
 		Mesh* mesh = model->Meshes().at(0).get();
-		VertexPosition::CreateVertexBuffer(mGame->Direct3DDevice(), *mesh, not_null<ID3D11Buffer**>(mVertexBuffer.put()));
-		mesh->CreateIndexBuffer(*mGame->Direct3DDevice(), not_null<ID3D11Buffer**>(mIndexBuffer.put()));
-		mIndexCount = narrow<uint32_t>(mesh->Indices().size());
+		mMeshBuffers = mGame->BufferCache().Get<VertexPosition>(mGame->Direct3DDevice(), *mesh);
 
 		auto textureCube = mGame->Content().Load<TextureCube>(mCubeMapFileName);
 		mMaterial = make_shared<SkyboxMaterial>(*mGame, textureCube);
@@ -49,6 +49,11 @@ namespace Library
 			});
 		}
 	}
+
+	void Skybox::DeclareAccess(ComponentAccess& access) const
+	{
+		access.Reads(mCamera.get()); // The camera's callbacks update this skybox's material
+	}
 	
 	void Skybox::Draw(const GameTime&)
 	{
@@ -60,6 +65,6 @@ namespace Library
 			mUpdateMaterial = false;
 		}
 
-		mMaterial->DrawIndexed(not_null<ID3D11Buffer*>(mVertexBuffer.get()), not_null<ID3D11Buffer*>(mIndexBuffer.get()), mIndexCount);
+		mMaterial->DrawIndexed(not_null<ID3D11Buffer*>(mMeshBuffers->VertexBuffer), not_null<ID3D11Buffer*>(mMeshBuffers->IndexBuffer), mMeshBuffers->IndexCount, mMeshBuffers->IndexFormat, mMeshBuffers->StartIndexLocation, mMeshBuffers->BaseVertexLocation);
 	}
 }
\ No newline at end of file
@@ -10,6 +10,7 @@
 namespace Library
 {
 	class SkyboxMaterial;
+	struct MeshBuffers;
 
 	class Skybox final : public DrawableGameComponent
 	{
@@ -24,6 +25,7 @@ namespace Library
 		~Skybox() = default;
 
 		virtual void Initialize() override;
+		virtual void DeclareAccess(ComponentAccess& access) const override;
 		virtual void Draw(const GameTime& gameTime) override;
 
 	private:
@@ -31,9 +33,7 @@ namespace Library
 		DirectX::XMFLOAT4X4 mWorldMatrix{ MatrixHelper::Identity };
 		float mScale;
 		std::shared_ptr<SkyboxMaterial> mMaterial;
-		winrt::com_ptr<ID3D11Buffer> mVertexBuffer;
-		winrt::com_ptr<ID3D11Buffer> mIndexBuffer;
-		std::uint32_t mIndexCount{ 0 };
+		std::shared_ptr<const MeshBuffers> mMeshBuffers;
 		bool mUpdateMaterial{ true };
 	};
 }
\ No newline at end of file
@@ -64,8 +64,7 @@ namespace Library
 		SetShader(pixelShader);
 
 		auto direct3DDevice = mGame->Direct3DDevice();
-		vertexShader->CreateInputLayout<VertexPosition>(direct3DDevice);
-		SetInputLayout(vertexShader->InputLayout());
+		SetInputLayout(mGame->ShaderCache().GetInputLayout<VertexPosition>(direct3DDevice, vertexShader->CompiledShader()));
 
 		D3D11_BUFFER_DESC constantBufferDesc{ 0 };
 		constantBufferDesc.ByteWidth = sizeof(XMFLOAT4X4);
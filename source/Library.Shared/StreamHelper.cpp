@@ -17,6 +17,13 @@ ostream& OutputStreamHelper::Stream()
 	return mStream;
 }
 
+OutputStreamHelper& OutputStreamHelper::operator<<(uint16_t value)
+{
+	WriteObject(mStream, value);
+
+	return *this;
+}
+
 OutputStreamHelper& OutputStreamHelper::operator<<(int32_t value)
 {
 	WriteObject(mStream, value);
@@ -104,6 +111,13 @@ istream& InputStreamHelper::Stream()
 	return mStream;
 }
 
+InputStreamHelper& InputStreamHelper::operator>>(uint16_t& value)
+{
+	ReadObject(mStream, value);
+
+	return *this;
+}
+
 InputStreamHelper& InputStreamHelper::operator>>(int32_t& value)
 {
 	ReadObject(mStream, value);
@@ -184,4 +198,56 @@ void InputStreamHelper::ReadObject(istream& stream, T& value)
 	}
 }
 
-#pragma endregion InputStreamHelper
\ No newline at end of file
+#pragma endregion InputStreamHelper
+
+#pragma region MemoryStreamBuffer
+
+MemoryStreamBuffer::MemoryStreamBuffer(gsl::span<const char> data)
+{
+	// The get area is never written through; streambuf simply lacks a const interface.
+	char* begin = const_cast<char*>(data.data());
+	setg(begin, begin, begin + data.size());
+}
+
+MemoryStreamBuffer::pos_type MemoryStreamBuffer::seekoff(off_type offset, ios_base::seekdir direction, ios_base::openmode mode)
+{
+	if ((mode & ios_base::in) == 0)
+	{
+		return pos_type(off_type(-1));
+	}
+
+	off_type base;
+	switch (direction)
+	{
+	case ios_base::beg:
+		base = 0;
+		break;
+
+	case ios_base::cur:
+		base = gptr() - eback();
+		break;
+
+	case ios_base::end:
+		base = egptr() - eback();
+		break;
+
+	default:
+		return pos_type(off_type(-1));
+	}
+
+	const off_type position = base + offset;
+	if (position < 0 || position > egptr() - eback())
+	{
+		return pos_type(off_type(-1));
+	}
+
+	setg(eback(), eback() + position, egptr());
+	return pos_type(position);
+}
+
+MemoryStreamBuffer::pos_type MemoryStreamBuffer::seekpos(pos_type position, ios_base::openmode mode)
+{
+	return seekoff(off_type(position), ios_base::beg, mode);
+}
+
+#pragma endregion MemoryStreamBuffer
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <iostream>
+#include <streambuf>
+#include <gsl\gsl>
 
 namespace DirectX
 {
@@ -18,6 +20,7 @@ namespace Library
 
 		std::ostream& Stream();
 
+		OutputStreamHelper& operator<<(uint16_t value);
 		OutputStreamHelper& operator<<(int32_t value);
 		OutputStreamHelper& operator<<(int64_t value);
 		OutputStreamHelper& operator<<(uint32_t value);
@@ -43,6 +46,7 @@ namespace Library
 
 		std::istream& Stream();
 
+		InputStreamHelper& operator>>(uint16_t& value);
 		InputStreamHelper& operator>>(int32_t& value);
 		InputStreamHelper& operator>>(int64_t& value);
 		InputStreamHelper& operator>>(uint32_t& value);
@@ -58,4 +62,16 @@ namespace Library
 
 		std::istream& mStream;
 	};
+
+	class MemoryStreamBuffer final : public std::streambuf
+	{
+	public:
+		MemoryStreamBuffer(gsl::span<const char> data);
+		MemoryStreamBuffer(const MemoryStreamBuffer&) = delete;
+		MemoryStreamBuffer& operator=(const MemoryStreamBuffer&) = delete;
+
+	protected:
+		pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode = std::ios_base::in) override;
+		pos_type seekpos(pos_type position, std::ios_base::openmode mode = std::ios_base::in) override;
+	};
 }
\ No newline at end of file
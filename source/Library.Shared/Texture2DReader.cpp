@@ -4,6 +4,7 @@
 #include "GameException.h"
 #include "StringHelper.h"
 #include "TextureHelper.h"
+#include "Utility.h"
 
 using namespace std;
 using namespace gsl;
@@ -21,15 +22,19 @@ namespace Library
 
 	shared_ptr<Texture2D> Texture2DReader::_Read(const wstring& assetName)
 	{
+		vector<char> textureData;
+		Utility::LoadBinaryFile(assetName, textureData);
+		auto data = reinterpret_cast<const uint8_t*>(textureData.data());
+
 		com_ptr<ID3D11Resource> resource;
 		com_ptr<ID3D11ShaderResourceView> shaderResourceView;
 		if (StringHelper::EndsWith(assetName, L".dds"))
 		{
-			ThrowIfFailed(CreateDDSTextureFromFile(mGame->Direct3DDevice(), assetName.c_str(), resource.put(), shaderResourceView.put()), "CreateDDSTextureFromFile() failed.");
+			ThrowIfFailed(CreateDDSTextureFromMemory(mGame->Direct3DDevice(), data, textureData.size(), resource.put(), shaderResourceView.put()), "CreateDDSTextureFromMemory() failed.");
 		}
 		else
 		{
-			ThrowIfFailed(CreateWICTextureFromFile(mGame->Direct3DDevice(), assetName.c_str(), resource.put(), shaderResourceView.put()), "CreateWICTextureFromFile() failed.");
+			ThrowIfFailed(CreateWICTextureFromMemory(mGame->Direct3DDevice(), data, textureData.size(), resource.put(), shaderResourceView.put()), "CreateWICTextureFromMemory() failed.");
 		}
 
 		com_ptr<ID3D11Texture2D> texture = resource.as<ID3D11Texture2D>();
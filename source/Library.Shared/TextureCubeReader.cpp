@@ -2,6 +2,7 @@
 #include "TextureCubeReader.h"
 #include "Game.h"
 #include "GameException.h"
+#include "Utility.h"
 
 using namespace std;
 using namespace DirectX;
@@ -18,8 +19,11 @@ namespace Library
 
 	shared_ptr<TextureCube> TextureCubeReader::_Read(const wstring& assetName)
 	{
-		com_ptr<ID3D11ShaderResourceView> shaderResourceView;	
-		ThrowIfFailed(CreateDDSTextureFromFile(mGame->Direct3DDevice(), assetName.c_str(), nullptr, shaderResourceView.put()), "CreateDDSTextureFromFile() failed.");
+		vector<char> textureData;
+		Utility::LoadBinaryFile(assetName, textureData);
+
+		com_ptr<ID3D11ShaderResourceView> shaderResourceView;
+		ThrowIfFailed(CreateDDSTextureFromMemory(mGame->Direct3DDevice(), reinterpret_cast<const uint8_t*>(textureData.data()), textureData.size(), nullptr, shaderResourceView.put()), "CreateDDSTextureFromMemory() failed.");
 
 		return shared_ptr<TextureCube>(new TextureCube(move(shaderResourceView)));
 	}
@@ -1,5 +1,8 @@
 #include "pch.h"
 #include "Utility.h"
+#include "ContentArchive.h"
+#include "ContentPrefetcher.h"
+#include <chrono>
 
 using namespace std;
 
@@ -7,6 +10,30 @@ namespace Library
 {
 	void Utility::LoadBinaryFile(const wstring& filename, vector<char>& data)
 	{
+		const auto& prefetcher = ContentPrefetcher::Installed();
+		if (prefetcher == nullptr)
+		{
+			ReadBinaryFile(filename, data);
+			return;
+		}
+
+		if (prefetcher->TryTake(filename, data))
+		{
+			return;
+		}
+
+		const auto startTime = chrono::high_resolution_clock::now();
+		ReadBinaryFile(filename, data);
+		prefetcher->RecordRead(filename, data.size(), chrono::duration<float, milli>(chrono::high_resolution_clock::now() - startTime).count());
+	}
+
+	void Utility::ReadBinaryFile(const wstring& filename, vector<char>& data)
+	{
+		if (ContentArchive::TryReadMounted(filename, data))
+		{
+			return;
+		}
+
 		ifstream file(filename.c_str(), ios::binary);
 		if (!file.good())
 		{
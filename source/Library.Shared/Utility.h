@@ -11,6 +11,7 @@ namespace Library
 	{
 	public:
 		static void LoadBinaryFile(const std::wstring& filename, std::vector<char>& data);
+		static void ReadBinaryFile(const std::wstring& filename, std::vector<char>& data); // Bypasses the installed ContentPrefetcher
 		static void ToWideString(const std::string& source, std::wstring& dest);
 		static std::wstring ToWideString(const std::string& source);
 		static void Totring(const std::wstring& source, std::string& dest);
@@ -9,121 +9,311 @@ using namespace DirectX;
 
 namespace Library
 {
-	void VertexPosition::CreateVertexBuffer(not_null<ID3D11Device*> device, const Mesh& mesh, not_null<ID3D11Buffer**> vertexBuffer)
+	namespace
 	{
-		const vector<XMFLOAT3>& sourceVertices = mesh.Vertices();
+		// Meshes loaded for a declaration already hold its vertices, so creating them is a single copy.
+		template <typename T>
+		bool CopyInterleavedVertices(const Mesh& mesh, vector<T>& vertices)
+		{
+			const auto interleavedVertices = mesh.Streams().InterleavedVertices(T::InputElements.data());
+			if (interleavedVertices.empty())
+			{
+				return false;
+			}
 
-		vector<VertexPosition> vertices;
-		vertices.reserve(sourceVertices.size());
+			const T* first = reinterpret_cast<const T*>(interleavedVertices.data());
+			vertices.assign(first, first + mesh.VertexCount());
+
+			return true;
+		}
+	}
+
+	span<const VertexStreamBinding> VertexPosition::StreamBindings()
+	{
+		static const VertexStreamBinding bindings[]
+		{
+			{ MeshStreamSemantic::Position, 0, offsetof(VertexPosition, Position), 4 },
+		};
+
+		return bindings;
+	}
 
-		for (size_t i = 0; i < sourceVertices.size(); i++)
+	void VertexPosition::CreateVertices(const Mesh& mesh, vector<VertexPosition>& vertices)
+	{
+		if (CopyInterleavedVertices(mesh, vertices))
 		{
-			const XMFLOAT3& position = sourceVertices.at(i);
+			return;
+		}
+
+		const span<const XMFLOAT3> sourceVertices = mesh.Vertices();
+
+		const size_t vertexCount = sourceVertices.size();
+		vertices.clear();
+		vertices.reserve(vertexCount);
+
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			const XMFLOAT3& position = sourceVertices[i];
 			vertices.emplace_back(XMFLOAT4(position.x, position.y, position.z, 1.0f));
 		}
+	}
 
+	void VertexPosition::CreateVertexBuffer(not_null<ID3D11Device*> device, const Mesh& mesh, not_null<ID3D11Buffer**> vertexBuffer)
+	{
+		vector<VertexPosition> vertices;
+		CreateVertices(mesh, vertices);
 		VertexDeclaration::CreateVertexBuffer(device, vertices, vertexBuffer);
 	}
 
-	void VertexPositionColor::CreateVertexBuffer(not_null<ID3D11Device*> device, const Mesh& mesh, not_null<ID3D11Buffer**> vertexBuffer)
+	span<const VertexStreamBinding> VertexPositionColor::StreamBindings()
 	{
-		const vector<XMFLOAT3>& sourceVertices = mesh.Vertices();
+		static const VertexStreamBinding bindings[]
+		{
+			{ MeshStreamSemantic::Position, 0, offsetof(VertexPositionColor, Position), 4 },
+			{ MeshStreamSemantic::Color, 0, offsetof(VertexPositionColor, Color), 4 },
+		};
 
-		vector<VertexPositionColor> vertices;
-		vertices.reserve(sourceVertices.size());
+		return bindings;
+	}
+
+	void VertexPositionColor::CreateVertices(const Mesh& mesh, vector<VertexPositionColor>& vertices)
+	{
+		if (CopyInterleavedVertices(mesh, vertices))
+		{
+			return;
+		}
+
+		const span<const XMFLOAT3> sourceVertices = mesh.Vertices();
+
+		const size_t vertexCount = sourceVertices.size();
+		vertices.clear();
+		vertices.reserve(vertexCount);
 
-		assert(mesh.VertexColors().size() > 0);
-		const vector<XMFLOAT4>& vertexColors = mesh.VertexColors().at(0);
+		assert(mesh.VertexColorChannelCount() > 0);
+		const span<const XMFLOAT4> vertexColors = mesh.VertexColors();
 		assert(vertexColors.size() == sourceVertices.size());
 
-		for (size_t i = 0; i < sourceVertices.size(); i++)
+		for (size_t i = 0; i < vertexCount; i++)
 		{
-			const XMFLOAT3& position = sourceVertices.at(i);
-			const XMFLOAT4& color = vertexColors.at(i);
+			const XMFLOAT3& position = sourceVertices[i];
+			const XMFLOAT4& color = vertexColors[i];
 			vertices.emplace_back(XMFLOAT4(position.x, position.y, position.z, 1.0f), color);
 		}
+	}
 
+	void VertexPositionColor::CreateVertexBuffer(not_null<ID3D11Device*> device, const Mesh& mesh, not_null<ID3D11Buffer**> vertexBuffer)
+	{
+		vector<VertexPositionColor> vertices;
+		CreateVertices(mesh, vertices);
 		VertexDeclaration::CreateVertexBuffer(device, vertices, vertexBuffer);
 	}
 
-	void VertexPositionTexture::CreateVertexBuffer(not_null<ID3D11Device*> device, const Mesh& mesh, not_null<ID3D11Buffer**> vertexBuffer)
+	span<const VertexStreamBinding> VertexPositionTexture::StreamBindings()
+	{
+		static const VertexStreamBinding bindings[]
+		{
+			{ MeshStreamSemantic::Position, 0, offsetof(VertexPositionTexture, Position), 4 },
+			{ MeshStreamSemantic::TextureCoordinate, 0, offsetof(VertexPositionTexture, TextureCoordinates), 2 },
+		};
+
+		return bindings;
+	}
+
+	void VertexPositionTexture::CreateVertices(const Mesh& mesh, vector<VertexPositionTexture>& vertices)
 	{
-		const vector<XMFLOAT3>& sourceVertices = mesh.Vertices();
-		const vector<XMFLOAT3>& textureCoordinates = mesh.TextureCoordinates().at(0);
+		if (CopyInterleavedVertices(mesh, vertices))
+		{
+			return;
+		}
+
+		const span<const XMFLOAT3> sourceVertices = mesh.Vertices();
+		const span<const XMFLOAT3> textureCoordinates = mesh.TextureCoordinates();
 		assert(textureCoordinates.size() == sourceVertices.size());
 
-		vector<VertexPositionTexture> vertices;
-		vertices.reserve(sourceVertices.size());
-		for (size_t i = 0; i < sourceVertices.size(); i++)
+		const size_t vertexCount = sourceVertices.size();
+		vertices.clear();
+		vertices.reserve(vertexCount);
+		for (size_t i = 0; i < vertexCount; i++)
 		{
-			const XMFLOAT3& position = sourceVertices.at(i);
-			const XMFLOAT3& uv = textureCoordinates.at(i);
+			const XMFLOAT3& position = sourceVertices[i];
+			const XMFLOAT3& uv = textureCoordinates[i];
 			vertices.emplace_back(XMFLOAT4(position.x, position.y, position.z, 1.0f), XMFLOAT2(uv.x, uv.y));
 		}
+	}
 
+	void VertexPositionTexture::CreateVertexBuffer(not_null<ID3D11Device*> device, const Mesh& mesh, not_null<ID3D11Buffer**> vertexBuffer)
+	{
+		vector<VertexPositionTexture> vertices;
+		CreateVertices(mesh, vertices);
 		VertexDeclaration::CreateVertexBuffer(device, vertices, vertexBuffer);
 	}
 
-	void VertexPositionNormal::CreateVertexBuffer(not_null<ID3D11Device*> device, const Mesh& mesh, not_null<ID3D11Buffer**> vertexBuffer)
+	span<const VertexStreamBinding> VertexPositionNormal::StreamBindings()
 	{
-		const vector<XMFLOAT3>& sourceVertices = mesh.Vertices();
-		const vector<XMFLOAT3>& sourceNormals = mesh.Normals();
+		static const VertexStreamBinding bindings[]
+		{
+			{ MeshStreamSemantic::Position, 0, offsetof(VertexPositionNormal, Position), 4 },
+			{ MeshStreamSemantic::Normal, 0, offsetof(VertexPositionNormal, Normal), 3 },
+		};
+
+		return bindings;
+	}
+
+	void VertexPositionNormal::CreateVertices(const Mesh& mesh, vector<VertexPositionNormal>& vertices)
+	{
+		if (CopyInterleavedVertices(mesh, vertices))
+		{
+			return;
+		}
+
+		const span<const XMFLOAT3> sourceVertices = mesh.Vertices();
+		const span<const XMFLOAT3> sourceNormals = mesh.Normals();
 		assert(sourceNormals.size() == sourceVertices.size());
 
-		vector<VertexPositionNormal> vertices;
-		vertices.reserve(sourceVertices.size());
-		for (size_t i = 0; i < sourceVertices.size(); i++)
+		const size_t vertexCount = sourceVertices.size();
+		vertices.clear();
+		vertices.reserve(vertexCount);
+		for (size_t i = 0; i < vertexCount; i++)
 		{
-			const XMFLOAT3& position = sourceVertices.at(i);
-			const XMFLOAT3& normal = sourceNormals.at(i);
+			const XMFLOAT3& position = sourceVertices[i];
+			const XMFLOAT3& normal = sourceNormals[i];
 			vertices.emplace_back(XMFLOAT4(position.x, position.y, position.z, 1.0f), normal);
 		}
+	}
 
+	void VertexPositionNormal::CreateVertexBuffer(not_null<ID3D11Device*> device, const Mesh& mesh, not_null<ID3D11Buffer**> vertexBuffer)
+	{
+		vector<VertexPositionNormal> vertices;
+		CreateVertices(mesh, vertices);
 		VertexDeclaration::CreateVertexBuffer(device, vertices, vertexBuffer);
 	}
 
-	void VertexPositionTextureNormal::CreateVertexBuffer(not_null<ID3D11Device*> device, const Mesh& mesh, not_null<ID3D11Buffer**> vertexBuffer)
+	span<const VertexStreamBinding> VertexPositionTextureNormal::StreamBindings()
 	{
-		const vector<XMFLOAT3>& sourceVertices = mesh.Vertices();
-		const auto& sourceUVs = mesh.TextureCoordinates().at(0);
+		static const VertexStreamBinding bindings[]
+		{
+			{ MeshStreamSemantic::Position, 0, offsetof(VertexPositionTextureNormal, Position), 4 },
+			{ MeshStreamSemantic::TextureCoordinate, 0, offsetof(VertexPositionTextureNormal, TextureCoordinates), 2 },
+			{ MeshStreamSemantic::Normal, 0, offsetof(VertexPositionTextureNormal, Normal), 3 },
+		};
+
+		return bindings;
+	}
+
+	void VertexPositionTextureNormal::CreateVertices(const Mesh& mesh, vector<VertexPositionTextureNormal>& vertices)
+	{
+		if (CopyInterleavedVertices(mesh, vertices))
+		{
+			return;
+		}
+
+		const span<const XMFLOAT3> sourceVertices = mesh.Vertices();
+		assert(mesh.TextureCoordinateChannelCount() > 0);
+		const auto sourceUVs = mesh.TextureCoordinates();
 		assert(sourceUVs.size() == sourceVertices.size());
-		const auto& sourceNormals = mesh.Normals();
+		const auto sourceNormals = mesh.Normals();
 		assert(sourceNormals.size() == sourceVertices.size());
 
-		vector<VertexPositionTextureNormal> vertices;
-		vertices.reserve(sourceVertices.size());
-		for (size_t i = 0; i < sourceVertices.size(); i++)
+		const size_t vertexCount = sourceVertices.size();
+		vertices.clear();
+		vertices.reserve(vertexCount);
+		for (size_t i = 0; i < vertexCount; i++)
 		{
-			const XMFLOAT3& position = sourceVertices.at(i);
-			const XMFLOAT3& uv = sourceUVs.at(i);
-			const XMFLOAT3& normal = sourceNormals.at(i);
+			const XMFLOAT3& position = sourceVertices[i];
+			const XMFLOAT3& uv = sourceUVs[i];
+			const XMFLOAT3& normal = sourceNormals[i];
 			vertices.emplace_back(XMFLOAT4(position.x, position.y, position.z, 1.0f), XMFLOAT2(uv.x, uv.y), normal);
 		}
+	}
 
+	void VertexPositionTextureNormal::CreateVertexBuffer(not_null<ID3D11Device*> device, const Mesh& mesh, not_null<ID3D11Buffer**> vertexBuffer)
+	{
+		vector<VertexPositionTextureNormal> vertices;
+		CreateVertices(mesh, vertices);
 		VertexDeclaration::CreateVertexBuffer(device, vertices, vertexBuffer);
 	}
 
-	void VertexPositionTextureNormalTangent::CreateVertexBuffer(not_null<ID3D11Device*> device, const Mesh& mesh, not_null<ID3D11Buffer**> vertexBuffer)
+	VertexQuantization VertexPositionTextureNormalPacked::Quantization(const Mesh& mesh)
+	{
+		return VertexQuantization::FromPositions(mesh.Vertices());
+	}
+
+	void VertexPositionTextureNormalPacked::CreateVertices(const Mesh& mesh, vector<VertexPositionTextureNormalPacked>& vertices)
 	{
-		const vector<XMFLOAT3>& sourceVertices = mesh.Vertices();
-		const auto& sourceUVs = mesh.TextureCoordinates().at(0);
+		const span<const XMFLOAT3> sourceVertices = mesh.Vertices();
+		assert(mesh.TextureCoordinateChannelCount() > 0);
+		const auto sourceUVs = mesh.TextureCoordinates();
 		assert(sourceUVs.size() == sourceVertices.size());
-		const auto& sourceNormals = mesh.Normals();
+		const auto sourceNormals = mesh.Normals();
 		assert(sourceNormals.size() == sourceVertices.size());
-		const auto& sourceTangents = mesh.Tangents();
+
+		const VertexQuantization quantization = Quantization(mesh);
+
+		const size_t vertexCount = sourceVertices.size();
+		vertices.clear();
+		vertices.reserve(vertexCount);
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			const XMVECTOR position = XMLoadFloat3(&sourceVertices[i]);
+			const XMVECTOR uv = XMLoadFloat3(&sourceUVs[i]);
+			const XMVECTOR normal = XMLoadFloat3(&sourceNormals[i]);
+			vertices.emplace_back(VertexPacking::PackPosition(position, quantization), VertexPacking::PackTextureCoordinates(uv), VertexPacking::PackNormal(normal));
+		}
+	}
+
+	void VertexPositionTextureNormalPacked::CreateVertexBuffer(not_null<ID3D11Device*> device, const Mesh& mesh, not_null<ID3D11Buffer**> vertexBuffer)
+	{
+		vector<VertexPositionTextureNormalPacked> vertices;
+		CreateVertices(mesh, vertices);
+		VertexDeclaration::CreateVertexBuffer(device, vertices, vertexBuffer);
+	}
+
+	span<const VertexStreamBinding> VertexPositionTextureNormalTangent::StreamBindings()
+	{
+		static const VertexStreamBinding bindings[]
+		{
+			{ MeshStreamSemantic::Position, 0, offsetof(VertexPositionTextureNormalTangent, Position), 4 },
+			{ MeshStreamSemantic::TextureCoordinate, 0, offsetof(VertexPositionTextureNormalTangent, TextureCoordinates), 2 },
+			{ MeshStreamSemantic::Normal, 0, offsetof(VertexPositionTextureNormalTangent, Normal), 3 },
+			{ MeshStreamSemantic::Tangent, 0, offsetof(VertexPositionTextureNormalTangent, Tangent), 3 },
+		};
+
+		return bindings;
+	}
+
+	void VertexPositionTextureNormalTangent::CreateVertices(const Mesh& mesh, vector<VertexPositionTextureNormalTangent>& vertices)
+	{
+		if (CopyInterleavedVertices(mesh, vertices))
+		{
+			return;
+		}
+
+		const span<const XMFLOAT3> sourceVertices = mesh.Vertices();
+		assert(mesh.TextureCoordinateChannelCount() > 0);
+		const auto sourceUVs = mesh.TextureCoordinates();
+		assert(sourceUVs.size() == sourceVertices.size());
+		const auto sourceNormals = mesh.Normals();
+		assert(sourceNormals.size() == sourceVertices.size());
+		const auto sourceTangents = mesh.Tangents();
 		assert(sourceTangents.size() == sourceVertices.size());
 
-		vector<VertexPositionTextureNormalTangent> vertices;
-		vertices.reserve(sourceVertices.size());
-		for (size_t i = 0; i < sourceVertices.size(); i++)
+		const size_t vertexCount = sourceVertices.size();
+		vertices.clear();
+		vertices.reserve(vertexCount);
+		for (size_t i = 0; i < vertexCount; i++)
 		{
-			const XMFLOAT3& position = sourceVertices.at(i);
-			const XMFLOAT3& uv = sourceUVs.at(i);
-			const XMFLOAT3& normal = sourceNormals.at(i);
-			const XMFLOAT3& tangent = sourceTangents.at(i);
+			const XMFLOAT3& position = sourceVertices[i];
+			const XMFLOAT3& uv = sourceUVs[i];
+			const XMFLOAT3& normal = sourceNormals[i];
+			const XMFLOAT3& tangent = sourceTangents[i];
 			vertices.emplace_back(XMFLOAT4(position.x, position.y, position.z, 1.0f), XMFLOAT2(uv.x, uv.y), normal, tangent);
 		}
+	}
 
+	void VertexPositionTextureNormalTangent::CreateVertexBuffer(not_null<ID3D11Device*> device, const Mesh& mesh, not_null<ID3D11Buffer**> vertexBuffer)
+	{
+		vector<VertexPositionTextureNormalTangent> vertices;
+		CreateVertices(mesh, vertices);
 		VertexDeclaration::CreateVertexBuffer(device, vertices, vertexBuffer);
 	}
 }
\ No newline at end of file
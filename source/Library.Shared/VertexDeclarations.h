@@ -1,8 +1,11 @@
 #pragma once
 
+#include <vector>
 #include <DirectXMath.h>
 #include <d3d11.h>
 #include <gsl\gsl>
+#include "VertexPacking.h"
+#include "MeshStreams.h"
 
 namespace Library
 {
@@ -35,6 +38,8 @@ namespace Library
 
 		inline static const gsl::span<const D3D11_INPUT_ELEMENT_DESC> InputElements { _InputElements };
 
+		static gsl::span<const VertexStreamBinding> StreamBindings();
+		static void CreateVertices(const Library::Mesh& mesh, std::vector<VertexPosition>& vertices);
 		static void CreateVertexBuffer(gsl::not_null<ID3D11Device*> device, const Library::Mesh& mesh, gsl::not_null<ID3D11Buffer**> vertexBuffer);
 		static void CreateVertexBuffer(gsl::not_null<ID3D11Device*> device, const gsl::span<const VertexPosition>& vertices, gsl::not_null<ID3D11Buffer**> vertexBuffer)
 		{
@@ -62,6 +67,8 @@ namespace Library
 
 		inline static const gsl::span<const D3D11_INPUT_ELEMENT_DESC> InputElements{ _InputElements };
 
+		static gsl::span<const VertexStreamBinding> StreamBindings();
+		static void CreateVertices(const Library::Mesh& mesh, std::vector<VertexPositionColor>& vertices);
 		static void CreateVertexBuffer(gsl::not_null<ID3D11Device*> device, const Library::Mesh& mesh, gsl::not_null<ID3D11Buffer**> vertexBuffer);
 		static void CreateVertexBuffer(gsl::not_null<ID3D11Device*> device, const gsl::span<const VertexPositionColor>& vertices, gsl::not_null<ID3D11Buffer**> vertexBuffer)
 		{
@@ -88,6 +95,8 @@ namespace Library
 
 		inline static const gsl::span<const D3D11_INPUT_ELEMENT_DESC> InputElements{ _InputElements };
 
+		static gsl::span<const VertexStreamBinding> StreamBindings();
+		static void CreateVertices(const Library::Mesh& mesh, std::vector<VertexPositionTexture>& vertices);
 		static void CreateVertexBuffer(gsl::not_null<ID3D11Device*> device, const Library::Mesh& mesh, gsl::not_null<ID3D11Buffer**> vertexBuffer);
 		static void CreateVertexBuffer(gsl::not_null<ID3D11Device*> device, const gsl::span<const VertexPositionTexture>& vertices, gsl::not_null<ID3D11Buffer**> vertexBuffer)
 		{
@@ -142,6 +151,8 @@ namespace Library
 
 		inline static const gsl::span<const D3D11_INPUT_ELEMENT_DESC> InputElements{ _InputElements };
 
+		static gsl::span<const VertexStreamBinding> StreamBindings();
+		static void CreateVertices(const Library::Mesh& mesh, std::vector<VertexPositionNormal>& vertices);
 		static void CreateVertexBuffer(gsl::not_null<ID3D11Device*> device, const Library::Mesh& mesh, gsl::not_null<ID3D11Buffer**> vertexBuffer);
 		static void CreateVertexBuffer(gsl::not_null<ID3D11Device*> device, const gsl::span<const VertexPositionNormal>& vertices, gsl::not_null<ID3D11Buffer**> vertexBuffer)
 		{
@@ -171,6 +182,8 @@ namespace Library
 		
 		inline static const gsl::span<const D3D11_INPUT_ELEMENT_DESC> InputElements{ _InputElements };
 
+		static gsl::span<const VertexStreamBinding> StreamBindings();
+		static void CreateVertices(const Library::Mesh& mesh, std::vector<VertexPositionTextureNormal>& vertices);
 		static void CreateVertexBuffer(gsl::not_null<ID3D11Device*> device, const Library::Mesh& mesh, gsl::not_null<ID3D11Buffer**> vertexBuffer);
 		static void CreateVertexBuffer(gsl::not_null<ID3D11Device*> device, const gsl::span<const VertexPositionTextureNormal>& vertices, gsl::not_null<ID3D11Buffer**> vertexBuffer)
 		{
@@ -178,6 +191,37 @@ namespace Library
 		}
 	};
 
+	class VertexPositionTextureNormalPacked : public VertexDeclaration<VertexPositionTextureNormalPacked>
+	{
+	private:
+		inline static const D3D11_INPUT_ELEMENT_DESC _InputElements[]
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R16G16B16A16_SNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "TEXCOORD", 0, DXGI_FORMAT_R16G16_UNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		};
+
+	public:
+		VertexPositionTextureNormalPacked() = default;
+
+		VertexPositionTextureNormalPacked(const DirectX::PackedVector::XMSHORTN4& position, const DirectX::PackedVector::XMUSHORTN2& textureCoordinates, const DirectX::PackedVector::XMSHORTN2& normal) :
+			Position(position), TextureCoordinates(textureCoordinates), Normal(normal) { }
+
+		DirectX::PackedVector::XMSHORTN4 Position; // Quantized with the mesh's VertexQuantization
+		DirectX::PackedVector::XMUSHORTN2 TextureCoordinates;
+		DirectX::PackedVector::XMSHORTN2 Normal; // Octahedral encoding
+
+		inline static const gsl::span<const D3D11_INPUT_ELEMENT_DESC> InputElements{ _InputElements };
+
+		static VertexQuantization Quantization(const Library::Mesh& mesh);
+		static void CreateVertices(const Library::Mesh& mesh, std::vector<VertexPositionTextureNormalPacked>& vertices);
+		static void CreateVertexBuffer(gsl::not_null<ID3D11Device*> device, const Library::Mesh& mesh, gsl::not_null<ID3D11Buffer**> vertexBuffer);
+		static void CreateVertexBuffer(gsl::not_null<ID3D11Device*> device, const gsl::span<const VertexPositionTextureNormalPacked>& vertices, gsl::not_null<ID3D11Buffer**> vertexBuffer)
+		{
+			VertexDeclaration::CreateVertexBuffer(device, vertices, vertexBuffer);
+		}
+	};
+
 	class VertexPositionTextureNormalTangent : public VertexDeclaration<VertexPositionTextureNormalTangent>
 	{
 	private:
@@ -202,6 +246,8 @@ namespace Library
 
 		inline static const gsl::span<const D3D11_INPUT_ELEMENT_DESC> InputElements{ _InputElements };
 
+		static gsl::span<const VertexStreamBinding> StreamBindings();
+		static void CreateVertices(const Library::Mesh& mesh, std::vector<VertexPositionTextureNormalTangent>& vertices);
 		static void CreateVertexBuffer(gsl::not_null<ID3D11Device*> device, const Library::Mesh& mesh, gsl::not_null<ID3D11Buffer**> vertexBuffer);		
 		static void CreateVertexBuffer(gsl::not_null<ID3D11Device*> device, const gsl::span<const VertexPositionTextureNormalTangent>& vertices, gsl::not_null<ID3D11Buffer**> vertexBuffer)
 		{
@@ -0,0 +1,113 @@
+#include "pch.h"
+#include "VertexPacking.h"
+
+using namespace std;
+using namespace gsl;
+using namespace DirectX;
+using namespace DirectX::PackedVector;
+
+namespace Library
+{
+	VertexQuantization VertexQuantization::FromPositions(span<const XMFLOAT3> positions)
+	{
+		VertexQuantization quantization;
+		if (positions.empty())
+		{
+			return quantization;
+		}
+
+		XMVECTOR minimum = XMLoadFloat3(&positions[0]);
+		XMVECTOR maximum = minimum;
+		for (const XMFLOAT3& position : positions)
+		{
+			const XMVECTOR value = XMLoadFloat3(&position);
+			minimum = XMVectorMin(minimum, value);
+			maximum = XMVectorMax(maximum, value);
+		}
+
+		XMStoreFloat3(&quantization.Center, XMVectorScale(XMVectorAdd(minimum, maximum), 0.5f));
+
+		XMFLOAT3 halfExtents;
+		XMStoreFloat3(&halfExtents, XMVectorScale(XMVectorSubtract(maximum, minimum), 0.5f));
+		const float scale = max(halfExtents.x, max(halfExtents.y, halfExtents.z));
+		quantization.Scale = (scale > 0.0f ? scale : 1.0f);
+
+		return quantization;
+	}
+
+	XMMATRIX VertexQuantization::DequantizationMatrix() const
+	{
+		return XMMatrixScaling(Scale, Scale, Scale) * XMMatrixTranslation(Center.x, Center.y, Center.z);
+	}
+
+	XMSHORTN4 VertexPacking::PackPosition(FXMVECTOR position, const VertexQuantization& quantization)
+	{
+		const XMVECTOR quantized = XMVectorScale(XMVectorSubtract(position, XMLoadFloat3(&quantization.Center)), 1.0f / quantization.Scale);
+
+		// w packs to exactly 1.0, so shaders can use the position without reconstructing it.
+		XMSHORTN4 packedPosition;
+		XMStoreShortN4(&packedPosition, XMVectorSetW(quantized, 1.0f));
+
+		return packedPosition;
+	}
+
+	XMVECTOR VertexPacking::UnpackPosition(const XMSHORTN4& position, const VertexQuantization& quantization)
+	{
+		const XMVECTOR quantized = XMLoadShortN4(&position);
+		return XMVectorSetW(XMVectorMultiplyAdd(quantized, XMVectorReplicate(quantization.Scale), XMLoadFloat3(&quantization.Center)), 1.0f);
+	}
+
+	XMSHORTN2 VertexPacking::PackNormal(FXMVECTOR normal)
+	{
+		XMSHORTN2 packedNormal;
+		XMStoreShortN2(&packedNormal, EncodeOctahedral(normal));
+
+		return packedNormal;
+	}
+
+	XMVECTOR VertexPacking::UnpackNormal(const XMSHORTN2& normal)
+	{
+		return DecodeOctahedral(XMLoadShortN2(&normal));
+	}
+
+	XMUSHORTN2 VertexPacking::PackTextureCoordinates(FXMVECTOR textureCoordinates)
+	{
+		// Coordinates outside [0, 1] are clamped; wrapping texture coordinates need a float format.
+		XMUSHORTN2 packedTextureCoordinates;
+		XMStoreUShortN2(&packedTextureCoordinates, textureCoordinates);
+
+		return packedTextureCoordinates;
+	}
+
+	XMVECTOR VertexPacking::UnpackTextureCoordinates(const XMUSHORTN2& textureCoordinates)
+	{
+		return XMLoadUShortN2(&textureCoordinates);
+	}
+
+	XMVECTOR VertexPacking::EncodeOctahedral(FXMVECTOR normal)
+	{
+		// Project onto the octahedron |x| + |y| + |z| = 1, then fold the lower hemisphere over the upper one.
+		const XMVECTOR zero = XMVectorZero();
+		const XMVECTOR projected = XMVectorDivide(normal, XMVector3Dot(XMVectorAbs(normal), g_XMOne));
+		const XMVECTOR signs = XMVectorSelect(g_XMOne, g_XMNegativeOne, XMVectorLess(projected, zero));
+		const XMVECTOR folded = XMVectorMultiply(XMVectorSubtract(g_XMOne, XMVectorAbs(XMVectorSwizzle<XM_SWIZZLE_Y, XM_SWIZZLE_X, XM_SWIZZLE_Z, XM_SWIZZLE_W>(projected))), signs);
+		const XMVECTOR encoded = XMVectorSelect(projected, folded, XMVectorLess(XMVectorSplatZ(projected), zero));
+
+		return XMVectorSelect(zero, encoded, g_XMSelect1100);
+	}
+
+	XMVECTOR VertexPacking::DecodeOctahedral(FXMVECTOR encodedNormal)
+	{
+		const XMVECTOR zero = XMVectorZero();
+		const XMVECTOR absolute = XMVectorAbs(encodedNormal);
+		const XMVECTOR z = XMVectorSubtract(g_XMOne, XMVectorAdd(XMVectorSplatX(absolute), XMVectorSplatY(absolute)));
+		XMVECTOR normal = XMVectorSelect(XMVectorSelect(zero, encodedNormal, g_XMSelect1100), z, g_XMSelect0010);
+
+		// Unfold the lower hemisphere: shift x and y back toward the axes by the amount z went negative.
+		const XMVECTOR t = XMVectorSaturate(XMVectorNegate(z));
+		const XMVECTOR offset = XMVectorSelect(t, XMVectorNegate(t), XMVectorGreaterOrEqual(normal, zero));
+		normal = XMVectorAdd(normal, XMVectorSelect(zero, offset, g_XMSelect1100));
+
+		return XMVector3Normalize(normal);
+	}
+}
\ No newline at end of file
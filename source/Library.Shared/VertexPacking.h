@@ -0,0 +1,44 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <DirectXPackedVector.h>
+#include <gsl\gsl>
+
+namespace Library
+{
+	/// <summary>
+	/// Maps a mesh's positions into the [-1, 1] snorm range with a uniform scale, so normals survive the dequantization matrix unchanged.
+	/// </summary>
+	struct VertexQuantization final
+	{
+		DirectX::XMFLOAT3 Center{ 0.0f, 0.0f, 0.0f };
+		float Scale{ 1.0f };
+
+		static VertexQuantization FromPositions(gsl::span<const DirectX::XMFLOAT3> positions);
+
+		DirectX::XMMATRIX DequantizationMatrix() const;
+	};
+
+	class VertexPacking final
+	{
+	public:
+		static DirectX::PackedVector::XMSHORTN4 PackPosition(DirectX::FXMVECTOR position, const VertexQuantization& quantization);
+		static DirectX::XMVECTOR UnpackPosition(const DirectX::PackedVector::XMSHORTN4& position, const VertexQuantization& quantization);
+
+		static DirectX::PackedVector::XMSHORTN2 PackNormal(DirectX::FXMVECTOR normal);
+		static DirectX::XMVECTOR UnpackNormal(const DirectX::PackedVector::XMSHORTN2& normal);
+
+		static DirectX::PackedVector::XMUSHORTN2 PackTextureCoordinates(DirectX::FXMVECTOR textureCoordinates);
+		static DirectX::XMVECTOR UnpackTextureCoordinates(const DirectX::PackedVector::XMUSHORTN2& textureCoordinates);
+
+		static DirectX::XMVECTOR EncodeOctahedral(DirectX::FXMVECTOR normal);
+		static DirectX::XMVECTOR DecodeOctahedral(DirectX::FXMVECTOR encodedNormal);
+
+		VertexPacking() = delete;
+		VertexPacking(const VertexPacking&) = delete;
+		VertexPacking& operator=(const VertexPacking&) = delete;
+		VertexPacking(VertexPacking&&) = delete;
+		VertexPacking& operator=(VertexPacking&&) = delete;
+		~VertexPacking() = default;
+	};
+}
\ No newline at end of file
@@ -19,10 +19,9 @@ namespace Library
 
 	shared_ptr<VertexShader> VertexShaderReader::_Read(const wstring& assetName)
 	{
-		com_ptr<ID3D11VertexShader> vertexShader;
 		vector<char> compiledVertexShader;
 		Utility::LoadBinaryFile(assetName, compiledVertexShader);
-		ThrowIfFailed(mGame->Direct3DDevice()->CreateVertexShader(compiledVertexShader.data(), compiledVertexShader.size(), nullptr, vertexShader.put()), "ID3D11Device::CreatedVertexShader() failed.");
+		com_ptr<ID3D11VertexShader> vertexShader = mGame->ShaderCache().GetVertexShader(mGame->Direct3DDevice(), compiledVertexShader);
 		
 		return shared_ptr<VertexShader>(new VertexShader(move(compiledVertexShader), move(vertexShader)));
 	}
@@ -0,0 +1,153 @@
+#include "pch.h"
+#include "ArchiveBuilder.h"
+#include "CompressionHelper.h"
+#include "Utility.h"
+
+using namespace std;
+using namespace std::filesystem;
+using namespace gsl;
+using namespace Library;
+
+namespace ContentPacker
+{
+	namespace
+	{
+		struct SourceEntry final
+		{
+			ContentArchive::AssetId AssetId;
+			path Filename;
+			string Name;
+		};
+
+		void WritePadding(ofstream& file, uint64_t alignment)
+		{
+			const uint64_t position = static_cast<uint64_t>(file.tellp());
+			const uint64_t padding = (alignment - (position % alignment)) % alignment;
+			for (uint64_t i = 0; i < padding; ++i)
+			{
+				file.put('\0');
+			}
+		}
+
+		void ReadSourceFile(const path& filename, vector<uint8_t>& data)
+		{
+			ifstream file(filename, ios::binary);
+			if (!file.good())
+			{
+				throw exception("Could not open content file.");
+			}
+
+			data.resize(narrow<size_t>(file_size(filename)));
+			if (data.size() > 0)
+			{
+				file.read(reinterpret_cast<char*>(data.data()), data.size());
+			}
+		}
+	}
+
+	ArchiveBuildStatistics ArchiveBuilder::Build(const path& contentDirectory, const path& archiveFilename, const ArchiveBuildSettings& settings)
+	{
+		if (settings.Alignment == 0 || (settings.Alignment & (settings.Alignment - 1)) != 0)
+		{
+			throw exception("Archive alignment must be a power of two.");
+		}
+
+		vector<SourceEntry> sources;
+		for (const auto& directoryEntry : recursive_directory_iterator(contentDirectory))
+		{
+			if (!directoryEntry.is_regular_file() || directoryEntry.path().extension() == L".pak")
+			{
+				continue;
+			}
+
+			const wstring relativeName = relative(directoryEntry.path(), contentDirectory).wstring();
+			sources.push_back({ ContentArchive::ComputeAssetId(relativeName), directoryEntry.path(), Utility::ToString(relativeName) });
+		}
+
+		sort(sources.begin(), sources.end(), [](const SourceEntry& lhs, const SourceEntry& rhs)
+		{
+			return lhs.AssetId < rhs.AssetId;
+		});
+
+		auto duplicate = adjacent_find(sources.begin(), sources.end(), [](const SourceEntry& lhs, const SourceEntry& rhs)
+		{
+			return lhs.AssetId == rhs.AssetId;
+		});
+		if (duplicate != sources.end())
+		{
+			throw exception(("Asset id collision: " + duplicate->Name + " and " + (duplicate + 1)->Name).c_str());
+		}
+
+		ofstream file(archiveFilename, ios::binary | ios::trunc);
+		if (!file.good())
+		{
+			throw exception("Could not open archive for writing.");
+		}
+
+		ContentArchiveHeader header{};
+		header.Signature = ContentArchive::Signature;
+		header.Version = ContentArchive::CurrentVersion;
+		header.EntryCount = narrow<uint32_t>(sources.size());
+		header.Alignment = settings.Alignment;
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		ArchiveBuildStatistics statistics;
+		vector<ContentArchiveEntry> entries;
+		entries.reserve(sources.size());
+		string names;
+		vector<uint8_t> sourceData;
+		vector<uint8_t> compressedData;
+
+		for (const auto& source : sources)
+		{
+			ReadSourceFile(source.Filename, sourceData);
+
+			ContentArchiveEntry entry{};
+			entry.AssetId = source.AssetId;
+			entry.Size = sourceData.size();
+			entry.Flags = ContentArchiveEntryFlags::None;
+			entry.NameOffset = narrow<uint32_t>(names.size());
+			names.append(source.Name);
+			names.push_back('\0');
+
+			span<const uint8_t> storedData(sourceData);
+			if (settings.Compress && sourceData.size() > 0)
+			{
+				CompressionHelper::Compress(sourceData, compressedData);
+				if (static_cast<double>(compressedData.size()) < static_cast<double>(sourceData.size()) * settings.MaxCompressionRatio)
+				{
+					storedData = compressedData;
+					entry.Flags = ContentArchiveEntryFlags::Compressed;
+					++statistics.CompressedEntryCount;
+				}
+			}
+
+			WritePadding(file, settings.Alignment);
+			entry.Offset = static_cast<uint64_t>(file.tellp());
+			entry.StoredSize = storedData.size();
+			file.write(reinterpret_cast<const char*>(storedData.data()), storedData.size());
+
+			entries.push_back(entry);
+			statistics.SourceBytes += entry.Size;
+		}
+
+		WritePadding(file, alignof(ContentArchiveEntry));
+		header.TableOfContentsOffset = static_cast<uint64_t>(file.tellp());
+		file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(ContentArchiveEntry));
+
+		header.NamesOffset = static_cast<uint64_t>(file.tellp());
+		header.NamesSize = names.size();
+		file.write(names.data(), names.size());
+		statistics.ArchiveBytes = static_cast<uint64_t>(file.tellp());
+
+		file.seekp(0);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		if (!file.good())
+		{
+			throw exception("Failed writing archive.");
+		}
+
+		statistics.EntryCount = header.EntryCount;
+		return statistics;
+	}
+}
\ No newline at end of file
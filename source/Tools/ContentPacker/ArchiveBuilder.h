@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include "ContentArchive.h"
+
+namespace ContentPacker
+{
+	struct ArchiveBuildSettings final
+	{
+		std::uint32_t Alignment{ Library::ContentArchive::DefaultAlignment };
+		bool Compress{ true };
+		float MaxCompressionRatio{ 0.95f };
+	};
+
+	struct ArchiveBuildStatistics final
+	{
+		std::uint32_t EntryCount{ 0 };
+		std::uint32_t CompressedEntryCount{ 0 };
+		std::uint64_t SourceBytes{ 0 };
+		std::uint64_t ArchiveBytes{ 0 };
+	};
+
+	class ArchiveBuilder final
+	{
+	public:
+		static ArchiveBuildStatistics Build(const std::filesystem::path& contentDirectory, const std::filesystem::path& archiveFilename, const ArchiveBuildSettings& settings = ArchiveBuildSettings());
+
+		ArchiveBuilder() = delete;
+		ArchiveBuilder(const ArchiveBuilder&) = delete;
+		ArchiveBuilder& operator=(const ArchiveBuilder&) = delete;
+		ArchiveBuilder(ArchiveBuilder&&) = delete;
+		ArchiveBuilder& operator=(ArchiveBuilder&&) = delete;
+		~ArchiveBuilder() = default;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "pch.h"
+#include "ArchiveBuilder.h"
+#include <chrono>
+
+using namespace std;
+using namespace std::filesystem;
+using namespace std::string_literals;
+using namespace ContentPacker;
+using namespace Library;
+
+int main(int argc, char* argv[])
+{
+#if defined(DEBUG) | defined(_DEBUG)
+	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
+#endif
+
+	try
+	{
+		if (argc < 3)
+		{
+			throw exception("Usage: ContentPacker.exe contentdirectory outputarchive [-store] [-align bytes]");
+		}
+
+		path contentDirectory(argv[1]);
+		path archiveFilename(argv[2]);
+
+		ArchiveBuildSettings settings;
+		for (int i = 3; i < argc; ++i)
+		{
+			const string option(argv[i]);
+			if (option == "-store"s)
+			{
+				settings.Compress = false;
+			}
+			else if (option == "-align"s && i + 1 < argc)
+			{
+				settings.Alignment = static_cast<uint32_t>(stoul(argv[++i]));
+			}
+			else
+			{
+				throw exception(("Unknown option: "s + option).c_str());
+			}
+		}
+
+		cout << "Packing: "s << contentDirectory << " -> "s << archiveFilename << endl;
+		const auto startTime = chrono::high_resolution_clock::now();
+		const ArchiveBuildStatistics statistics = ArchiveBuilder::Build(contentDirectory, archiveFilename, settings);
+		const chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - startTime;
+
+		cout << "Entries: "s << statistics.EntryCount << " ("s << statistics.CompressedEntryCount << " compressed)"s << endl;
+		cout << "Source bytes: "s << statistics.SourceBytes << ", archive bytes: "s << statistics.ArchiveBytes;
+		if (statistics.SourceBytes > 0)
+		{
+			cout << " ("s << fixed << setprecision(1) << (100.0 * statistics.ArchiveBytes / statistics.SourceBytes) << "%)"s;
+		}
+		cout << endl;
+		cout << "Finished in "s << fixed << setprecision(3) << elapsed.count() << "s."s << endl;
+	}
+	catch (exception ex)
+	{
+		cout << ex.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
\ No newline at end of file
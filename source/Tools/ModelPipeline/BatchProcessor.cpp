@@ -0,0 +1,276 @@
+#include "pch.h"
+#include "BatchProcessor.h"
+#include "BuildManifest.h"
+#include "ModelProcessor.h"
+#include "ObjReader.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
+#include "TangentGenerator.h"
+#include "Mesh.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+using namespace std::filesystem;
+using namespace std::string_literals;
+using namespace gsl;
+using namespace Library;
+
+namespace ModelPipeline
+{
+	namespace
+	{
+		enum class WorkResult
+		{
+			Failed,
+			Converted,
+			Unchanged
+		};
+
+		struct WorkItem final
+		{
+			path Filename;
+			FileFingerprint Input; // Size and write time only; hashed by the worker
+			const ManifestEntry* Previous{ nullptr };
+			ManifestEntry Entry;
+			WorkResult Result{ WorkResult::Failed };
+			string Error;
+		};
+
+		bool IsUpToDate(const ManifestEntry& entry, const FileFingerprint& input, const path& contentDirectory)
+		{
+			if (!BuildManifest::StatisticsMatch(entry.Input, input) || !exists(contentDirectory / u8path(entry.Output)))
+			{
+				return false;
+			}
+
+			for (const FileFingerprint& dependency : entry.Dependencies)
+			{
+				if (!BuildManifest::StatisticsMatch(dependency, BuildManifest::Fingerprint(contentDirectory / u8path(dependency.Filename), contentDirectory, false)))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		bool ContentMatches(WorkItem& item, const path& contentDirectory)
+		{
+			// The timestamps moved; only rebuild if the bytes did too.
+			const ManifestEntry& previous = *item.Previous;
+			if (previous.Input.ContentHash != item.Entry.Input.ContentHash || !exists(contentDirectory / u8path(previous.Output)))
+			{
+				return false;
+			}
+
+			vector<FileFingerprint> dependencies;
+			for (const FileFingerprint& dependency : previous.Dependencies)
+			{
+				dependencies.push_back(BuildManifest::Fingerprint(contentDirectory / u8path(dependency.Filename), contentDirectory, true));
+				if (dependencies.back().ContentHash != dependency.ContentHash)
+				{
+					return false;
+				}
+			}
+
+			item.Entry.Dependencies = move(dependencies);
+			item.Entry.Output = previous.Output;
+
+			return true;
+		}
+
+		void ProcessItem(WorkItem& item, const path& contentDirectory, const BatchSettings& settings)
+		{
+			item.Entry.Input = BuildManifest::Fingerprint(item.Filename, contentDirectory, true);
+			if (item.Previous != nullptr && ContentMatches(item, contentDirectory))
+			{
+				item.Result = WorkResult::Unchanged;
+				return;
+			}
+
+			// Files are already spread across the workers, so each one is parsed on a single thread.
+			const ObjData objData = ObjReader::Read(item.Filename, 1);
+			Model model = ModelProcessor::LoadModel(objData, settings.FlipUVs);
+			if (!model.HasMeshes())
+			{
+				throw exception("Model has no meshes.");
+			}
+
+			for (const auto& mesh : model.Meshes())
+			{
+				if (settings.GenerateTangents)
+				{
+					TangentGenerator::GenerateTangents(mesh->Data(), 1);
+				}
+
+				if (settings.GenerateLods)
+				{
+					MeshSimplifier::GenerateLods(mesh->Data());
+				}
+
+				if (settings.GenerateMeshlets)
+				{
+					MeshletBuilder::BuildMeshlets(mesh->Data());
+				}
+
+				if (settings.Optimize)
+				{
+					MeshOptimizer::Optimize(mesh->Data());
+				}
+			}
+
+			path outputFilename(item.Filename);
+			outputFilename += L".bin";
+			model.Save(outputFilename.string(), (settings.Compress ? MeshEncoding::Compressed : MeshEncoding::Raw));
+
+			item.Entry.Output = BuildManifest::RelativeName(outputFilename, contentDirectory);
+			for (const path& materialLibrary : objData.MaterialLibraries)
+			{
+				item.Entry.Dependencies.push_back(BuildManifest::Fingerprint(materialLibrary, contentDirectory, true));
+			}
+
+			item.Result = WorkResult::Converted;
+		}
+	}
+
+	BatchStatistics BatchProcessor::Run(const path& contentDirectory, const BatchSettings& settings)
+	{
+		const path manifestFilename = contentDirectory / ManifestFilename;
+		const BuildManifest manifest = BuildManifest::Load(manifestFilename);
+		const uint64_t settingsHash = SettingsHash(settings);
+		const bool rebuildAll = (settings.Force || manifest.SettingsHash != settingsHash);
+
+		BatchStatistics statistics;
+		BuildManifest updatedManifest;
+		updatedManifest.SettingsHash = settingsHash;
+
+		// Only sizes and write times are examined here (directory enumeration already has them), so an unchanged tree never opens its inputs.
+		vector<WorkItem> workItems;
+		size_t knownInputCount = 0;
+		for (const auto& directoryEntry : recursive_directory_iterator(contentDirectory))
+		{
+			if (!directoryEntry.is_regular_file() || _wcsicmp(directoryEntry.path().extension().c_str(), L".obj") != 0)
+			{
+				continue;
+			}
+
+			++statistics.InputCount;
+			WorkItem item;
+			item.Filename = directoryEntry.path();
+			item.Input.Filename = BuildManifest::RelativeName(item.Filename, contentDirectory);
+			item.Input.Size = directoryEntry.file_size();
+			item.Input.LastWriteTime = directoryEntry.last_write_time().time_since_epoch().count();
+
+			auto previous = manifest.Entries.find(item.Input.Filename);
+			if (previous != manifest.Entries.end())
+			{
+				++knownInputCount;
+				if (!rebuildAll)
+				{
+					if (IsUpToDate(previous->second, item.Input, contentDirectory))
+					{
+						updatedManifest.Entries.insert(*previous);
+						++statistics.UpToDateCount;
+						continue;
+					}
+
+					item.Previous = &previous->second;
+				}
+			}
+
+			workItems.push_back(move(item));
+		}
+
+		statistics.RemovedCount = narrow<uint32_t>(manifest.Entries.size() - knownInputCount);
+		if (workItems.empty() && statistics.RemovedCount == 0 && !rebuildAll)
+		{
+			return statistics;
+		}
+
+		const uint32_t hardwareThreadCount = max(thread::hardware_concurrency(), 1U);
+		const size_t threadCount = min<size_t>((settings.ThreadCount > 0 ? settings.ThreadCount : hardwareThreadCount), workItems.size());
+
+		atomic<size_t> nextItem{ 0 };
+		mutex outputMutex;
+		auto worker = [&]()
+		{
+			for (size_t i = nextItem++; i < workItems.size(); i = nextItem++)
+			{
+				WorkItem& item = workItems[i];
+				const auto startTime = chrono::high_resolution_clock::now();
+				try
+				{
+					ProcessItem(item, contentDirectory, settings);
+				}
+				catch (const exception& ex)
+				{
+					item.Result = WorkResult::Failed;
+					item.Error = ex.what();
+				}
+				const chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - startTime;
+
+				lock_guard<mutex> lock(outputMutex);
+				switch (item.Result)
+				{
+				case WorkResult::Converted:
+					cout << "Converted: "s << item.Input.Filename << " ("s << fixed << setprecision(3) << elapsed.count() << "s)"s << endl;
+					break;
+
+				case WorkResult::Unchanged:
+					cout << "Unchanged: "s << item.Input.Filename << endl;
+					break;
+
+				default:
+					cout << "Failed: "s << item.Input.Filename << ": "s << item.Error << endl;
+					break;
+				}
+			}
+		};
+
+		vector<thread> threads;
+		for (size_t i = 0; i < threadCount; ++i)
+		{
+			threads.emplace_back(worker);
+		}
+
+		for (thread& workerThread : threads)
+		{
+			workerThread.join();
+		}
+
+		// Failed inputs are left out of the manifest so the next run retries them.
+		for (WorkItem& item : workItems)
+		{
+			switch (item.Result)
+			{
+			case WorkResult::Converted:
+				++statistics.ConvertedCount;
+				updatedManifest.Entries[item.Input.Filename] = move(item.Entry);
+				break;
+
+			case WorkResult::Unchanged:
+				++statistics.UpToDateCount;
+				updatedManifest.Entries[item.Input.Filename] = move(item.Entry);
+				break;
+
+			default:
+				++statistics.FailedCount;
+				break;
+			}
+		}
+
+		updatedManifest.Save(manifestFilename);
+
+		return statistics;
+	}
+
+	uint64_t BatchProcessor::SettingsHash(const BatchSettings& settings)
+	{
+		const uint32_t values[] = { PipelineVersion, Model::CurrentFileVersion, (settings.FlipUVs ? 1U : 0U), (settings.Optimize ? 1U : 0U), (settings.GenerateTangents ? 1U : 0U), (settings.GenerateLods ? 1U : 0U), (settings.GenerateMeshlets ? 1U : 0U), (settings.Compress ? 1U : 0U) };
+		return BuildManifest::HashBytes(values, sizeof(values));
+	}
+}
\ No newline at end of file
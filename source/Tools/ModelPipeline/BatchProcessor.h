@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace ModelPipeline
+{
+	struct BatchSettings final
+	{
+		std::uint32_t ThreadCount{ 0 }; // 0 uses one worker per hardware thread
+		bool FlipUVs{ true };
+		bool Optimize{ true };
+		bool GenerateTangents{ true };
+		bool GenerateLods{ true };
+		bool GenerateMeshlets{ true };
+		bool Compress{ true };
+		bool Force{ false };
+	};
+
+	struct BatchStatistics final
+	{
+		std::uint32_t InputCount{ 0 };
+		std::uint32_t ConvertedCount{ 0 };
+		std::uint32_t UpToDateCount{ 0 };
+		std::uint32_t FailedCount{ 0 };
+		std::uint32_t RemovedCount{ 0 };
+	};
+
+	/// <summary>
+	/// Converts every .obj file under a content directory to a compiled model next to it (name.obj -> name.obj.bin),
+	/// skipping inputs whose content, material libraries and conversion settings are unchanged since the last run.
+	/// </summary>
+	class BatchProcessor final
+	{
+	public:
+		// Bump when the conversion itself changes in a way that should invalidate previously compiled models.
+		inline static const std::uint32_t PipelineVersion{ 1 };
+		inline static const std::wstring ManifestFilename{ L"ModelPipeline.manifest" };
+
+		static BatchStatistics Run(const std::filesystem::path& contentDirectory, const BatchSettings& settings = BatchSettings());
+		static std::uint64_t SettingsHash(const BatchSettings& settings);
+
+		BatchProcessor() = delete;
+		BatchProcessor(const BatchProcessor&) = delete;
+		BatchProcessor& operator=(const BatchProcessor&) = delete;
+		BatchProcessor(BatchProcessor&&) = delete;
+		BatchProcessor& operator=(BatchProcessor&&) = delete;
+		~BatchProcessor() = default;
+	};
+}
\ No newline at end of file
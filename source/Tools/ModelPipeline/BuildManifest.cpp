@@ -0,0 +1,186 @@
+#include "pch.h"
+#include "BuildManifest.h"
+
+using namespace std;
+using namespace std::filesystem;
+using namespace std::string_literals;
+using namespace gsl;
+
+namespace ModelPipeline
+{
+	namespace
+	{
+		const string Signature{ "ModelPipeline manifest"s };
+
+		vector<string> SplitFields(const string& line)
+		{
+			vector<string> fields;
+			size_t start = 0;
+			for (size_t tab = line.find('\t'); tab != string::npos; tab = line.find('\t', start))
+			{
+				fields.push_back(line.substr(start, tab - start));
+				start = tab + 1;
+			}
+			fields.push_back(line.substr(start));
+
+			return fields;
+		}
+
+		FileFingerprint ParseFingerprint(const vector<string>& fields)
+		{
+			FileFingerprint fingerprint;
+			fingerprint.Filename = fields[1];
+			fingerprint.Size = stoull(fields[2]);
+			fingerprint.LastWriteTime = stoll(fields[3]);
+			fingerprint.ContentHash = stoull(fields[4], nullptr, 16);
+
+			return fingerprint;
+		}
+
+		void WriteFingerprint(ofstream& file, const string& recordType, const FileFingerprint& fingerprint)
+		{
+			file << recordType << '\t' << fingerprint.Filename << '\t' << fingerprint.Size << '\t' << fingerprint.LastWriteTime << '\t';
+			file << hex << fingerprint.ContentHash << dec;
+		}
+	}
+
+	BuildManifest BuildManifest::Load(const path& filename)
+	{
+		// A missing or unreadable manifest is not an error; it just means everything gets rebuilt.
+		BuildManifest manifest;
+		ifstream file(filename);
+		if (!file.good())
+		{
+			return manifest;
+		}
+
+		try
+		{
+			string line;
+			if (!getline(file, line) || line != Signature + '\t' + to_string(FileVersion))
+			{
+				return BuildManifest();
+			}
+
+			ManifestEntry* currentEntry = nullptr;
+			while (getline(file, line))
+			{
+				const vector<string> fields = SplitFields(line);
+				if (fields[0] == "settings"s && fields.size() == 2)
+				{
+					manifest.SettingsHash = stoull(fields[1], nullptr, 16);
+				}
+				else if (fields[0] == "input"s && fields.size() == 6)
+				{
+					currentEntry = &manifest.Entries[fields[1]];
+					currentEntry->Input = ParseFingerprint(fields);
+					currentEntry->Output = fields[5];
+				}
+				else if (fields[0] == "dependency"s && fields.size() == 5 && currentEntry != nullptr)
+				{
+					currentEntry->Dependencies.push_back(ParseFingerprint(fields));
+				}
+				else
+				{
+					return BuildManifest();
+				}
+			}
+		}
+		catch (const logic_error&)
+		{
+			return BuildManifest();
+		}
+
+		return manifest;
+	}
+
+	void BuildManifest::Save(const path& filename) const
+	{
+		// Written to a temporary file first, so an interrupted run leaves the previous manifest intact.
+		path temporaryFilename(filename);
+		temporaryFilename += L".tmp";
+		{
+			ofstream file(temporaryFilename, ios::trunc);
+			if (!file.good())
+			{
+				throw exception("Could not open manifest file for writing.");
+			}
+
+			file << Signature << '\t' << FileVersion << '\n';
+			file << "settings\t"s << hex << SettingsHash << dec << '\n';
+			for (const auto& entry : Entries)
+			{
+				WriteFingerprint(file, "input"s, entry.second.Input);
+				file << '\t' << entry.second.Output << '\n';
+				for (const FileFingerprint& dependency : entry.second.Dependencies)
+				{
+					WriteFingerprint(file, "dependency"s, dependency);
+					file << '\n';
+				}
+			}
+		}
+
+		rename(temporaryFilename, filename);
+	}
+
+	string BuildManifest::RelativeName(const path& filename, const path& contentDirectory)
+	{
+		return filename.lexically_normal().lexically_relative(contentDirectory.lexically_normal()).generic_u8string();
+	}
+
+	FileFingerprint BuildManifest::Fingerprint(const path& filename, const path& contentDirectory, bool hashContent)
+	{
+		FileFingerprint fingerprint;
+		fingerprint.Filename = RelativeName(filename, contentDirectory);
+
+		error_code errorCode;
+		const uintmax_t size = file_size(filename, errorCode);
+		if (!errorCode)
+		{
+			fingerprint.Size = size;
+			fingerprint.LastWriteTime = last_write_time(filename, errorCode).time_since_epoch().count();
+			if (hashContent)
+			{
+				fingerprint.ContentHash = HashFile(filename);
+			}
+		}
+
+		return fingerprint;
+	}
+
+	bool BuildManifest::StatisticsMatch(const FileFingerprint& lhs, const FileFingerprint& rhs)
+	{
+		return lhs.Size == rhs.Size && lhs.LastWriteTime == rhs.LastWriteTime;
+	}
+
+	uint64_t BuildManifest::HashFile(const path& filename)
+	{
+		ifstream file(filename, ios::binary);
+		if (!file.good())
+		{
+			return 0;
+		}
+
+		uint64_t hash = HashOffsetBasis;
+		vector<char> buffer(64 * 1024);
+		while (file)
+		{
+			file.read(buffer.data(), narrow_cast<streamsize>(buffer.size()));
+			hash = HashBytes(buffer.data(), narrow_cast<size_t>(file.gcount()), hash);
+		}
+
+		return hash;
+	}
+
+	uint64_t BuildManifest::HashBytes(const void* data, size_t size, uint64_t hash)
+	{
+		// 64-bit FNV-1a
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash = (hash ^ bytes[i]) * 1099511628211ULL;
+		}
+
+		return hash;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ModelPipeline
+{
+	struct FileFingerprint final
+	{
+		std::string Filename; // Relative to the content directory, with generic separators
+		std::uint64_t Size{ 0 };
+		std::int64_t LastWriteTime{ 0 };
+		std::uint64_t ContentHash{ 0 };
+	};
+
+	struct ManifestEntry final
+	{
+		FileFingerprint Input;
+		std::vector<FileFingerprint> Dependencies;
+		std::string Output;
+	};
+
+	/// <summary>
+	/// Record of the last successful batch conversion of a content directory.
+	/// Sizes and write times let unchanged inputs be skipped without reading them; the content hashes decide
+	/// whether an input whose timestamp moved actually needs to be rebuilt.
+	/// </summary>
+	struct BuildManifest final
+	{
+		inline static const std::uint32_t FileVersion{ 1 };
+		inline static const std::uint64_t HashOffsetBasis{ 14695981039346656037ULL };
+
+		std::uint64_t SettingsHash{ 0 };
+		std::map<std::string, ManifestEntry> Entries;
+
+		static BuildManifest Load(const std::filesystem::path& filename);
+		void Save(const std::filesystem::path& filename) const;
+
+		static std::string RelativeName(const std::filesystem::path& filename, const std::filesystem::path& contentDirectory);
+		static FileFingerprint Fingerprint(const std::filesystem::path& filename, const std::filesystem::path& contentDirectory, bool hashContent);
+		static bool StatisticsMatch(const FileFingerprint& lhs, const FileFingerprint& rhs);
+		static std::uint64_t HashFile(const std::filesystem::path& filename);
+		static std::uint64_t HashBytes(const void* data, std::size_t size, std::uint64_t hash = HashOffsetBasis);
+	};
+}
\ No newline at end of file
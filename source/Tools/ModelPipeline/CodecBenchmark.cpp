@@ -0,0 +1,173 @@
+#include "pch.h"
+#include "CodecBenchmark.h"
+#include "Model.h"
+#include "Mesh.h"
+#include "MeshCodec.h"
+#include "StreamHelper.h"
+#include "DirectXHelper.h"
+#include <chrono>
+#include <numeric>
+
+using namespace std;
+using namespace std::filesystem;
+using namespace gsl;
+using namespace DirectX;
+using namespace Library;
+
+namespace ModelPipeline
+{
+	namespace
+	{
+		struct EncodedStream final
+		{
+			span<const byte> Elements;
+			size_t ElementSize;
+			vector<uint8_t> Data;
+		};
+
+		struct EncodedIndices final
+		{
+			span<const uint32_t> Indices;
+			vector<uint8_t> Data;
+		};
+
+		template <typename Load>
+		double Measure(uint32_t iterationCount, Load load)
+		{
+			const auto startTime = chrono::high_resolution_clock::now();
+			for (uint32_t i = 0; i < iterationCount; ++i)
+			{
+				load();
+			}
+
+			const chrono::duration<double, milli> elapsed = chrono::high_resolution_clock::now() - startTime;
+			return elapsed.count() / iterationCount;
+		}
+
+		string SaveImage(const Model& model, MeshEncoding meshEncoding)
+		{
+			ostringstream image(ios::binary);
+			model.Save(image, meshEncoding);
+
+			return image.str();
+		}
+
+		void LoadImage(const string& image)
+		{
+			MemoryStreamBuffer streamBuffer(span<const char>(image.data(), image.size()));
+			istream stream(&streamBuffer);
+			Model model(stream);
+		}
+	}
+
+	CodecBenchmarkResults CodecBenchmark::Run(const path& modelFile, uint32_t iterationCount)
+	{
+		ifstream file(modelFile, ios::binary);
+		if (!file.good())
+		{
+			throw exception("Could not open file.");
+		}
+
+		const vector<char> fileData((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+		MemoryStreamBuffer streamBuffer(fileData);
+		istream stream(&streamBuffer);
+		const Model model(stream);
+
+		CodecBenchmarkResults results;
+		results.IterationCount = max(iterationCount, 1U);
+
+		vector<EncodedStream> streams;
+		vector<EncodedIndices> indexLists;
+		for (const auto& mesh : model.Meshes())
+		{
+			auto encodeStream = [&](auto elements)
+			{
+				if (elements.empty())
+				{
+					return;
+				}
+
+				using Element = typename decltype(elements)::element_type;
+				const span<const byte> bytes(reinterpret_cast<const byte*>(elements.data()), sizeof(Element) * elements.size());
+				streams.push_back({ bytes, sizeof(Element), MeshCodec::EncodeVertices(bytes.data(), sizeof(Element), elements.size()) });
+				results.VertexBytes += bytes.size();
+				results.EncodedVertexBytes += streams.back().Data.size();
+			};
+
+			encodeStream(mesh->Vertices());
+			encodeStream(mesh->Normals());
+			encodeStream(mesh->Tangents());
+			encodeStream(mesh->BiNormals());
+			for (uint32_t channel = 0; channel < mesh->TextureCoordinateChannelCount(); ++channel)
+			{
+				encodeStream(mesh->TextureCoordinates(channel));
+			}
+
+			for (uint32_t channel = 0; channel < mesh->VertexColorChannelCount(); ++channel)
+			{
+				encodeStream(mesh->VertexColors(channel));
+			}
+
+			const span<const uint32_t> indices(mesh->Indices());
+			indexLists.push_back({ indices, MeshCodec::EncodeIndices(indices) });
+			results.IndexBytes += uint64_t(IndexFormatSize(mesh->IndexFormat())) * indices.size();
+			results.EncodedIndexBytes += indexLists.back().Data.size();
+		}
+
+		// Decode once to check the round trip, then time it
+		vector<byte> decodedVertices;
+		vector<uint32_t> decodedIndices;
+		auto decodeAll = [&](bool verify)
+		{
+			for (const EncodedStream& encodedStream : streams)
+			{
+				const size_t elementCount = encodedStream.Elements.size() / encodedStream.ElementSize;
+				decodedVertices.resize(encodedStream.Elements.size());
+				MeshCodec::DecodeVertices(encodedStream.Data, encodedStream.ElementSize, elementCount, decodedVertices.data(), encodedStream.ElementSize, encodedStream.ElementSize);
+				if (verify && !equal(decodedVertices.begin(), decodedVertices.end(), encodedStream.Elements.begin(), encodedStream.Elements.end()))
+				{
+					throw exception("Vertex stream did not survive the codec round trip.");
+				}
+			}
+
+			for (const EncodedIndices& encodedIndices : indexLists)
+			{
+				decodedIndices.resize(encodedIndices.Indices.size());
+				MeshCodec::DecodeIndices(encodedIndices.Data, decodedIndices);
+				if (verify && !equal(decodedIndices.begin(), decodedIndices.end(), encodedIndices.Indices.begin(), encodedIndices.Indices.end()))
+				{
+					throw exception("Indices did not survive the codec round trip.");
+				}
+			}
+		};
+
+		decodeAll(true);
+		results.DecodeMilliseconds = Measure(results.IterationCount, [&]()
+		{
+			decodeAll(false);
+		});
+
+		const uint64_t decodedBytes = results.VertexBytes + sizeof(uint32_t) * accumulate(indexLists.begin(), indexLists.end(), uint64_t(0), [](uint64_t total, const EncodedIndices& encodedIndices)
+		{
+			return total + encodedIndices.Indices.size();
+		});
+
+		results.DecodeGigabytesPerSecond = (results.DecodeMilliseconds > 0.0 ? static_cast<double>(decodedBytes) / (results.DecodeMilliseconds * 1.0e6) : 0.0);
+
+		const string rawImage = SaveImage(model, MeshEncoding::Raw);
+		const string compressedImage = SaveImage(model, MeshEncoding::Compressed);
+		results.RawFileBytes = rawImage.size();
+		results.CompressedFileBytes = compressedImage.size();
+		results.RawLoadMilliseconds = Measure(results.IterationCount, [&rawImage]()
+		{
+			LoadImage(rawImage);
+		});
+
+		results.CompressedLoadMilliseconds = Measure(results.IterationCount, [&compressedImage]()
+		{
+			LoadImage(compressedImage);
+		});
+
+		return results;
+	}
+}
\ No newline at end of file
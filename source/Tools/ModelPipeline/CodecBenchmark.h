@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+namespace ModelPipeline
+{
+	struct CodecBenchmarkResults final
+	{
+		std::uint32_t IterationCount{ 0 };
+		std::uint64_t VertexBytes{ 0 }; // Raw vertex streams
+		std::uint64_t EncodedVertexBytes{ 0 };
+		std::uint64_t IndexBytes{ 0 }; // At the narrowest width a raw file stores them
+		std::uint64_t EncodedIndexBytes{ 0 };
+		double DecodeMilliseconds{ 0.0 }; // Every stream and index list of the model on one thread, per iteration
+		double DecodeGigabytesPerSecond{ 0.0 }; // Decoded bytes per second
+		std::uint64_t RawFileBytes{ 0 };
+		std::uint64_t CompressedFileBytes{ 0 };
+		double RawLoadMilliseconds{ 0.0 }; // Whole model load from a file image, per iteration
+		double CompressedLoadMilliseconds{ 0.0 }; // As above, with meshes decoded in parallel
+	};
+
+	/// <summary>
+	/// Measures MeshCodec on a compiled model: compression ratios for vertex streams and indices, single-threaded decode throughput,
+	/// and whole-model load times from raw and compressed file images held in memory.
+	/// Every stream is checked to decode back to its original bytes.
+	/// </summary>
+	class CodecBenchmark final
+	{
+	public:
+		inline static const std::uint32_t DefaultIterationCount{ 20 };
+
+		static CodecBenchmarkResults Run(const std::filesystem::path& modelFile, std::uint32_t iterationCount = DefaultIterationCount);
+
+		CodecBenchmark() = delete;
+		CodecBenchmark(const CodecBenchmark&) = delete;
+		CodecBenchmark& operator=(const CodecBenchmark&) = delete;
+		CodecBenchmark(CodecBenchmark&&) = delete;
+		CodecBenchmark& operator=(CodecBenchmark&&) = delete;
+		~CodecBenchmark() = default;
+	};
+}
\ No newline at end of file
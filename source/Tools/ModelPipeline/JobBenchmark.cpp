@@ -0,0 +1,132 @@
+#include "pch.h"
+#include "JobBenchmark.h"
+#include "JobSystem.h"
+#include <chrono>
+#include <thread>
+
+using namespace std;
+using namespace gsl;
+using namespace DirectX;
+using namespace Library;
+
+namespace ModelPipeline
+{
+	namespace
+	{
+		const size_t SegmentCount = 10000; // Per orbit, as the demo draws them
+		const size_t GrainSize = 2048;
+		const size_t BlockSize = 1024; // Transforms per graph job
+
+		void GenerateOrbitVertices(JobSystem& jobs, vector<XMFLOAT4>& vertices)
+		{
+			jobs.ParallelFor(0, vertices.size(), GrainSize, [&vertices](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					const float distance = 40.0f * static_cast<float>(i / SegmentCount + 1);
+					const float angle = static_cast<float>(i % SegmentCount) * XM_2PI / static_cast<float>(SegmentCount);
+					vertices[i] = XMFLOAT4(distance * cos(angle), 0.0f, distance * sin(angle), 1.0f);
+				}
+			});
+		}
+
+		// Block b's parent is block (b - 1) / 2, so the graph is a binary tree of dependent world transform passes.
+		void UpdateTransforms(JobSystem& jobs, vector<XMFLOAT4X4>& localTransforms, vector<XMFLOAT4X4>& worldTransforms, uint32_t frame)
+		{
+			const size_t blockCount = (localTransforms.size() + BlockSize - 1) / BlockSize;
+			vector<JobHandle> worldJobs(blockCount);
+			for (size_t block = 0; block < blockCount; ++block)
+			{
+				const size_t begin = block * BlockSize;
+				const size_t end = min(begin + BlockSize, localTransforms.size());
+				const JobHandle localJob = jobs.Submit([&localTransforms, begin, end, frame]()
+				{
+					for (size_t i = begin; i < end; ++i)
+					{
+						const float angle = 0.001f * static_cast<float>(i + frame);
+						const XMMATRIX local = XMMatrixScaling(0.5f, 0.5f, 0.5f) * XMMatrixRotationY(angle) * XMMatrixRotationZ(0.1f) * XMMatrixTranslation(40.0f * cos(angle), 0.0f, 40.0f * sin(angle));
+						XMStoreFloat4x4(&localTransforms[i], local);
+					}
+				});
+
+				const JobHandle parentJob = (block > 0 ? worldJobs[(block - 1) / 2] : nullptr);
+				const size_t parentBegin = (block > 0 ? ((block - 1) / 2) * BlockSize : 0);
+				worldJobs[block] = jobs.Submit([&localTransforms, &worldTransforms, begin, end, block, parentBegin]()
+				{
+					const XMMATRIX parent = (block > 0 ? XMLoadFloat4x4(&worldTransforms[parentBegin]) : XMMatrixIdentity());
+					for (size_t i = begin; i < end; ++i)
+					{
+						XMStoreFloat4x4(&worldTransforms[i], XMLoadFloat4x4(&localTransforms[i]) * parent);
+					}
+				}, { localJob, parentJob });
+			}
+
+			jobs.Wait(worldJobs);
+		}
+
+		template <typename T>
+		bool SameBits(const vector<T>& lhs, const vector<T>& rhs)
+		{
+			return (lhs.size() == rhs.size() && memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(T)) == 0);
+		}
+	}
+
+	JobBenchmarkResults JobBenchmark::Run(uint32_t itemCount, uint32_t iterationCount)
+	{
+		JobBenchmarkResults results;
+		results.ItemCount = max(itemCount, 1U);
+		results.IterationCount = max(iterationCount, 1U);
+
+		vector<uint32_t> threadCounts{ JobSystem::SingleThreaded };
+		const uint32_t hardwareThreadCount = max(thread::hardware_concurrency(), 1U);
+		while (threadCounts.back() < hardwareThreadCount)
+		{
+			threadCounts.push_back(min(threadCounts.back() * 2, hardwareThreadCount));
+		}
+
+		vector<XMFLOAT4> referenceVertices;
+		vector<XMFLOAT4X4> referenceTransforms;
+		for (uint32_t threadCount : threadCounts)
+		{
+			JobSystem jobs(threadCount);
+			JobBenchmarkResult result;
+			result.ThreadCount = jobs.ThreadCount();
+
+			vector<XMFLOAT4> vertices(results.ItemCount);
+			auto startTime = chrono::high_resolution_clock::now();
+			for (uint32_t i = 0; i < results.IterationCount; ++i)
+			{
+				GenerateOrbitVertices(jobs, vertices);
+			}
+
+			chrono::duration<double, milli> elapsed = chrono::high_resolution_clock::now() - startTime;
+			result.ParallelForMilliseconds = elapsed.count() / results.IterationCount;
+
+			vector<XMFLOAT4X4> localTransforms(results.ItemCount);
+			vector<XMFLOAT4X4> worldTransforms(results.ItemCount);
+			startTime = chrono::high_resolution_clock::now();
+			for (uint32_t i = 0; i < results.IterationCount; ++i)
+			{
+				UpdateTransforms(jobs, localTransforms, worldTransforms, i);
+			}
+
+			elapsed = chrono::high_resolution_clock::now() - startTime;
+			result.GraphMilliseconds = elapsed.count() / results.IterationCount;
+
+			if (referenceVertices.empty())
+			{
+				referenceVertices = move(vertices);
+				referenceTransforms = move(worldTransforms);
+				result.Identical = true;
+			}
+			else
+			{
+				result.Identical = SameBits(vertices, referenceVertices) && SameBits(worldTransforms, referenceTransforms);
+			}
+
+			results.Results.push_back(result);
+		}
+
+		return results;
+	}
+}
\ No newline at end of file
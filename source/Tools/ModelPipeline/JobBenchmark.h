@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace ModelPipeline
+{
+	struct JobBenchmarkResult final
+	{
+		std::uint32_t ThreadCount{ 0 };
+		double ParallelForMilliseconds{ 0.0 }; // Per iteration
+		double GraphMilliseconds{ 0.0 }; // Per iteration
+		bool Identical{ false }; // Both workloads reproduced the single-threaded results bit for bit
+	};
+
+	struct JobBenchmarkResults final
+	{
+		std::uint32_t ItemCount{ 0 };
+		std::uint32_t IterationCount{ 0 };
+		std::vector<JobBenchmarkResult> Results; // Thread counts doubling from 1 up to the hardware's
+	};
+
+	/// <summary>
+	/// Measures how JobSystem scales with thread count on two workloads shaped like the demo's:
+	/// - ParallelFor: orbit-line style vertex generation, one independent vertex per item;
+	/// - Graph: per-block transforms submitted as jobs, each block's world transforms depending on its own local pass and its parent block's,
+	///   the way a moon's orbit depends on its planet's.
+	/// </summary>
+	class JobBenchmark final
+	{
+	public:
+		inline static const std::uint32_t DefaultItemCount{ 1 << 20 };
+		inline static const std::uint32_t DefaultIterationCount{ 20 };
+
+		static JobBenchmarkResults Run(std::uint32_t itemCount = DefaultItemCount, std::uint32_t iterationCount = DefaultIterationCount);
+
+		JobBenchmark() = delete;
+		JobBenchmark(const JobBenchmark&) = delete;
+		JobBenchmark& operator=(const JobBenchmark&) = delete;
+		JobBenchmark(JobBenchmark&&) = delete;
+		JobBenchmark& operator=(JobBenchmark&&) = delete;
+		~JobBenchmark() = default;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include "pch.h"
+#include "LoadBenchmark.h"
+#include "Model.h"
+#include "Mesh.h"
+#include "StreamHelper.h"
+#include "VertexDeclarations.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+using namespace std::filesystem;
+using namespace gsl;
+using namespace Library;
+
+namespace
+{
+	atomic<uint64_t> AllocationCount{ 0 };
+	atomic<uint64_t> AllocatedBytes{ 0 };
+}
+
+void* operator new(size_t size)
+{
+	++AllocationCount;
+	AllocatedBytes += size;
+
+	void* memory = malloc(size > 0 ? size : 1);
+	if (memory == nullptr)
+	{
+		throw bad_alloc();
+	}
+
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+namespace ModelPipeline
+{
+	namespace
+	{
+		uint64_t StreamBytes(const Mesh& mesh)
+		{
+			uint64_t bytes = sizeof(DirectX::XMFLOAT3) * uint64_t(mesh.Vertices().size() + mesh.Normals().size() + mesh.Tangents().size() + mesh.BiNormals().size());
+			for (uint32_t channel = 0; channel < mesh.TextureCoordinateChannelCount(); ++channel)
+			{
+				bytes += sizeof(DirectX::XMFLOAT3) * uint64_t(mesh.TextureCoordinates(channel).size());
+			}
+
+			for (uint32_t channel = 0; channel < mesh.VertexColorChannelCount(); ++channel)
+			{
+				bytes += sizeof(DirectX::XMFLOAT4) * uint64_t(mesh.VertexColors(channel).size());
+			}
+
+			return bytes;
+		}
+
+		template <typename Load>
+		LoadBenchmarkResult Measure(uint32_t iterationCount, Load load)
+		{
+			LoadBenchmarkResult result;
+			const uint64_t startAllocationCount = AllocationCount;
+			const uint64_t startAllocatedBytes = AllocatedBytes;
+			const auto startTime = chrono::high_resolution_clock::now();
+
+			for (uint32_t i = 0; i < iterationCount; ++i)
+			{
+				load(result);
+			}
+
+			const chrono::duration<double, milli> elapsed = chrono::high_resolution_clock::now() - startTime;
+			result.Milliseconds = elapsed.count() / iterationCount;
+			result.AllocationCount = (AllocationCount - startAllocationCount) / iterationCount;
+			result.AllocatedBytes = (AllocatedBytes - startAllocatedBytes) / iterationCount;
+			result.CopiedBytes /= iterationCount;
+			result.VertexBytes /= iterationCount;
+
+			return result;
+		}
+
+		template <typename T>
+		LoadBenchmarkResults Benchmark(span<const char> fileData, uint32_t iterationCount, const string& declarationName)
+		{
+			LoadBenchmarkResults results;
+			results.VertexDeclaration = declarationName;
+			results.IterationCount = iterationCount;
+
+			results.PerStream = Measure(iterationCount, [fileData](LoadBenchmarkResult& result)
+			{
+				MemoryStreamBuffer streamBuffer(fileData);
+				istream stream(&streamBuffer);
+				Model model(stream);
+
+				for (const auto& mesh : model.Meshes())
+				{
+					// As MeshBufferCache does, each mesh builds its vertices into a fresh upload vector.
+					vector<T> vertices;
+					T::CreateVertices(*mesh, vertices);
+
+					// File to per-stream vectors, those into the packed block, then the interleaving copy
+					const uint64_t vertexBytes = uint64_t(T::VertexSize()) * vertices.size();
+					result.CopiedBytes += 2 * StreamBytes(*mesh) + vertexBytes;
+					result.VertexBytes += vertexBytes;
+				}
+			});
+
+			const InterleavedVertexLayout layout = InterleavedVertexLayout::For<T>();
+			results.Interleaved = Measure(iterationCount, [fileData, &layout](LoadBenchmarkResult& result)
+			{
+				MemoryStreamBuffer streamBuffer(fileData);
+				istream stream(&streamBuffer);
+				Model model(stream, &layout);
+
+				for (const auto& mesh : model.Meshes())
+				{
+					// The mesh's storage is the upload memory; each bound element is written once, straight from the file image.
+					const uint64_t vertexBytes = mesh->Streams().InterleavedVertices(layout.VertexFormat).size();
+					result.CopiedBytes += vertexBytes;
+					result.VertexBytes += vertexBytes;
+				}
+			});
+
+			return results;
+		}
+	}
+
+	LoadBenchmarkResults LoadBenchmark::Run(const path& modelFile, uint32_t iterationCount)
+	{
+		ifstream file(modelFile, ios::binary);
+		if (!file.good())
+		{
+			throw exception("Could not open file.");
+		}
+
+		const vector<char> fileData((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+		iterationCount = max(iterationCount, 1U);
+
+		// Benchmark the richest declaration every mesh can fill.
+		bool hasNormalsAndTextureCoordinates = true;
+		{
+			MemoryStreamBuffer streamBuffer(fileData);
+			istream stream(&streamBuffer);
+			Model model(stream);
+			for (const auto& mesh : model.Meshes())
+			{
+				const size_t vertexCount = mesh->VertexCount();
+				hasNormalsAndTextureCoordinates = hasNormalsAndTextureCoordinates && size_t(mesh->Normals().size()) == vertexCount && size_t(mesh->TextureCoordinates().size()) == vertexCount;
+			}
+		}
+
+		if (hasNormalsAndTextureCoordinates)
+		{
+			return Benchmark<VertexPositionTextureNormal>(fileData, iterationCount, "VertexPositionTextureNormal");
+		}
+
+		return Benchmark<VertexPosition>(fileData, iterationCount, "VertexPosition");
+	}
+}
\ No newline at end of file
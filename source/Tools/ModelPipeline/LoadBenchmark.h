@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace ModelPipeline
+{
+	struct LoadBenchmarkResult final
+	{
+		double Milliseconds{ 0.0 }; // Per load, averaged over the iterations
+		std::uint64_t AllocationCount{ 0 }; // Per load
+		std::uint64_t AllocatedBytes{ 0 }; // Per load
+		std::uint64_t CopiedBytes{ 0 }; // Vertex bytes written between the file image and the upload memory, per load
+		std::uint64_t VertexBytes{ 0 }; // Size of the finished interleaved vertices
+	};
+
+	struct LoadBenchmarkResults final
+	{
+		std::string VertexDeclaration;
+		std::uint32_t IterationCount{ 0 };
+		LoadBenchmarkResult PerStream;
+		LoadBenchmarkResult Interleaved;
+	};
+
+	/// <summary>
+	/// Times a compiled model being turned into upload-ready vertices two ways:
+	/// - the per-stream path: Model load into MeshStreams, then CreateVertices;
+	/// - the interleaved path: Model load straight into the vertex declaration's layout.
+	/// The file is read into memory once, so only parsing and vertex building are measured.
+	/// The tool replaces the global operator new to count allocations.
+	/// </summary>
+	class LoadBenchmark final
+	{
+	public:
+		inline static const std::uint32_t DefaultIterationCount{ 20 };
+
+		static LoadBenchmarkResults Run(const std::filesystem::path& modelFile, std::uint32_t iterationCount = DefaultIterationCount);
+
+		LoadBenchmark() = delete;
+		LoadBenchmark(const LoadBenchmark&) = delete;
+		LoadBenchmark& operator=(const LoadBenchmark&) = delete;
+		LoadBenchmark(LoadBenchmark&&) = delete;
+		LoadBenchmark& operator=(LoadBenchmark&&) = delete;
+		~LoadBenchmark() = default;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,350 @@
+#include "pch.h"
+#include "MeshOptimizer.h"
+#include "Mesh.h"
+
+using namespace std;
+using namespace gsl;
+using namespace DirectX;
+using namespace Library;
+
+namespace ModelPipeline
+{
+	namespace
+	{
+		const uint32_t CacheSize = 32;
+		const uint32_t MaxValence = 32;
+		const float CacheDecayPower = 1.5f;
+		const float LastTriangleScore = 0.75f;
+		const float ValenceBoostScale = 2.0f;
+		const float ValenceBoostPower = 0.5f;
+
+		struct ScoreTables final
+		{
+			ScoreTables()
+			{
+				for (uint32_t i = 0; i < CacheSize; ++i)
+				{
+					// The three most recently used vertices get a fixed score so the next triangle doesn't just reuse the last one.
+					CachePosition[i] = (i < 3 ? LastTriangleScore : powf(1.0f - static_cast<float>(i - 3) / static_cast<float>(CacheSize - 3), CacheDecayPower));
+				}
+
+				Valence[0] = 0.0f;
+				for (uint32_t i = 1; i <= MaxValence; ++i)
+				{
+					Valence[i] = ValenceBoostScale * powf(static_cast<float>(i), -ValenceBoostPower);
+				}
+			}
+
+			float CachePosition[CacheSize];
+			float Valence[MaxValence + 1];
+		};
+
+		float VertexScore(const ScoreTables& tables, int32_t cachePosition, uint32_t remainingTriangleCount)
+		{
+			if (remainingTriangleCount == 0)
+			{
+				return -1.0f;
+			}
+
+			const float cacheScore = (cachePosition >= 0 ? tables.CachePosition[cachePosition] : 0.0f);
+			const float valenceScore = (remainingTriangleCount <= MaxValence ? tables.Valence[remainingTriangleCount] : ValenceBoostScale * powf(static_cast<float>(remainingTriangleCount), -ValenceBoostPower));
+
+			return cacheScore + valenceScore;
+		}
+
+		template <typename T>
+		void RemapStream(vector<T>& stream, const vector<uint32_t>& newToOld)
+		{
+			// Channels that don't carry one element per vertex are left alone.
+			if (stream.size() != newToOld.size())
+			{
+				return;
+			}
+
+			vector<T> remapped;
+			remapped.reserve(stream.size());
+			for (uint32_t oldIndex : newToOld)
+			{
+				remapped.push_back(stream[oldIndex]);
+			}
+
+			stream = move(remapped);
+		}
+	}
+
+	void MeshOptimizer::Optimize(MeshData& meshData)
+	{
+		// Each level of detail is drawn on its own, so triangles are only reordered within their level.
+		// Meshlets are culled individually, so the full-detail level is reordered within each meshlet instead.
+		const uint32_t vertexCount = narrow<uint32_t>(meshData.Vertices.size());
+		const span<uint32_t> indices(meshData.Indices);
+		if (meshData.Lods.empty())
+		{
+			if (meshData.Meshlets.empty())
+			{
+				OptimizeVertexCache(indices, vertexCount);
+			}
+		}
+		else
+		{
+			for (size_t i = (meshData.Meshlets.empty() ? 0 : 1); i < meshData.Lods.size(); ++i)
+			{
+				OptimizeVertexCache(indices.subspan(meshData.Lods[i].StartIndex, meshData.Lods[i].IndexCount), vertexCount);
+			}
+		}
+
+		for (const Meshlet& meshlet : meshData.Meshlets)
+		{
+			OptimizeVertexCache(indices.subspan(meshlet.StartIndex, meshlet.IndexCount), vertexCount);
+		}
+
+		OptimizeVertexFetch(meshData);
+	}
+
+	void MeshOptimizer::OptimizeVertexCache(span<uint32_t> indices, uint32_t vertexCount)
+	{
+		assert(indices.size() % 3 == 0);
+		const uint32_t triangleCount = narrow<uint32_t>(indices.size() / 3);
+		if (triangleCount == 0)
+		{
+			return;
+		}
+
+		static const ScoreTables tables;
+
+		// Vertex -> triangle adjacency in a single array. Each vertex's live triangles occupy the front of its slice.
+		vector<uint32_t> remainingTriangleCounts(vertexCount, 0);
+		for (uint32_t index : indices)
+		{
+			assert(index < vertexCount);
+			++remainingTriangleCounts[index];
+		}
+
+		vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+		for (uint32_t i = 0; i < vertexCount; ++i)
+		{
+			adjacencyOffsets[i + 1] = adjacencyOffsets[i] + remainingTriangleCounts[i];
+		}
+
+		vector<uint32_t> adjacency(indices.size());
+		{
+			vector<uint32_t> fillCounts(vertexCount, 0);
+			for (uint32_t triangle = 0; triangle < triangleCount; ++triangle)
+			{
+				for (uint32_t corner = 0; corner < 3; ++corner)
+				{
+					const uint32_t vertex = indices[triangle * 3 + corner];
+					adjacency[adjacencyOffsets[vertex] + fillCounts[vertex]++] = triangle;
+				}
+			}
+		}
+
+		vector<int32_t> cachePositions(vertexCount, -1);
+		vector<float> vertexScores(vertexCount);
+		for (uint32_t i = 0; i < vertexCount; ++i)
+		{
+			vertexScores[i] = VertexScore(tables, -1, remainingTriangleCounts[i]);
+		}
+
+		vector<float> triangleScores(triangleCount);
+		vector<bool> emitted(triangleCount, false);
+		uint32_t bestTriangle = 0;
+		for (uint32_t triangle = 0; triangle < triangleCount; ++triangle)
+		{
+			triangleScores[triangle] = vertexScores[indices[triangle * 3]] + vertexScores[indices[triangle * 3 + 1]] + vertexScores[indices[triangle * 3 + 2]];
+			if (triangleScores[triangle] > triangleScores[bestTriangle])
+			{
+				bestTriangle = triangle;
+			}
+		}
+
+		vector<uint32_t> optimizedIndices;
+		optimizedIndices.reserve(indices.size());
+		vector<uint32_t> cache;
+		cache.reserve(CacheSize + 3);
+		vector<uint32_t> newCache;
+		newCache.reserve(CacheSize + 3);
+		uint32_t scanPosition = 0;
+
+		while (true)
+		{
+			emitted[bestTriangle] = true;
+			const uint32_t triangleVertices[3]{ indices[bestTriangle * 3], indices[bestTriangle * 3 + 1], indices[bestTriangle * 3 + 2] };
+
+			newCache.clear();
+			for (uint32_t vertex : triangleVertices)
+			{
+				optimizedIndices.push_back(vertex);
+				newCache.push_back(vertex);
+
+				// Retire the emitted triangle from the vertex's live slice.
+				uint32_t* begin = &adjacency[adjacencyOffsets[vertex]];
+				uint32_t* end = begin + remainingTriangleCounts[vertex];
+				uint32_t* it = find(begin, end, bestTriangle);
+				assert(it != end);
+				*it = *(end - 1);
+				--remainingTriangleCounts[vertex];
+			}
+
+			if (optimizedIndices.size() == indices.size())
+			{
+				break;
+			}
+
+			for (uint32_t vertex : cache)
+			{
+				if (vertex != triangleVertices[0] && vertex != triangleVertices[1] && vertex != triangleVertices[2])
+				{
+					newCache.push_back(vertex);
+				}
+			}
+
+			// Vertices pushed past the end of the cache lose their cache score.
+			for (size_t i = CacheSize; i < newCache.size(); ++i)
+			{
+				cachePositions[newCache[i]] = -1;
+			}
+
+			if (newCache.size() > CacheSize)
+			{
+				newCache.resize(CacheSize);
+			}
+
+			for (uint32_t i = 0; i < newCache.size(); ++i)
+			{
+				cachePositions[newCache[i]] = static_cast<int32_t>(i);
+			}
+
+			auto updateVertex = [&](uint32_t vertex)
+			{
+				const float score = VertexScore(tables, cachePositions[vertex], remainingTriangleCounts[vertex]);
+				const float delta = score - vertexScores[vertex];
+				vertexScores[vertex] = score;
+
+				const uint32_t* begin = &adjacency[adjacencyOffsets[vertex]];
+				for (const uint32_t* it = begin; it != begin + remainingTriangleCounts[vertex]; ++it)
+				{
+					triangleScores[*it] += delta;
+				}
+			};
+
+			for (uint32_t vertex : cache)
+			{
+				if (cachePositions[vertex] < 0)
+				{
+					updateVertex(vertex);
+				}
+			}
+
+			for (uint32_t vertex : newCache)
+			{
+				updateVertex(vertex);
+			}
+
+			swap(cache, newCache);
+
+			// The next triangle is the best one touching the cache; only a cache with no live triangles needs a scan.
+			float bestScore = -1.0f;
+			for (uint32_t vertex : cache)
+			{
+				const uint32_t* begin = &adjacency[adjacencyOffsets[vertex]];
+				for (const uint32_t* it = begin; it != begin + remainingTriangleCounts[vertex]; ++it)
+				{
+					if (triangleScores[*it] > bestScore)
+					{
+						bestScore = triangleScores[*it];
+						bestTriangle = *it;
+					}
+				}
+			}
+
+			if (bestScore < 0.0f)
+			{
+				while (emitted[scanPosition])
+				{
+					++scanPosition;
+				}
+
+				bestTriangle = scanPosition;
+			}
+		}
+
+		copy(optimizedIndices.begin(), optimizedIndices.end(), indices.begin());
+	}
+
+	void MeshOptimizer::OptimizeVertexFetch(MeshData& meshData)
+	{
+		const uint32_t vertexCount = narrow<uint32_t>(meshData.Vertices.size());
+		const uint32_t unassigned = numeric_limits<uint32_t>::max();
+
+		// Number vertices in the order the index buffer first touches them; unreferenced vertices go last.
+		vector<uint32_t> oldToNew(vertexCount, unassigned);
+		vector<uint32_t> newToOld;
+		newToOld.reserve(vertexCount);
+		for (uint32_t& index : meshData.Indices)
+		{
+			if (oldToNew[index] == unassigned)
+			{
+				oldToNew[index] = narrow_cast<uint32_t>(newToOld.size());
+				newToOld.push_back(index);
+			}
+
+			index = oldToNew[index];
+		}
+
+		for (uint32_t i = 0; i < vertexCount; ++i)
+		{
+			if (oldToNew[i] == unassigned)
+			{
+				oldToNew[i] = narrow_cast<uint32_t>(newToOld.size());
+				newToOld.push_back(i);
+			}
+		}
+
+		RemapStream(meshData.Vertices, newToOld);
+		RemapStream(meshData.Normals, newToOld);
+		RemapStream(meshData.Tangents, newToOld);
+		RemapStream(meshData.BiNormals, newToOld);
+		for (auto& textureCoordinates : meshData.TextureCoordinates)
+		{
+			RemapStream(textureCoordinates, newToOld);
+		}
+
+		for (auto& vertexColors : meshData.VertexColors)
+		{
+			RemapStream(vertexColors, newToOld);
+		}
+	}
+
+	VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize)
+	{
+		assert(cacheSize > 0);
+
+		// FIFO cache, as implemented by most post-transform caches.
+		vector<uint32_t> timestamps(vertexCount, 0);
+		uint32_t transformedVertexCount = 0;
+		for (uint32_t index : indices)
+		{
+			assert(index < vertexCount);
+			if (timestamps[index] == 0 || transformedVertexCount - timestamps[index] >= cacheSize)
+			{
+				++transformedVertexCount;
+				timestamps[index] = transformedVertexCount;
+			}
+		}
+
+		VertexCacheStatistics statistics;
+		statistics.TransformedVertexCount = transformedVertexCount;
+		if (indices.size() > 0)
+		{
+			statistics.Acmr = static_cast<float>(transformedVertexCount) / static_cast<float>(indices.size() / 3);
+		}
+
+		if (vertexCount > 0)
+		{
+			statistics.Atvr = static_cast<float>(transformedVertexCount) / static_cast<float>(vertexCount);
+		}
+
+		return statistics;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <gsl\gsl>
+
+namespace Library
+{
+	struct MeshData;
+}
+
+namespace ModelPipeline
+{
+	struct VertexCacheStatistics final
+	{
+		std::uint32_t TransformedVertexCount{ 0 };
+		float Acmr{ 0.0f }; // Average cache miss ratio: transformed vertices per triangle (0.5 is the ideal for large regular grids, 3.0 the worst case)
+		float Atvr{ 0.0f }; // Average transformed vertex ratio: transformed vertices per unique vertex (1.0 is the ideal)
+	};
+
+	/// <summary>
+	/// Offline index and vertex reordering for the post-transform vertex cache and vertex fetch locality.
+	/// The triangle order follows Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+	/// </summary>
+	class MeshOptimizer final
+	{
+	public:
+		inline static const std::uint32_t DefaultCacheSize{ 16 };
+
+		MeshOptimizer() = delete;
+
+		static void Optimize(Library::MeshData& meshData);
+		static void OptimizeVertexCache(gsl::span<std::uint32_t> indices, std::uint32_t vertexCount);
+		static void OptimizeVertexFetch(Library::MeshData& meshData);
+		static VertexCacheStatistics AnalyzeVertexCache(gsl::span<const std::uint32_t> indices, std::uint32_t vertexCount, std::uint32_t cacheSize = DefaultCacheSize);
+	};
+}
\ No newline at end of file
@@ -1,9 +1,10 @@
 #include "pch.h"
 #include "MeshProcessor.h"
+#include "ObjReader.h"
 #include "Model.h"
 #include "Mesh.h"
-//#include <assimp/Importer.hpp>
-//#include <assimp/scene.h>
+#include "ModelMaterial.h"
+#include <unordered_map>
 
 using namespace std;
 using namespace gsl;
@@ -12,93 +13,104 @@ using namespace Library;
 
 namespace ModelPipeline
 {
-	/*shared_ptr<Library::Mesh> MeshProcessor::LoadMesh(Library::Model& model, aiMesh& mesh)
+	namespace
 	{
-		MeshData meshData;
-
-		meshData.Material = model.Materials().at(mesh.mMaterialIndex);
+		// Position, texture coordinate and normal, compared bit for bit so that only exact duplicates are welded.
+		using VertexKey = array<uint32_t, 9>;
 
-		// Vertices
+		struct VertexKeyHash final
 		{
-			meshData.Vertices.reserve(mesh.mNumVertices);
-			for (unsigned int i = 0; i < mesh.mNumVertices; i++)
+			size_t operator()(const VertexKey& key) const
 			{
-				meshData.Vertices.emplace_back(reinterpret_cast<const float*>(&mesh.mVertices[i]));
+				uint64_t hash = 14695981039346656037ULL;
+				for (uint32_t value : key)
+				{
+					hash = (hash ^ value) * 1099511628211ULL;
+				}
+
+				return static_cast<size_t>(hash);
 			}
+		};
+
+		void StoreKey(VertexKey& key, size_t offset, const XMFLOAT3& value)
+		{
+			memcpy(&key[offset], &value, sizeof(XMFLOAT3));
 		}
+	}
 
-		// Normals
-		if (mesh.HasNormals())
+	shared_ptr<Library::Mesh> MeshProcessor::LoadMesh(Library::Model& model, const ObjData& objData, const ObjGroup& group, bool flipUVs)
+	{
+		MeshData meshData;
+		meshData.Name = group.Name;
+
+		for (const auto& material : model.Materials())
 		{
-			meshData.Normals.reserve(mesh.mNumVertices);
-			for (unsigned int i = 0; i < mesh.mNumVertices; i++)
+			if (material->Name() == group.MaterialName)
 			{
-				meshData.Normals.emplace_back(reinterpret_cast<const float*>(&mesh.mNormals[i]));
+				meshData.Material = material;
+				break;
 			}
 		}
 
-		// Tangents and Binormals
-		if (mesh.HasTangentsAndBitangents())
+		if (meshData.Material == nullptr && model.HasMaterials())
 		{
-			meshData.Tangents.reserve(mesh.mNumVertices);
-			meshData.BiNormals.reserve(mesh.mNumVertices);
-			for (unsigned int i = 0; i < mesh.mNumVertices; i++)
-			{
-				meshData.Tangents.emplace_back(reinterpret_cast<const float*>(&mesh.mTangents[i]));
-				meshData.BiNormals.emplace_back(reinterpret_cast<const float*>(&mesh.mBitangents[i]));
-			}
+			meshData.Material = model.Materials().front();
 		}
 
-		// Texture Coordinates
+		const bool hasTextureCoordinates = all_of(group.Corners.begin(), group.Corners.end(), [](const ObjCorner& corner) { return corner.TextureCoordinate >= 0; });
+		const bool hasNormals = all_of(group.Corners.begin(), group.Corners.end(), [](const ObjCorner& corner) { return corner.Normal >= 0; });
+
+		vector<XMFLOAT3> textureCoordinates;
+		unordered_map<VertexKey, uint32_t, VertexKeyHash> vertexIndices;
+		vertexIndices.reserve(group.Corners.size() / 2);
+		meshData.Indices.reserve(group.Corners.size());
+
+		for (size_t triangle = 0; triangle < group.Corners.size(); triangle += 3)
 		{
-			unsigned int uvChannelCount = mesh.GetNumUVChannels();
-			meshData.TextureCoordinates.reserve(uvChannelCount);
-			for (unsigned int i = 0; i < uvChannelCount; i++)
+			// OBJ winds counter-clockwise; Direct3D's default front face is clockwise.
+			for (size_t corner : { triangle, triangle + 2, triangle + 1 })
 			{
-				vector<XMFLOAT3> textureCoordinates;
-				textureCoordinates.reserve(mesh.mNumVertices);
-				aiVector3D* aiTextureCoordinates = mesh.mTextureCoords[i];
-				for (unsigned int j = 0; j < mesh.mNumVertices; j++)
+				const ObjCorner& objCorner = group.Corners[corner];
+				const XMFLOAT3& position = objData.Positions[objCorner.Position];
+				XMFLOAT3 textureCoordinate(0.0f, 0.0f, 0.0f);
+				if (hasTextureCoordinates)
 				{
-					textureCoordinates.emplace_back(reinterpret_cast<const float*>(&aiTextureCoordinates[j]));
+					textureCoordinate = objData.TextureCoordinates[objCorner.TextureCoordinate];
+					if (flipUVs)
+					{
+						textureCoordinate.y = 1.0f - textureCoordinate.y;
+					}
 				}
 
-				meshData.TextureCoordinates.push_back(move(textureCoordinates));
-			}
-		}
+				const XMFLOAT3 normal = (hasNormals ? objData.Normals[objCorner.Normal] : XMFLOAT3(0.0f, 0.0f, 0.0f));
 
-		// Vertex Colors
-		{
-			unsigned int colorChannelCount = mesh.GetNumColorChannels();
-			meshData.VertexColors.reserve(colorChannelCount);
-			for (unsigned int i = 0; i < colorChannelCount; i++)
-			{
-				vector<XMFLOAT4> vertexColors;
-				vertexColors.reserve(mesh.mNumVertices);
-				aiColor4D* aiVertexColors = mesh.mColors[i];
-				for (unsigned int j = 0; j < mesh.mNumVertices; j++)
+				VertexKey key;
+				StoreKey(key, 0, position);
+				StoreKey(key, 3, textureCoordinate);
+				StoreKey(key, 6, normal);
+
+				const auto [it, inserted] = vertexIndices.try_emplace(key, narrow<uint32_t>(meshData.Vertices.size()));
+				if (inserted)
 				{
-					vertexColors.emplace_back(reinterpret_cast<const float*>(&aiVertexColors[j]));
+					meshData.Vertices.push_back(position);
+					textureCoordinates.push_back(textureCoordinate);
+					if (hasNormals)
+					{
+						meshData.Normals.push_back(normal);
+					}
 				}
-				meshData.VertexColors.push_back(move(vertexColors));
+
+				meshData.Indices.push_back(it->second);
 			}
 		}
 
-		// Faces (note: could pre-reserve if we limit primitive types)
-		if (mesh.HasFaces())
+		if (hasTextureCoordinates)
 		{
-			meshData.FaceCount = mesh.mNumFaces;
-			for (uint32_t i = 0; i < meshData.FaceCount; i++)
-			{
-				aiFace* face = &mesh.mFaces[i];
-
-				for (unsigned int j = 0; j < face->mNumIndices; j++)
-				{
-					meshData.Indices.push_back(face->mIndices[j]);
-				}
-			}
+			meshData.TextureCoordinates.push_back(move(textureCoordinates));
 		}
 
+		meshData.FaceCount = narrow<uint32_t>(meshData.Indices.size() / 3);
+
 		return make_shared<Library::Mesh>(model, move(meshData));
-	}*/
+	}
 }
\ No newline at end of file
@@ -2,8 +2,6 @@
 
 #include <memory>
 
-struct aiMesh;
-
 namespace Library
 {
 	class Model;
@@ -12,11 +10,14 @@ namespace Library
 
 namespace ModelPipeline
 {
+	struct ObjData;
+	struct ObjGroup;
+
     class MeshProcessor final
     {
     public:
 		MeshProcessor() = delete;
 
-		static std::shared_ptr<Library::Mesh> LoadMesh(Library::Model& model, aiMesh& mesh);
+		static std::shared_ptr<Library::Mesh> LoadMesh(Library::Model& model, const ObjData& objData, const ObjGroup& group, bool flipUVs = false);
     };
 }
\ No newline at end of file
@@ -0,0 +1,477 @@
+#include "pch.h"
+#include "MeshSimplifier.h"
+#include "Mesh.h"
+#include <numeric>
+#include <unordered_map>
+
+using namespace std;
+using namespace gsl;
+using namespace DirectX;
+using namespace Library;
+
+namespace ModelPipeline
+{
+	namespace
+	{
+		struct Vector3 final
+		{
+			double X;
+			double Y;
+			double Z;
+		};
+
+		Vector3 ToVector3(const XMFLOAT3& value)
+		{
+			return { value.x, value.y, value.z };
+		}
+
+		Vector3 Subtract(const Vector3& lhs, const Vector3& rhs)
+		{
+			return { lhs.X - rhs.X, lhs.Y - rhs.Y, lhs.Z - rhs.Z };
+		}
+
+		Vector3 Cross(const Vector3& lhs, const Vector3& rhs)
+		{
+			return { lhs.Y * rhs.Z - lhs.Z * rhs.Y, lhs.Z * rhs.X - lhs.X * rhs.Z, lhs.X * rhs.Y - lhs.Y * rhs.X };
+		}
+
+		double Dot(const Vector3& lhs, const Vector3& rhs)
+		{
+			return lhs.X * rhs.X + lhs.Y * rhs.Y + lhs.Z * rhs.Z;
+		}
+
+		double Length(const Vector3& value)
+		{
+			return sqrt(Dot(value, value));
+		}
+
+		// Symmetric 4x4 matrix summing the squared distances to a set of planes, weighted by triangle area.
+		// The total weight is kept so the error can be reported as a mean squared distance rather than an area-scaled sum.
+		struct Quadric final
+		{
+			double A2{ 0.0 }, AB{ 0.0 }, AC{ 0.0 }, AD{ 0.0 };
+			double B2{ 0.0 }, BC{ 0.0 }, BD{ 0.0 };
+			double C2{ 0.0 }, CD{ 0.0 };
+			double D2{ 0.0 };
+			double Weight{ 0.0 };
+
+			void AddPlane(const Vector3& normal, double distance, double weight)
+			{
+				A2 += weight * normal.X * normal.X;
+				AB += weight * normal.X * normal.Y;
+				AC += weight * normal.X * normal.Z;
+				AD += weight * normal.X * distance;
+				B2 += weight * normal.Y * normal.Y;
+				BC += weight * normal.Y * normal.Z;
+				BD += weight * normal.Y * distance;
+				C2 += weight * normal.Z * normal.Z;
+				CD += weight * normal.Z * distance;
+				D2 += weight * distance * distance;
+				Weight += weight;
+			}
+
+			Quadric& operator+=(const Quadric& rhs)
+			{
+				A2 += rhs.A2; AB += rhs.AB; AC += rhs.AC; AD += rhs.AD;
+				B2 += rhs.B2; BC += rhs.BC; BD += rhs.BD;
+				C2 += rhs.C2; CD += rhs.CD;
+				D2 += rhs.D2;
+				Weight += rhs.Weight;
+
+				return *this;
+			}
+
+			double Error(const Vector3& point) const
+			{
+				if (Weight <= 0.0)
+				{
+					return 0.0;
+				}
+
+				const double x = point.X;
+				const double y = point.Y;
+				const double z = point.Z;
+				const double error = A2 * x * x + 2.0 * AB * x * y + 2.0 * AC * x * z + 2.0 * AD * x
+					+ B2 * y * y + 2.0 * BC * y * z + 2.0 * BD * y
+					+ C2 * z * z + 2.0 * CD * z
+					+ D2;
+
+				return max(error, 0.0) / Weight;
+			}
+		};
+
+		struct Collapse final
+		{
+			uint32_t From;
+			uint32_t To;
+			double Cost;
+		};
+
+		struct PositionKeyHash final
+		{
+			size_t operator()(const array<uint32_t, 3>& key) const
+			{
+				uint64_t hash = 14695981039346656037ULL;
+				for (uint32_t value : key)
+				{
+					hash = (hash ^ value) * 1099511628211ULL;
+				}
+
+				return static_cast<size_t>(hash);
+			}
+		};
+
+		vector<uint8_t> FindLockedVertices(span<const uint32_t> indices, span<const XMFLOAT3> positions)
+		{
+			const uint32_t vertexCount = narrow<uint32_t>(positions.size());
+
+			// Weld by exact position; a position shared by several vertices marks a UV or normal seam.
+			vector<uint8_t> referenced(vertexCount, 0);
+			for (uint32_t index : indices)
+			{
+				referenced[index] = 1;
+			}
+
+			vector<uint32_t> canonical(vertexCount);
+			vector<uint32_t> copyCounts(vertexCount, 0);
+			unordered_map<array<uint32_t, 3>, uint32_t, PositionKeyHash> positionVertices;
+			for (uint32_t i = 0; i < vertexCount; ++i)
+			{
+				array<uint32_t, 3> key;
+				memcpy(key.data(), &positions[i], sizeof(XMFLOAT3));
+				canonical[i] = positionVertices.emplace(key, i).first->second;
+				copyCounts[canonical[i]] += referenced[i];
+			}
+
+			vector<uint8_t> lockedPositions(vertexCount, 0);
+			for (uint32_t i = 0; i < vertexCount; ++i)
+			{
+				lockedPositions[canonical[i]] = (copyCounts[canonical[i]] > 1 ? 1 : 0);
+			}
+
+			// Edges of welded positions not shared by exactly two triangles are open borders (or non-manifold) and keep their vertices.
+			unordered_map<uint64_t, uint32_t> edgeCounts;
+			for (size_t i = 0; i < indices.size(); i += 3)
+			{
+				for (size_t edge = 0; edge < 3; ++edge)
+				{
+					const uint32_t a = canonical[indices[i + edge]];
+					const uint32_t b = canonical[indices[i + (edge + 1) % 3]];
+					++edgeCounts[(uint64_t(min(a, b)) << 32) | max(a, b)];
+				}
+			}
+
+			for (const auto& edgeCount : edgeCounts)
+			{
+				if (edgeCount.second != 2)
+				{
+					lockedPositions[narrow_cast<uint32_t>(edgeCount.first >> 32)] = 1;
+					lockedPositions[narrow_cast<uint32_t>(edgeCount.first & 0xFFFFFFFF)] = 1;
+				}
+			}
+
+			vector<uint8_t> locked(vertexCount);
+			for (uint32_t i = 0; i < vertexCount; ++i)
+			{
+				locked[i] = lockedPositions[canonical[i]];
+			}
+
+			return locked;
+		}
+
+		void BuildVertexTriangles(const vector<uint32_t>& indices, uint32_t vertexCount, vector<uint32_t>& offsets, vector<uint32_t>& triangles)
+		{
+			offsets.assign(vertexCount + 1, 0);
+			for (uint32_t index : indices)
+			{
+				++offsets[index + 1];
+			}
+
+			partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+			vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+			triangles.resize(indices.size());
+			for (size_t i = 0; i < indices.size(); ++i)
+			{
+				triangles[cursors[indices[i]]++] = narrow_cast<uint32_t>(i / 3);
+			}
+		}
+
+		bool CanCollapse(const Collapse& collapse, const vector<uint32_t>& indices, const vector<Vector3>& points, const vector<uint32_t>& offsets, const vector<uint32_t>& triangles, vector<uint32_t>& scratch)
+		{
+			// Link condition: the only vertices adjacent to both ends may be the apexes of the triangles on the edge,
+			// otherwise the collapse pinches the surface into a non-manifold fan.
+			scratch.clear();
+			uint32_t sharedTriangleCount = 0;
+			for (uint32_t i = offsets[collapse.From]; i < offsets[collapse.From + 1]; ++i)
+			{
+				const uint32_t* triangle = &indices[size_t(triangles[i]) * 3];
+				if (triangle[0] == collapse.To || triangle[1] == collapse.To || triangle[2] == collapse.To)
+				{
+					++sharedTriangleCount;
+				}
+
+				for (uint32_t corner = 0; corner < 3; ++corner)
+				{
+					if (triangle[corner] != collapse.From && triangle[corner] != collapse.To)
+					{
+						scratch.push_back(triangle[corner]);
+					}
+				}
+			}
+
+			sort(scratch.begin(), scratch.end());
+			scratch.erase(unique(scratch.begin(), scratch.end()), scratch.end());
+
+			uint32_t commonNeighborCount = 0;
+			for (uint32_t neighbor : scratch)
+			{
+				for (uint32_t i = offsets[collapse.To]; i < offsets[collapse.To + 1]; ++i)
+				{
+					const uint32_t* triangle = &indices[size_t(triangles[i]) * 3];
+					if (triangle[0] == neighbor || triangle[1] == neighbor || triangle[2] == neighbor)
+					{
+						++commonNeighborCount;
+						break;
+					}
+				}
+			}
+
+			if (commonNeighborCount > sharedTriangleCount)
+			{
+				return false;
+			}
+
+			// Reject collapses that flip or sharply tilt any surviving triangle, which would also wreck its shading.
+			const double minimumCosine = 0.25;
+			for (uint32_t i = offsets[collapse.From]; i < offsets[collapse.From + 1]; ++i)
+			{
+				const uint32_t* triangle = &indices[size_t(triangles[i]) * 3];
+				if (triangle[0] == collapse.To || triangle[1] == collapse.To || triangle[2] == collapse.To)
+				{
+					continue;
+				}
+
+				Vector3 corners[3];
+				Vector3 movedCorners[3];
+				for (uint32_t corner = 0; corner < 3; ++corner)
+				{
+					corners[corner] = points[triangle[corner]];
+					movedCorners[corner] = (triangle[corner] == collapse.From ? points[collapse.To] : corners[corner]);
+				}
+
+				const Vector3 normal = Cross(Subtract(corners[1], corners[0]), Subtract(corners[2], corners[0]));
+				const Vector3 movedNormal = Cross(Subtract(movedCorners[1], movedCorners[0]), Subtract(movedCorners[2], movedCorners[0]));
+				const double movedLength = Length(movedNormal);
+				if (movedLength <= 0.0 || Dot(normal, movedNormal) < minimumCosine * Length(normal) * movedLength)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+	}
+
+	vector<uint32_t> MeshSimplifier::Simplify(span<const uint32_t> indices, span<const XMFLOAT3> positions, size_t targetIndexCount, float maxError, float* resultError)
+	{
+		assert(indices.size() % 3 == 0);
+
+		const uint32_t vertexCount = narrow<uint32_t>(positions.size());
+		vector<Vector3> points;
+		points.reserve(vertexCount);
+		transform(positions.begin(), positions.end(), back_inserter(points), ToVector3);
+
+		const vector<uint8_t> locked = FindLockedVertices(indices, positions);
+
+		vector<Quadric> quadrics(vertexCount);
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			const Vector3& p0 = points[indices[i]];
+			const Vector3 normal = Cross(Subtract(points[indices[i + 1]], p0), Subtract(points[indices[i + 2]], p0));
+			const double length = Length(normal);
+			if (length <= 0.0)
+			{
+				continue;
+			}
+
+			const Vector3 unitNormal{ normal.X / length, normal.Y / length, normal.Z / length };
+			const double distance = -Dot(unitNormal, p0);
+			for (size_t corner = 0; corner < 3; ++corner)
+			{
+				quadrics[indices[i + corner]].AddPlane(unitNormal, distance, length * 0.5);
+			}
+		}
+
+		vector<uint32_t> result(indices.begin(), indices.end());
+		const double maxErrorSquared = double(maxError) * maxError;
+		double resultErrorSquared = 0.0;
+
+		vector<uint32_t> offsets;
+		vector<uint32_t> triangles;
+		vector<Collapse> collapses;
+		vector<uint32_t> collapseTargets(vertexCount);
+		vector<uint8_t> touched(vertexCount);
+		vector<uint32_t> scratch;
+
+		// Each pass collapses the cheapest edges whose neighborhoods do not overlap, then compacts the index list.
+		while (result.size() > targetIndexCount)
+		{
+			BuildVertexTriangles(result, vertexCount, offsets, triangles);
+
+			collapses.clear();
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				for (size_t edge = 0; edge < 3; ++edge)
+				{
+					const uint32_t a = result[i + edge];
+					const uint32_t b = result[i + (edge + 1) % 3];
+					Quadric quadric = quadrics[a];
+					quadric += quadrics[b];
+					if (!locked[a])
+					{
+						collapses.push_back({ a, b, quadric.Error(points[b]) });
+					}
+
+					if (!locked[b])
+					{
+						collapses.push_back({ b, a, quadric.Error(points[a]) });
+					}
+				}
+			}
+
+			sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs)
+			{
+				return lhs.Cost < rhs.Cost;
+			});
+
+			iota(collapseTargets.begin(), collapseTargets.end(), 0U);
+			fill(touched.begin(), touched.end(), uint8_t(0));
+
+			const size_t triangleCount = result.size() / 3;
+			const size_t targetTriangleCount = targetIndexCount / 3;
+			size_t removedTriangleCount = 0;
+			bool collapsed = false;
+			for (const Collapse& collapse : collapses)
+			{
+				if (collapse.Cost > maxErrorSquared || triangleCount - removedTriangleCount <= targetTriangleCount)
+				{
+					break;
+				}
+
+				if (touched[collapse.From] || touched[collapse.To] || !CanCollapse(collapse, result, points, offsets, triangles, scratch))
+				{
+					continue;
+				}
+
+				collapseTargets[collapse.From] = collapse.To;
+				quadrics[collapse.To] += quadrics[collapse.From];
+				resultErrorSquared = max(resultErrorSquared, collapse.Cost);
+				collapsed = true;
+
+				// Freeze the neighborhood for the rest of the pass, so later flip tests see up-to-date positions.
+				for (uint32_t i = offsets[collapse.From]; i < offsets[collapse.From + 1]; ++i)
+				{
+					const uint32_t* triangle = &result[size_t(triangles[i]) * 3];
+					touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = 1;
+					if (triangle[0] == collapse.To || triangle[1] == collapse.To || triangle[2] == collapse.To)
+					{
+						++removedTriangleCount;
+					}
+				}
+			}
+
+			if (!collapsed)
+			{
+				break;
+			}
+
+			size_t writeIndex = 0;
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				const uint32_t a = collapseTargets[result[i]];
+				const uint32_t b = collapseTargets[result[i + 1]];
+				const uint32_t c = collapseTargets[result[i + 2]];
+				if (a != b && b != c && a != c)
+				{
+					result[writeIndex++] = a;
+					result[writeIndex++] = b;
+					result[writeIndex++] = c;
+				}
+			}
+
+			result.resize(writeIndex);
+		}
+
+		if (resultError != nullptr)
+		{
+			*resultError = static_cast<float>(sqrt(resultErrorSquared));
+		}
+
+		return result;
+	}
+
+	void MeshSimplifier::GenerateLods(MeshData& meshData, const LodSettings& settings)
+	{
+		// An existing chain is rebuilt from its full-detail level.
+		if (!meshData.Lods.empty())
+		{
+			const MeshLod fullDetailLod = meshData.Lods.front();
+			meshData.Indices = vector<uint32_t>(meshData.Indices.begin() + fullDetailLod.StartIndex, meshData.Indices.begin() + fullDetailLod.StartIndex + fullDetailLod.IndexCount);
+			meshData.Lods.clear();
+		}
+
+		if (meshData.Vertices.empty() || meshData.Indices.empty())
+		{
+			return;
+		}
+
+		// Errors are bounded relative to the mesh's size, so the same settings work for any model units.
+		XMFLOAT3 minimum = meshData.Vertices.front();
+		XMFLOAT3 maximum = minimum;
+		for (const XMFLOAT3& vertex : meshData.Vertices)
+		{
+			minimum = XMFLOAT3(min(minimum.x, vertex.x), min(minimum.y, vertex.y), min(minimum.z, vertex.z));
+			maximum = XMFLOAT3(max(maximum.x, vertex.x), max(maximum.y, vertex.y), max(maximum.z, vertex.z));
+		}
+
+		const Vector3 extents = Subtract(ToVector3(maximum), ToVector3(minimum));
+		const float maxError = static_cast<float>(settings.MaxRelativeError * Length(extents) * 0.5);
+
+		// Every level is simplified from the full-detail indices, so each error is measured against the original surface.
+		const vector<uint32_t> fullDetailIndices = meshData.Indices;
+		meshData.Lods.push_back(MeshLod{ 0, narrow<uint32_t>(fullDetailIndices.size()), 0.0f });
+
+		size_t previousTriangleCount = fullDetailIndices.size() / 3;
+		float previousError = 0.0f;
+		for (uint32_t level = 1; level < settings.MaxLodCount; ++level)
+		{
+			const size_t targetTriangleCount = static_cast<size_t>(previousTriangleCount * settings.ReductionRatio);
+			if (targetTriangleCount < settings.MinTriangleCount)
+			{
+				break;
+			}
+
+			float error = 0.0f;
+			const vector<uint32_t> lodIndices = Simplify(fullDetailIndices, meshData.Vertices, targetTriangleCount * 3, maxError, &error);
+
+			// Stop once locked vertices or the error bound keep a level from getting even halfway to its target.
+			const size_t triangleCount = lodIndices.size() / 3;
+			if (triangleCount > (previousTriangleCount + targetTriangleCount) / 2)
+			{
+				break;
+			}
+
+			previousError = max(previousError, error);
+			meshData.Lods.push_back(MeshLod{ narrow<uint32_t>(meshData.Indices.size()), narrow<uint32_t>(lodIndices.size()), previousError });
+			meshData.Indices.insert(meshData.Indices.end(), lodIndices.begin(), lodIndices.end());
+			previousTriangleCount = triangleCount;
+		}
+
+		// A lone level is written as a plain mesh.
+		if (meshData.Lods.size() == 1)
+		{
+			meshData.Lods.clear();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <gsl\gsl>
+#include <DirectXMath.h>
+
+namespace Library
+{
+	struct MeshData;
+}
+
+namespace ModelPipeline
+{
+	struct LodSettings final
+	{
+		std::uint32_t MaxLodCount{ 6 }; // Including the full-detail level
+		float ReductionRatio{ 0.5f }; // Target triangle count of each level relative to the previous one
+		float MaxRelativeError{ 0.05f }; // Largest error accepted for any level, relative to the mesh's bounding radius
+		std::uint32_t MinTriangleCount{ 32 };
+	};
+
+	/// <summary>
+	/// Edge-collapse simplification driven by quadric error metrics (Garland and Heckbert, "Surface Simplification Using Quadric Error Metrics").
+	/// Vertices only ever collapse onto existing vertices, so every level is an index list over the original vertex buffer.
+	/// Vertices on UV or normal seams and on open borders are locked, and collapses that would fold a triangle over are rejected.
+	/// </summary>
+	class MeshSimplifier final
+	{
+	public:
+		MeshSimplifier() = delete;
+
+		static std::vector<std::uint32_t> Simplify(gsl::span<const std::uint32_t> indices, gsl::span<const DirectX::XMFLOAT3> positions, std::size_t targetIndexCount, float maxError, float* resultError = nullptr);
+		static void GenerateLods(Library::MeshData& meshData, const LodSettings& settings = LodSettings());
+	};
+}
\ No newline at end of file
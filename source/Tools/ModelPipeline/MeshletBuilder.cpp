@@ -0,0 +1,190 @@
+#include "pch.h"
+#include "MeshletBuilder.h"
+#include <numeric>
+
+using namespace std;
+using namespace gsl;
+using namespace DirectX;
+using namespace Library;
+
+namespace ModelPipeline
+{
+	namespace
+	{
+		XMFLOAT3 TriangleNormal(const MeshData& meshData, const uint32_t* triangle)
+		{
+			const XMVECTOR p0 = XMLoadFloat3(&meshData.Vertices[triangle[0]]);
+			const XMVECTOR p1 = XMLoadFloat3(&meshData.Vertices[triangle[1]]);
+			const XMVECTOR p2 = XMLoadFloat3(&meshData.Vertices[triangle[2]]);
+			XMVECTOR normal = XMVector3Cross(XMVectorSubtract(p1, p0), XMVectorSubtract(p2, p0));
+
+			// Winding conventions vary between sources, so the authored vertex normals decide which side is the front.
+			if (meshData.Normals.size() == meshData.Vertices.size())
+			{
+				const XMVECTOR vertexNormals = XMVectorAdd(XMLoadFloat3(&meshData.Normals[triangle[0]]), XMVectorAdd(XMLoadFloat3(&meshData.Normals[triangle[1]]), XMLoadFloat3(&meshData.Normals[triangle[2]])));
+				if (XMVectorGetX(XMVector3Dot(normal, vertexNormals)) < 0.0f)
+				{
+					normal = XMVectorNegate(normal);
+				}
+			}
+
+			XMFLOAT3 unitNormal;
+			XMStoreFloat3(&unitNormal, XMVector3Normalize(normal));
+
+			return unitNormal;
+		}
+	}
+
+	void MeshletBuilder::BuildMeshlets(MeshData& meshData, uint32_t maxVertexCount, uint32_t maxTriangleCount)
+	{
+		assert(maxVertexCount >= 3 && maxTriangleCount >= 1);
+
+		meshData.Meshlets.clear();
+		const uint32_t levelStart = (meshData.Lods.empty() ? 0 : meshData.Lods.front().StartIndex);
+		const uint32_t levelIndexCount = (meshData.Lods.empty() ? narrow<uint32_t>(meshData.Indices.size()) : meshData.Lods.front().IndexCount);
+		if (levelIndexCount == 0)
+		{
+			return;
+		}
+
+		const span<uint32_t> levelIndices = span<uint32_t>(meshData.Indices).subspan(levelStart, levelIndexCount);
+		const uint32_t vertexCount = narrow<uint32_t>(meshData.Vertices.size());
+		const uint32_t triangleCount = levelIndexCount / 3;
+
+		vector<XMFLOAT3> triangleNormals(triangleCount);
+		for (uint32_t triangle = 0; triangle < triangleCount; ++triangle)
+		{
+			triangleNormals[triangle] = TriangleNormal(meshData, &levelIndices[size_t(triangle) * 3]);
+		}
+
+		// Vertex -> triangle adjacency in compressed row form
+		vector<uint32_t> offsets(size_t(vertexCount) + 1, 0);
+		for (uint32_t index : levelIndices)
+		{
+			++offsets[size_t(index) + 1];
+		}
+
+		partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+		vector<uint32_t> vertexTriangles(levelIndexCount);
+		{
+			vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+			for (uint32_t i = 0; i < levelIndexCount; ++i)
+			{
+				vertexTriangles[cursors[levelIndices[i]]++] = i / 3;
+			}
+		}
+
+		const uint32_t none = numeric_limits<uint32_t>::max();
+		vector<uint8_t> assigned(triangleCount, 0);
+		vector<uint32_t> vertexMeshlet(vertexCount, none);
+		vector<uint32_t> orderedIndices;
+		orderedIndices.reserve(levelIndexCount);
+
+		vector<uint32_t> meshletTriangles;
+		vector<uint32_t> candidates;
+		uint32_t meshletVertexCount = 0;
+		uint32_t nextSeed = 0;
+
+		auto newVertexCount = [&](uint32_t triangle, uint32_t meshletIndex)
+		{
+			uint32_t count = 0;
+			for (uint32_t corner = 0; corner < 3; ++corner)
+			{
+				count += (vertexMeshlet[levelIndices[size_t(triangle) * 3 + corner]] != meshletIndex ? 1 : 0);
+			}
+
+			return count;
+		};
+
+		auto addTriangle = [&](uint32_t triangle, uint32_t meshletIndex)
+		{
+			assigned[triangle] = 1;
+			meshletTriangles.push_back(triangle);
+			for (uint32_t corner = 0; corner < 3; ++corner)
+			{
+				const uint32_t vertex = levelIndices[size_t(triangle) * 3 + corner];
+				if (vertexMeshlet[vertex] != meshletIndex)
+				{
+					vertexMeshlet[vertex] = meshletIndex;
+					++meshletVertexCount;
+					candidates.insert(candidates.end(), vertexTriangles.begin() + offsets[vertex], vertexTriangles.begin() + offsets[size_t(vertex) + 1]);
+				}
+			}
+		};
+
+		while (orderedIndices.size() < levelIndexCount)
+		{
+			const uint32_t meshletIndex = narrow<uint32_t>(meshData.Meshlets.size());
+			meshletTriangles.clear();
+			candidates.clear();
+			meshletVertexCount = 0;
+
+			while (assigned[nextSeed])
+			{
+				++nextSeed;
+			}
+
+			addTriangle(nextSeed, meshletIndex);
+			XMVECTOR normalSum = XMLoadFloat3(&triangleNormals[nextSeed]);
+
+			while (meshletTriangles.size() < maxTriangleCount)
+			{
+				const XMVECTOR averageNormal = XMVector3Normalize(normalSum);
+				uint32_t bestTriangle = none;
+				uint32_t bestNewVertexCount = none;
+				float bestAlignment = -numeric_limits<float>::max();
+
+				size_t writeIndex = 0;
+				for (uint32_t candidate : candidates)
+				{
+					if (assigned[candidate])
+					{
+						continue;
+					}
+
+					candidates[writeIndex++] = candidate;
+					const uint32_t addedVertexCount = newVertexCount(candidate, meshletIndex);
+					if (meshletVertexCount + addedVertexCount > maxVertexCount)
+					{
+						continue;
+					}
+
+					const float alignment = XMVectorGetX(XMVector3Dot(averageNormal, XMLoadFloat3(&triangleNormals[candidate])));
+					if (addedVertexCount < bestNewVertexCount || (addedVertexCount == bestNewVertexCount && alignment > bestAlignment))
+					{
+						bestTriangle = candidate;
+						bestNewVertexCount = addedVertexCount;
+						bestAlignment = alignment;
+					}
+				}
+
+				candidates.resize(writeIndex);
+				if (bestTriangle == none)
+				{
+					break;
+				}
+
+				addTriangle(bestTriangle, meshletIndex);
+				normalSum = XMVectorAdd(normalSum, XMLoadFloat3(&triangleNormals[bestTriangle]));
+			}
+
+			Meshlet meshlet;
+			meshlet.StartIndex = levelStart + narrow<uint32_t>(orderedIndices.size());
+			meshlet.IndexCount = narrow<uint32_t>(meshletTriangles.size() * 3);
+			meshlet.VertexCount = meshletVertexCount;
+
+			for (uint32_t triangle : meshletTriangles)
+			{
+				orderedIndices.insert(orderedIndices.end(), levelIndices.begin() + size_t(triangle) * 3, levelIndices.begin() + size_t(triangle) * 3 + 3);
+			}
+
+			meshData.Meshlets.push_back(meshlet);
+		}
+
+		copy(orderedIndices.begin(), orderedIndices.end(), levelIndices.begin());
+		for (Meshlet& meshlet : meshData.Meshlets)
+		{
+			meshlet.ComputeBounds(meshData);
+		}
+	}
+}
\ No newline at end of file
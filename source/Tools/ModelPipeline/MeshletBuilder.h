@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include "Mesh.h"
+
+namespace ModelPipeline
+{
+	/// <summary>
+	/// Partitions a mesh's full-detail level into meshlets of bounded vertex and triangle counts.
+	/// Triangles are grown greedily from a seed, preferring ones that add no new vertices and then ones facing the same way,
+	/// which keeps clusters compact and their normal cones narrow. The level's triangles are reordered so each meshlet is a contiguous index range.
+	/// </summary>
+	class MeshletBuilder final
+	{
+	public:
+		MeshletBuilder() = delete;
+
+		static void BuildMeshlets(Library::MeshData& meshData, std::uint32_t maxVertexCount = Library::Meshlet::MaxVertexCount, std::uint32_t maxTriangleCount = Library::Meshlet::MaxTriangleCount);
+	};
+}
\ No newline at end of file
@@ -4,8 +4,6 @@
 #include <cstdint>
 #include "ModelMaterial.h"
 
-struct aiMaterial;
-
 namespace Library
 {
 	class Model;
@@ -14,14 +12,13 @@ namespace Library
 
 namespace ModelPipeline
 {
+	struct ObjMaterial;
+
     class ModelMaterialProcessor final
     {
     public:
 		ModelMaterialProcessor() = delete;
 		
-		//static std::shared_ptr<Library::ModelMaterial> LoadModelMaterial(Library::Model& model, aiMaterial& material);
-
-	private:
-        static const std::map<Library::TextureType, std::uint32_t> sTextureTypeMappings;
+		static std::shared_ptr<Library::ModelMaterial> LoadModelMaterial(Library::Model& model, const ObjMaterial& material);
     };
 }
\ No newline at end of file
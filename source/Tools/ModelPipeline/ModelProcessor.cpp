@@ -2,53 +2,42 @@
 #include "ModelProcessor.h"
 #include "ModelMaterialProcessor.h"
 #include "MeshProcessor.h"
-//#include <assimp/Importer.hpp>
-//#include <assimp/scene.h>
-//#include <assimp/postprocess.h>
+#include "ObjReader.h"
+#include "Mesh.h"
 
 using namespace std;
+using namespace std::string_literals;
 using namespace Library;
 using namespace DirectX;
 
 namespace ModelPipeline
 {
-/*
 	Library::Model ModelProcessor::LoadModel(const std::string& filename, bool flipUVs)
+	{
+		return LoadModel(ObjReader::Read(filename), flipUVs);
+	}
+
+	Library::Model ModelProcessor::LoadModel(const ObjData& objData, bool flipUVs)
 	{
 		Library::Model model;
 		ModelData& modelData = model.Data();
-		Assimp::Importer importer;
-
-		uint32_t flags = aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_SortByPType | aiProcess_FlipWindingOrder;
-		if (flipUVs)
-		{
-			flags |= aiProcess_FlipUVs;
-		}
 
-		const aiScene* scene = importer.ReadFile(filename, flags);
-		if (scene == nullptr)
+		for (const ObjMaterial& material : objData.Materials)
 		{
-			throw exception(importer.GetErrorString());
+			modelData.Materials.push_back(ModelMaterialProcessor::LoadModelMaterial(model, material));
 		}
 
-		if (scene->HasMaterials())
+		// Meshes always reference a material, as they did when models were imported through Assimp.
+		if (modelData.Materials.empty())
 		{
-			for (unsigned int i = 0; i < scene->mNumMaterials; i++)
-			{
-				shared_ptr<ModelMaterial> modelMaterial = ModelMaterialProcessor::LoadModelMaterial(model, *(scene->mMaterials[i]));
-				modelData.Materials.push_back(move(modelMaterial));
-			}
+			modelData.Materials.push_back(ModelMaterialProcessor::LoadModelMaterial(model, ObjMaterial{ "DefaultMaterial"s }));
 		}
 
-		if (scene->HasMeshes())
+		for (const ObjGroup& group : objData.Groups)
 		{
-			for (unsigned int i = 0; i < scene->mNumMeshes; i++)
-			{
-				shared_ptr<Mesh> mesh = MeshProcessor::LoadMesh(model, *(scene->mMeshes[i]));
-				modelData.Meshes.push_back(move(mesh));
-			}
+			modelData.Meshes.push_back(MeshProcessor::LoadMesh(model, objData, group, flipUVs));
 		}
 
 		return model;
-	}*/
+	}
 }
\ No newline at end of file
@@ -3,20 +3,15 @@
 #include "Model.h"
 #include <memory>
 
-struct aiNode;
-
-namespace Library
-{
-	struct ModelData;
-	class SceneNode;
-}
-
 namespace ModelPipeline
 {
+	struct ObjData;
+
     struct ModelProcessor final
     {
 		ModelProcessor() = delete;
 
-		//static Library::Model LoadModel(const std::string& filename, bool flipUVs = false);		
+		static Library::Model LoadModel(const std::string& filename, bool flipUVs = false);
+		static Library::Model LoadModel(const ObjData& objData, bool flipUVs = false);
     };
 }
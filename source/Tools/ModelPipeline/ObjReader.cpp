@@ -0,0 +1,470 @@
+#include "pch.h"
+#include "ObjReader.h"
+#include <charconv>
+#include <future>
+#include <thread>
+
+using namespace std;
+using namespace std::filesystem;
+using namespace std::string_literals;
+using namespace gsl;
+using namespace DirectX;
+using namespace Library;
+
+namespace ModelPipeline
+{
+	const map<string, TextureType> ObjReader::sTextureTypeMappings =
+	{
+		{ "map_Kd"s, TextureType::Diffuse },
+		{ "map_Ks"s, TextureType::SpecularMap },
+		{ "map_Ka"s, TextureType::Ambient },
+		{ "map_Ke"s, TextureType::Emissive },
+		{ "map_bump"s, TextureType::Heightmap },
+		{ "bump"s, TextureType::Heightmap },
+		{ "norm"s, TextureType::NormalMap },
+		{ "map_Kn"s, TextureType::NormalMap },
+		{ "map_Ns"s, TextureType::SpecularPowerMap },
+		{ "disp"s, TextureType::DisplacementMap },
+		{ "map_Kl"s, TextureType::LightMap }
+	};
+
+	namespace
+	{
+		enum class StatementType
+		{
+			Faces,
+			UseMaterial,
+			Group,
+			MaterialLibrary
+		};
+
+		struct Statement final
+		{
+			StatementType Type;
+			string Name;
+			size_t FirstCorner{ 0 };
+			size_t CornerCount{ 0 };
+		};
+
+		// Positive OBJ indices are global; negative ones are relative to the elements read so far, which a chunk
+		// only knows locally. Those are stored as chunk-local offsets and flagged until the chunk's base is known.
+		struct ChunkCorner final
+		{
+			int32_t Indices[3]{ -1, -1, -1 };
+			uint8_t RelativeMask{ 0 };
+		};
+
+		struct Chunk final
+		{
+			vector<XMFLOAT3> Positions;
+			vector<XMFLOAT3> TextureCoordinates;
+			vector<XMFLOAT3> Normals;
+			vector<ChunkCorner> Corners;
+			vector<Statement> Statements;
+		};
+
+		bool IsSpace(char c)
+		{
+			return (c == ' ' || c == '\t' || c == '\r');
+		}
+
+		const char* SkipSpaces(const char* current, const char* end)
+		{
+			while (current < end && IsSpace(*current))
+			{
+				++current;
+			}
+
+			return current;
+		}
+
+		string_view ReadToken(const char*& current, const char* end)
+		{
+			current = SkipSpaces(current, end);
+			const char* begin = current;
+			while (current < end && !IsSpace(*current))
+			{
+				++current;
+			}
+
+			return string_view(begin, current - begin);
+		}
+
+		string ReadRemainder(const char* current, const char* end)
+		{
+			current = SkipSpaces(current, end);
+			while (end > current && IsSpace(*(end - 1)))
+			{
+				--end;
+			}
+
+			return string(current, end);
+		}
+
+		[[noreturn]] void ThrowMalformed(const char* begin, const char* end)
+		{
+			throw exception(("Malformed OBJ statement: "s + string(begin, begin + min<ptrdiff_t>(end - begin, 80))).c_str());
+		}
+
+		bool ReadFloat(const char*& current, const char* end, float& value)
+		{
+			current = SkipSpaces(current, end);
+			if (current < end && *current == '+')
+			{
+				++current;
+			}
+
+			const auto result = from_chars(current, end, value);
+			if (result.ec != errc())
+			{
+				return false;
+			}
+
+			current = result.ptr;
+			return true;
+		}
+
+		XMFLOAT3 ReadFloats(const char* current, const char* end, uint32_t requiredCount, const char* lineBegin)
+		{
+			float values[3]{ 0.0f, 0.0f, 0.0f };
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				if (!ReadFloat(current, end, values[i]))
+				{
+					if (i < requiredCount)
+					{
+						ThrowMalformed(lineBegin, end);
+					}
+
+					break;
+				}
+			}
+
+			return XMFLOAT3(values);
+		}
+
+		void ParseFace(const char* current, const char* end, const char* lineBegin, Chunk& chunk, vector<ChunkCorner>& polygon)
+		{
+			const size_t elementCounts[3]{ chunk.Positions.size(), chunk.TextureCoordinates.size(), chunk.Normals.size() };
+
+			polygon.clear();
+			while (true)
+			{
+				current = SkipSpaces(current, end);
+				if (current == end)
+				{
+					break;
+				}
+
+				// v, v/vt, v//vn or v/vt/vn
+				ChunkCorner corner;
+				for (uint32_t element = 0; element < 3; ++element)
+				{
+					if (element > 0)
+					{
+						if (current == end || *current != '/')
+						{
+							break;
+						}
+
+						++current;
+						if (current < end && *current == '/')
+						{
+							continue;
+						}
+					}
+
+					int32_t index = 0;
+					const auto result = from_chars(current, end, index);
+					if (result.ec != errc() || index == 0)
+					{
+						ThrowMalformed(lineBegin, end);
+					}
+
+					current = result.ptr;
+					if (index > 0)
+					{
+						corner.Indices[element] = index - 1;
+					}
+					else
+					{
+						corner.Indices[element] = narrow<int32_t>(static_cast<int64_t>(elementCounts[element]) + index);
+						corner.RelativeMask |= static_cast<uint8_t>(1 << element);
+					}
+				}
+
+				if (current < end && !IsSpace(*current))
+				{
+					ThrowMalformed(lineBegin, end);
+				}
+
+				polygon.push_back(corner);
+			}
+
+			if (polygon.size() < 3)
+			{
+				ThrowMalformed(lineBegin, end);
+			}
+
+			if (chunk.Statements.empty() || chunk.Statements.back().Type != StatementType::Faces)
+			{
+				chunk.Statements.push_back({ StatementType::Faces, string(), chunk.Corners.size(), 0 });
+			}
+
+			// Fan triangulation
+			for (size_t i = 1; i + 1 < polygon.size(); ++i)
+			{
+				chunk.Corners.push_back(polygon[0]);
+				chunk.Corners.push_back(polygon[i]);
+				chunk.Corners.push_back(polygon[i + 1]);
+			}
+
+			Statement& faces = chunk.Statements.back();
+			faces.CornerCount = chunk.Corners.size() - faces.FirstCorner;
+		}
+
+		void ParseChunk(const char* current, const char* end, Chunk& chunk)
+		{
+			vector<ChunkCorner> polygon;
+			while (current < end)
+			{
+				const char* lineBegin = current;
+				const char* lineEnd = static_cast<const char*>(memchr(current, '\n', end - current));
+				if (lineEnd == nullptr)
+				{
+					lineEnd = end;
+				}
+
+				current = (lineEnd < end ? lineEnd + 1 : end);
+
+				const char* position = lineBegin;
+				const string_view keyword = ReadToken(position, lineEnd);
+				if (keyword.empty() || keyword[0] == '#')
+				{
+					continue;
+				}
+
+				if (keyword == "v"sv)
+				{
+					chunk.Positions.push_back(ReadFloats(position, lineEnd, 3, lineBegin));
+				}
+				else if (keyword == "vt"sv)
+				{
+					chunk.TextureCoordinates.push_back(ReadFloats(position, lineEnd, 1, lineBegin));
+				}
+				else if (keyword == "vn"sv)
+				{
+					chunk.Normals.push_back(ReadFloats(position, lineEnd, 3, lineBegin));
+				}
+				else if (keyword == "f"sv)
+				{
+					ParseFace(position, lineEnd, lineBegin, chunk, polygon);
+				}
+				else if (keyword == "usemtl"sv)
+				{
+					chunk.Statements.push_back({ StatementType::UseMaterial, ReadRemainder(position, lineEnd) });
+				}
+				else if (keyword == "g"sv || keyword == "o"sv)
+				{
+					chunk.Statements.push_back({ StatementType::Group, ReadRemainder(position, lineEnd) });
+				}
+				else if (keyword == "mtllib"sv)
+				{
+					chunk.Statements.push_back({ StatementType::MaterialLibrary, ReadRemainder(position, lineEnd) });
+				}
+			}
+		}
+
+		template <typename T>
+		void Append(vector<T>& destination, const vector<T>& source)
+		{
+			destination.insert(destination.end(), source.begin(), source.end());
+		}
+	}
+
+	ObjData ObjReader::Read(const path& filename, uint32_t threadCount)
+	{
+		ifstream file(filename, ios::binary);
+		if (!file.good())
+		{
+			throw exception("Could not open file.");
+		}
+
+		vector<char> contents(narrow<size_t>(file_size(filename)));
+		file.read(contents.data(), contents.size());
+		if (!file.good() && contents.size() > 0)
+		{
+			throw exception("Could not read file.");
+		}
+
+		// Split at line boundaries; tiny files aren't worth more than one chunk.
+		const size_t MinimumChunkSize = 1024 * 1024;
+		if (threadCount == 0)
+		{
+			threadCount = max(thread::hardware_concurrency(), 1U);
+		}
+
+		const size_t chunkCount = max<size_t>(1, min<size_t>(threadCount, contents.size() / MinimumChunkSize));
+		const char* const begin = contents.data();
+		const char* const end = begin + contents.size();
+		vector<pair<const char*, const char*>> ranges;
+		const char* rangeBegin = begin;
+		for (size_t i = 1; i <= chunkCount && rangeBegin < end; ++i)
+		{
+			const char* rangeEnd = (i == chunkCount ? end : begin + contents.size() * i / chunkCount);
+			rangeEnd = max(rangeEnd, rangeBegin);
+			const char* newline = static_cast<const char*>(memchr(rangeEnd, '\n', end - rangeEnd));
+			rangeEnd = (newline != nullptr ? newline + 1 : end);
+			ranges.emplace_back(rangeBegin, rangeEnd);
+			rangeBegin = rangeEnd;
+		}
+
+		vector<Chunk> chunks(ranges.size());
+		{
+			vector<future<void>> parses;
+			parses.reserve(ranges.size());
+			for (size_t i = 0; i < ranges.size(); ++i)
+			{
+				parses.push_back(async(launch::async, ParseChunk, ranges[i].first, ranges[i].second, ref(chunks[i])));
+			}
+
+			for (auto& parse : parses)
+			{
+				parse.get();
+			}
+		}
+
+		// Every chunk's elements start where the previous chunk's ended.
+		ObjData objData;
+		vector<array<int64_t, 3>> bases(chunks.size());
+		array<int64_t, 3> totals{ 0, 0, 0 };
+		for (size_t i = 0; i < chunks.size(); ++i)
+		{
+			bases[i] = totals;
+			totals[0] += chunks[i].Positions.size();
+			totals[1] += chunks[i].TextureCoordinates.size();
+			totals[2] += chunks[i].Normals.size();
+		}
+
+		objData.Positions.reserve(narrow<size_t>(totals[0]));
+		objData.TextureCoordinates.reserve(narrow<size_t>(totals[1]));
+		objData.Normals.reserve(narrow<size_t>(totals[2]));
+		for (const Chunk& chunk : chunks)
+		{
+			Append(objData.Positions, chunk.Positions);
+			Append(objData.TextureCoordinates, chunk.TextureCoordinates);
+			Append(objData.Normals, chunk.Normals);
+		}
+
+		ObjGroup group;
+		auto beginGroup = [&objData, &group](const string& name, const string& materialName)
+		{
+			if (!group.Corners.empty())
+			{
+				objData.Groups.push_back(move(group));
+				group = ObjGroup();
+			}
+
+			group.Name = name;
+			group.MaterialName = materialName;
+		};
+
+		for (size_t chunkIndex = 0; chunkIndex < chunks.size(); ++chunkIndex)
+		{
+			const Chunk& chunk = chunks[chunkIndex];
+			for (const Statement& statement : chunk.Statements)
+			{
+				switch (statement.Type)
+				{
+				case StatementType::Faces:
+					group.Corners.reserve(group.Corners.size() + statement.CornerCount);
+					for (size_t i = statement.FirstCorner; i < statement.FirstCorner + statement.CornerCount; ++i)
+					{
+						const ChunkCorner& chunkCorner = chunk.Corners[i];
+						int32_t indices[3];
+						for (uint32_t element = 0; element < 3; ++element)
+						{
+							const bool isRelative = ((chunkCorner.RelativeMask & (1 << element)) != 0);
+							const int64_t index = chunkCorner.Indices[element] + (isRelative ? bases[chunkIndex][element] : 0);
+							if ((isRelative || index >= 0) && (index < 0 || index >= totals[element]))
+							{
+								throw exception("OBJ face index out of range.");
+							}
+
+							indices[element] = narrow_cast<int32_t>(index);
+						}
+
+						group.Corners.push_back({ indices[0], indices[1], indices[2] });
+					}
+					break;
+
+				case StatementType::UseMaterial:
+					beginGroup(group.Name, statement.Name);
+					break;
+
+				case StatementType::Group:
+					beginGroup(statement.Name, group.MaterialName);
+					break;
+
+				case StatementType::MaterialLibrary:
+					objData.MaterialLibraries.push_back(filename.parent_path() / statement.Name);
+					for (ObjMaterial& material : ReadMaterialLibrary(objData.MaterialLibraries.back()))
+					{
+						objData.Materials.push_back(move(material));
+					}
+					break;
+
+				default:
+					break;
+				}
+			}
+		}
+
+		beginGroup(string(), string());
+
+		return objData;
+	}
+
+	vector<ObjMaterial> ObjReader::ReadMaterialLibrary(const path& filename)
+	{
+		ifstream file(filename);
+		if (!file.good())
+		{
+			throw exception(("Could not open material library: "s + filename.string()).c_str());
+		}
+
+		vector<ObjMaterial> materials;
+		string line;
+		while (getline(file, line))
+		{
+			const char* current = line.data();
+			const char* end = current + line.size();
+			const string_view keyword = ReadToken(current, end);
+			if (keyword == "newmtl"sv)
+			{
+				materials.push_back({ ReadRemainder(current, end), {} });
+				continue;
+			}
+
+			auto it = sTextureTypeMappings.find(string(keyword));
+			if (it == sTextureTypeMappings.end() || materials.empty())
+			{
+				continue;
+			}
+
+			// Texture statements may carry options (-bm 1.0, -clamp on, ...); the filename is the last token.
+			string_view textureName;
+			for (string_view token = ReadToken(current, end); !token.empty(); token = ReadToken(current, end))
+			{
+				textureName = token;
+			}
+
+			if (!textureName.empty())
+			{
+				materials.back().Textures[it->second].emplace_back(textureName);
+			}
+		}
+
+		return materials;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+#include <DirectXMath.h>
+#include "ModelMaterial.h"
+
+namespace ModelPipeline
+{
+	struct ObjCorner final
+	{
+		std::int32_t Position{ -1 };
+		std::int32_t TextureCoordinate{ -1 };
+		std::int32_t Normal{ -1 };
+	};
+
+	struct ObjGroup final
+	{
+		std::string Name;
+		std::string MaterialName;
+		std::vector<ObjCorner> Corners; // Triangulated, three corners per triangle, indices into ObjData's streams
+	};
+
+	struct ObjMaterial final
+	{
+		std::string Name;
+		std::map<Library::TextureType, std::vector<std::string>> Textures;
+	};
+
+	struct ObjData final
+	{
+		std::vector<DirectX::XMFLOAT3> Positions;
+		std::vector<DirectX::XMFLOAT3> TextureCoordinates;
+		std::vector<DirectX::XMFLOAT3> Normals;
+		std::vector<ObjGroup> Groups;
+		std::vector<ObjMaterial> Materials;
+		std::vector<std::filesystem::path> MaterialLibraries; // Resolved mtllib paths, in the order they were referenced
+	};
+
+	/// <summary>
+	/// Wavefront OBJ/MTL reader. The file is split at line boundaries and the chunks are parsed concurrently,
+	/// then stitched together in file order so relative (negative) indices and usemtl/g/o boundaries resolve as in a serial parse.
+	/// </summary>
+	class ObjReader final
+	{
+	public:
+		ObjReader() = delete;
+
+		static ObjData Read(const std::filesystem::path& filename, std::uint32_t threadCount = 0);
+		static std::vector<ObjMaterial> ReadMaterialLibrary(const std::filesystem::path& filename);
+
+	private:
+		static const std::map<std::string, Library::TextureType> sTextureTypeMappings;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ModelPipeline
+{
+	struct ProfilerBenchmarkResults final
+	{
+		std::uint32_t ZonesPerFrame{ 0 };
+		std::uint32_t FrameCount{ 0 };
+		double NanosecondsPerZone{ 0.0 }; // Recording against not recording, nested three deep
+		double FrameBudgetPercent{ 0.0 }; // A frame's zones as a share of a 60 Hz frame
+		double TraceMilliseconds{ 0.0 }; // Writing every buffered zone as a Chrome trace
+		std::uint64_t TraceZoneCount{ 0 };
+	};
+
+	/// <summary>
+	/// Measures what the profiler's zones cost: simulated frames of nested zones around a small fixed workload,
+	/// timed with recording on and off, and the time to write the result out as a Chrome trace.
+	/// </summary>
+	class ProfilerBenchmark final
+	{
+	public:
+		inline static const std::uint32_t DefaultZonesPerFrame{ 5000 };
+		inline static const std::uint32_t DefaultFrameCount{ 200 };
+
+		static ProfilerBenchmarkResults Run(std::uint32_t zonesPerFrame = DefaultZonesPerFrame, std::uint32_t frameCount = DefaultFrameCount);
+
+		ProfilerBenchmark() = delete;
+		ProfilerBenchmark(const ProfilerBenchmark&) = delete;
+		ProfilerBenchmark& operator=(const ProfilerBenchmark&) = delete;
+		ProfilerBenchmark(ProfilerBenchmark&&) = delete;
+		ProfilerBenchmark& operator=(ProfilerBenchmark&&) = delete;
+		~ProfilerBenchmark() = default;
+	};
+}
\ No newline at end of file
@@ -1,17 +1,315 @@
 #include "pch.h"
 #include "ModelProcessor.h"
+#include "BatchProcessor.h"
+#include "ObjReader.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
+#include "TangentGenerator.h"
+#include "LoadBenchmark.h"
+#include "CodecBenchmark.h"
+#include "JobBenchmark.h"
+#include "RttiBenchmark.h"
+#include "ProfilerBenchmark.h"
+#include "Mesh.h"
+#include "VertexDeclarations.h"
+#include <chrono>
+#include <thread>
 
 using namespace std;
 using namespace std::filesystem;
 using namespace std::string_literals;
+using namespace gsl;
 using namespace ModelPipeline;
 using namespace Library;
+using namespace DirectX;
+
+namespace
+{
+	Model ImportModel(const path& inputFile)
+	{
+		const auto startTime = chrono::high_resolution_clock::now();
+		const ObjData objData = ObjReader::Read(inputFile);
+		const chrono::duration<double> parseTime = chrono::high_resolution_clock::now() - startTime;
+
+		const double megabytes = static_cast<double>(file_size(inputFile)) / (1024.0 * 1024.0);
+		cout << "Parsed "s << fixed << setprecision(1) << megabytes << " MB in "s << setprecision(3) << parseTime.count() << "s ("s;
+		cout << setprecision(1) << (parseTime.count() > 0.0 ? megabytes / parseTime.count() : 0.0) << " MB/s): "s;
+		cout << objData.Positions.size() << " positions, "s << objData.Groups.size() << " groups, "s << objData.Materials.size() << " materials"s << endl;
+
+		return ModelProcessor::LoadModel(objData, true);
+	}
+
+	int RunBatch(int argc, char* argv[])
+	{
+		if (argc < 3)
+		{
+			throw exception("Usage: ModelPipeline.exe -batch contentdirectory [-force] [-nooptimize] [-notangents] [-nolods] [-nomeshlets] [-nocompress] [-threads count]");
+		}
+
+		path contentDirectory(argv[2]);
+		BatchSettings settings;
+		for (int i = 3; i < argc; ++i)
+		{
+			const string option(argv[i]);
+			if (option == "-force"s)
+			{
+				settings.Force = true;
+			}
+			else if (option == "-nooptimize"s)
+			{
+				settings.Optimize = false;
+			}
+			else if (option == "-notangents"s)
+			{
+				settings.GenerateTangents = false;
+			}
+			else if (option == "-nolods"s)
+			{
+				settings.GenerateLods = false;
+			}
+			else if (option == "-nomeshlets"s)
+			{
+				settings.GenerateMeshlets = false;
+			}
+			else if (option == "-nocompress"s)
+			{
+				settings.Compress = false;
+			}
+			else if (option == "-threads"s && i + 1 < argc)
+			{
+				settings.ThreadCount = static_cast<uint32_t>(stoul(argv[++i]));
+			}
+			else
+			{
+				throw exception(("Unknown option: "s + option).c_str());
+			}
+		}
+
+		cout << "Batch: "s << contentDirectory << endl;
+		const auto startTime = chrono::high_resolution_clock::now();
+		const BatchStatistics statistics = BatchProcessor::Run(contentDirectory, settings);
+		const chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - startTime;
+
+		cout << "Inputs: "s << statistics.InputCount << ", converted: "s << statistics.ConvertedCount << ", up to date: "s << statistics.UpToDateCount;
+		cout << ", failed: "s << statistics.FailedCount << ", removed: "s << statistics.RemovedCount << endl;
+		cout << "Finished in "s << fixed << setprecision(3) << elapsed.count() << "s."s << endl;
+
+		return (statistics.FailedCount > 0 ? 1 : 0);
+	}
+
+	int RunLoadBenchmark(int argc, char* argv[])
+	{
+		if (argc < 3)
+		{
+			throw exception("Usage: ModelPipeline.exe -benchmarkload modelfilename [iterations]");
+		}
+
+		const path modelFile(argv[2]);
+		const uint32_t iterationCount = (argc > 3 ? static_cast<uint32_t>(stoul(argv[3])) : LoadBenchmark::DefaultIterationCount);
+		const LoadBenchmarkResults results = LoadBenchmark::Run(modelFile, iterationCount);
+
+		cout << "Load benchmark: "s << modelFile << " as "s << results.VertexDeclaration << ", "s << results.IterationCount << " iterations"s << endl;
+		auto report = [](const string& label, const LoadBenchmarkResult& result)
+		{
+			cout << label << fixed << setprecision(3) << result.Milliseconds << " ms, "s << result.AllocationCount << " allocations ("s << result.AllocatedBytes << " bytes), "s;
+			cout << result.CopiedBytes << " vertex bytes copied for "s << result.VertexBytes << " bytes of vertices"s << endl;
+		};
+
+		report("  Per-stream:  "s, results.PerStream);
+		report("  Interleaved: "s, results.Interleaved);
+
+		const double speedup = (results.Interleaved.Milliseconds > 0.0 ? results.PerStream.Milliseconds / results.Interleaved.Milliseconds : 0.0);
+		cout << "  Saved: "s << static_cast<int64_t>(results.PerStream.AllocationCount - results.Interleaved.AllocationCount) << " allocations, "s;
+		cout << static_cast<int64_t>(results.PerStream.CopiedBytes - results.Interleaved.CopiedBytes) << " bytes copied, "s << setprecision(2) << speedup << "x faster"s << endl;
+
+		return 0;
+	}
+
+	int RunCodecBenchmark(int argc, char* argv[])
+	{
+		if (argc < 3)
+		{
+			throw exception("Usage: ModelPipeline.exe -benchmarkcodec modelfilename [iterations]");
+		}
+
+		const path modelFile(argv[2]);
+		const uint32_t iterationCount = (argc > 3 ? static_cast<uint32_t>(stoul(argv[3])) : CodecBenchmark::DefaultIterationCount);
+		const CodecBenchmarkResults results = CodecBenchmark::Run(modelFile, iterationCount);
+
+		auto ratio = [](uint64_t rawBytes, uint64_t encodedBytes)
+		{
+			return (encodedBytes > 0 ? static_cast<double>(rawBytes) / static_cast<double>(encodedBytes) : 0.0);
+		};
+
+		cout << "Codec benchmark: "s << modelFile << ", "s << results.IterationCount << " iterations"s << endl;
+		cout << "  Vertices: "s << results.VertexBytes << " -> "s << results.EncodedVertexBytes << " bytes ("s << fixed << setprecision(2) << ratio(results.VertexBytes, results.EncodedVertexBytes) << "x)"s << endl;
+		cout << "  Indices:  "s << results.IndexBytes << " -> "s << results.EncodedIndexBytes << " bytes ("s << ratio(results.IndexBytes, results.EncodedIndexBytes) << "x)"s << endl;
+		cout << "  Decode:   "s << setprecision(3) << results.DecodeMilliseconds << " ms, "s << setprecision(2) << results.DecodeGigabytesPerSecond << " GB/s"s << endl;
+		cout << "  File:     "s << results.RawFileBytes << " -> "s << results.CompressedFileBytes << " bytes ("s << ratio(results.RawFileBytes, results.CompressedFileBytes) << "x)"s << endl;
+		cout << "  Load:     "s << setprecision(3) << results.RawLoadMilliseconds << " ms raw, "s << results.CompressedLoadMilliseconds << " ms compressed"s << endl;
+
+		return 0;
+	}
+
+	int RunTangentBenchmark(int argc, char* argv[])
+	{
+		if (argc < 3)
+		{
+			throw exception("Usage: ModelPipeline.exe -benchmarktangents modelfilename [iterations]");
+		}
+
+		const path modelFile(argv[2]);
+		const uint32_t iterationCount = max((argc > 3 ? static_cast<uint32_t>(stoul(argv[3])) : 10U), 1U);
+		Model model(modelFile.string());
+
+		// Thread counts double up to the hardware's; every run must reproduce the single-threaded frames bit for bit.
+		vector<uint32_t> threadCounts{ 1 };
+		const uint32_t hardwareThreadCount = max(thread::hardware_concurrency(), 1U);
+		while (threadCounts.back() < hardwareThreadCount)
+		{
+			threadCounts.push_back(min(threadCounts.back() * 2, hardwareThreadCount));
+		}
+
+		cout << "Tangent benchmark: "s << modelFile << ", "s << iterationCount << " iterations"s << endl;
+		vector<vector<XMFLOAT3>> referenceTangents;
+		vector<vector<XMFLOAT3>> referenceBiNormals;
+		for (uint32_t threadCount : threadCounts)
+		{
+			uint64_t triangleCount = 0;
+			double milliseconds = 0.0;
+			bool identical = true;
+			for (uint32_t iteration = 0; iteration < iterationCount; ++iteration)
+			{
+				for (size_t meshIndex = 0; meshIndex < model.Meshes().size(); ++meshIndex)
+				{
+					MeshData& meshData = model.Meshes()[meshIndex]->Data();
+					const TangentStatistics statistics = TangentGenerator::GenerateTangents(meshData, threadCount);
+					triangleCount += statistics.TriangleCount;
+					milliseconds += statistics.Milliseconds;
+
+					if (referenceTangents.size() <= meshIndex)
+					{
+						referenceTangents.push_back(meshData.Tangents);
+						referenceBiNormals.push_back(meshData.BiNormals);
+					}
+
+					auto sameBits = [](const vector<XMFLOAT3>& lhs, const vector<XMFLOAT3>& rhs)
+					{
+						return (lhs.size() == rhs.size() && memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(XMFLOAT3)) == 0);
+					};
+
+					identical = identical && sameBits(meshData.Tangents, referenceTangents[meshIndex]) && sameBits(meshData.BiNormals, referenceBiNormals[meshIndex]);
+				}
+			}
+
+			const double trianglesPerSecond = (milliseconds > 0.0 ? static_cast<double>(triangleCount) / (milliseconds * 1.0e-3) : 0.0);
+			cout << "  "s << threadCount << " threads: "s << fixed << setprecision(3) << milliseconds / iterationCount << " ms, "s;
+			cout << setprecision(1) << trianglesPerSecond * 1.0e-6 << " M triangles/s, "s << (identical ? "bit-identical"s : "MISMATCH"s) << endl;
+			if (!identical)
+			{
+				return 1;
+			}
+		}
+
+		return 0;
+	}
+
+	int RunJobBenchmark(int argc, char* argv[])
+	{
+		const uint32_t itemCount = (argc > 2 ? static_cast<uint32_t>(stoul(argv[2])) : JobBenchmark::DefaultItemCount);
+		const uint32_t iterationCount = (argc > 3 ? static_cast<uint32_t>(stoul(argv[3])) : JobBenchmark::DefaultIterationCount);
+		const JobBenchmarkResults results = JobBenchmark::Run(itemCount, iterationCount);
+
+		// Speedups are against the single-threaded run, which every other run must reproduce bit for bit.
+		cout << "Job benchmark: "s << results.ItemCount << " items, "s << results.IterationCount << " iterations"s << endl;
+		const JobBenchmarkResult& baseline = results.Results.front();
+		for (const auto& result : results.Results)
+		{
+			cout << "  "s << result.ThreadCount << " threads: parallel for "s << fixed << setprecision(3) << result.ParallelForMilliseconds << " ms ("s;
+			cout << setprecision(2) << baseline.ParallelForMilliseconds / result.ParallelForMilliseconds << "x), graph "s << setprecision(3) << result.GraphMilliseconds << " ms ("s;
+			cout << setprecision(2) << baseline.GraphMilliseconds / result.GraphMilliseconds << "x), "s << (result.Identical ? "bit-identical"s : "MISMATCH"s) << endl;
+			if (!result.Identical)
+			{
+				return 1;
+			}
+		}
+
+		return 0;
+	}
+
+	int RunRttiBenchmark(int argc, char* argv[])
+	{
+		const uint32_t iterationCount = (argc > 2 ? static_cast<uint32_t>(stoul(argv[2])) : RttiBenchmark::DefaultIterationCount);
+		const RttiBenchmarkResults results = RttiBenchmark::Run(iterationCount);
+
+		cout << "RTTI benchmark: "s << results.ObjectCount << " objects, "s << results.IterationCount << " iterations"s << endl;
+		for (const auto& result : results.Results)
+		{
+			const double speedup = (result.FlatNanoseconds > 0.0 ? result.RecursiveNanoseconds / result.FlatNanoseconds : 0.0);
+			cout << "  "s << left << setw(42) << result.Query << right << fixed << setprecision(2) << result.RecursiveNanoseconds << " ns recursive, "s;
+			cout << result.FlatNanoseconds << " ns flat ("s << speedup << "x), "s << (result.Identical ? "identical"s : "MISMATCH"s) << endl;
+			if (!result.Identical)
+			{
+				return 1;
+			}
+		}
+
+		return 0;
+	}
+
+	int RunProfilerBenchmark(int argc, char* argv[])
+	{
+		const uint32_t zonesPerFrame = (argc > 2 ? static_cast<uint32_t>(stoul(argv[2])) : ProfilerBenchmark::DefaultZonesPerFrame);
+		const uint32_t frameCount = (argc > 3 ? static_cast<uint32_t>(stoul(argv[3])) : ProfilerBenchmark::DefaultFrameCount);
+		const ProfilerBenchmarkResults results = ProfilerBenchmark::Run(zonesPerFrame, frameCount);
+
+		cout << "Profiler benchmark: "s << results.ZonesPerFrame << " zones per frame, "s << results.FrameCount << " frames"s << endl;
+		cout << "  Zone:  "s << fixed << setprecision(1) << results.NanosecondsPerZone << " ns, "s << setprecision(2) << results.FrameBudgetPercent << "% of a 60 Hz frame"s << endl;
+		cout << "  Trace: "s << results.TraceZoneCount << " zones in "s << setprecision(3) << results.TraceMilliseconds << " ms"s << endl;
+
+		return 0;
+	}
+
+	void ReportPackingError(const Mesh& mesh)
+	{
+		if (mesh.Normals().size() != mesh.Vertices().size() || mesh.TextureCoordinateChannelCount() == 0)
+		{
+			return;
+		}
+
+		vector<VertexPositionTextureNormalPacked> packedVertices;
+		VertexPositionTextureNormalPacked::CreateVertices(mesh, packedVertices);
+		const VertexQuantization quantization = VertexPositionTextureNormalPacked::Quantization(mesh);
+
+		float maxPositionError = 0.0f;
+		float maxNormalError = 0.0f;
+		float maxTextureCoordinateError = 0.0f;
+		for (size_t i = 0; i < packedVertices.size(); ++i)
+		{
+			const VertexPositionTextureNormalPacked& packedVertex = packedVertices[i];
+
+			const XMVECTOR position = VertexPacking::UnpackPosition(packedVertex.Position, quantization);
+			maxPositionError = max(maxPositionError, XMVectorGetX(XMVector3Length(XMVectorSubtract(position, XMLoadFloat3(&mesh.Vertices()[i])))));
+
+			const XMVECTOR normal = VertexPacking::UnpackNormal(packedVertex.Normal);
+			maxNormalError = max(maxNormalError, XMVectorGetX(XMVector3AngleBetweenNormals(normal, XMVector3Normalize(XMLoadFloat3(&mesh.Normals()[i])))));
+
+			const XMVECTOR textureCoordinates = VertexPacking::UnpackTextureCoordinates(packedVertex.TextureCoordinates);
+			const XMVECTOR sourceTextureCoordinates = XMVectorSelect(XMVectorZero(), XMLoadFloat3(&mesh.TextureCoordinates()[i]), g_XMSelect1100);
+			maxTextureCoordinateError = max(maxTextureCoordinateError, XMVectorGetX(XMVector2Length(XMVectorSubtract(textureCoordinates, sourceTextureCoordinates))));
+		}
+
+		cout << "  Packed vertex: "s << sizeof(VertexPositionTextureNormal) << " -> "s << sizeof(VertexPositionTextureNormalPacked) << " bytes"s;
+		cout << ", max error: position "s << scientific << setprecision(2) << maxPositionError;
+		cout << ", normal "s << fixed << setprecision(4) << XMConvertToDegrees(maxNormalError) << " deg"s;
+		cout << ", uv "s << scientific << setprecision(2) << maxTextureCoordinateError << defaultfloat << endl;
+	}
+}
 
 int main(int argc, char* argv[])
 {
-	argc;
-	argv;
-/*#if defined(DEBUG) | defined(_DEBUG)
+#if defined(DEBUG) | defined(_DEBUG)
 	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
 #endif
 
@@ -19,29 +317,101 @@ int main(int argc, char* argv[])
 	{
 		if (argc < 2)
 		{
-			throw exception("Usage: ModelPipeline.exe inputfilename");
+			throw exception("Usage: ModelPipeline.exe inputfilename [outputfilename] | -batch contentdirectory [options] | -benchmarkload modelfilename [iterations] | -benchmarkcodec modelfilename [iterations] | -benchmarktangents modelfilename [iterations] | -benchmarkjobs [itemcount] [iterations] | -benchmarkrtti [iterations] | -benchmarkprofiler [zonesperframe] [frames]");
 		}
 
-		path inputFile(argv[1]);
-		current_path(inputFile.parent_path().c_str());
+		if (string(argv[1]) == "-batch"s)
+		{
+			return RunBatch(argc, argv);
+		}
+
+		if (string(argv[1]) == "-benchmarkload"s)
+		{
+			return RunLoadBenchmark(argc, argv);
+		}
 
-		cout << "Reading: "s << inputFile.filename() << endl;
-		Model model = ModelProcessor::LoadModel(inputFile.filename().string(), true);
+		if (string(argv[1]) == "-benchmarkcodec"s)
+		{
+			return RunCodecBenchmark(argc, argv);
+		}
+
+		if (string(argv[1]) == "-benchmarktangents"s)
+		{
+			return RunTangentBenchmark(argc, argv);
+		}
+
+		if (string(argv[1]) == "-benchmarkjobs"s)
+		{
+			return RunJobBenchmark(argc, argv);
+		}
+
+		if (string(argv[1]) == "-benchmarkrtti"s)
+		{
+			return RunRttiBenchmark(argc, argv);
+		}
 
-		string outputFilename = inputFile.stem().string() + ".model"s;
+		if (string(argv[1]) == "-benchmarkprofiler"s)
+		{
+			return RunProfilerBenchmark(argc, argv);
+		}
+
+		// .obj files are imported; anything else is taken to be a compiled model and reprocessed in place.
+		path inputFile(argv[1]);
+		const bool isObjFile = (_wcsicmp(inputFile.extension().c_str(), L".obj") == 0);
+		path outputFile(argc > 2 ? path(argv[2]) : (isObjFile ? path(inputFile).concat(L".bin") : inputFile));
+
+		cout << "Reading: "s << inputFile << endl;
+		Model model = (isObjFile ? ImportModel(inputFile) : Model(inputFile.string()));
 		if (!model.HasMeshes())
 		{
 			throw exception("Model has no meshes.");
 		}
-		
-		cout << "Writing: "s << outputFilename << endl;
-		model.Save(outputFilename);
+
+		for (const auto& mesh : model.Meshes())
+		{
+			MeshData& meshData = mesh->Data();
+			const uint32_t vertexCount = narrow<uint32_t>(meshData.Vertices.size());
+
+			const TangentStatistics tangentStatistics = TangentGenerator::GenerateTangents(meshData);
+			MeshSimplifier::GenerateLods(meshData);
+			MeshletBuilder::BuildMeshlets(meshData);
+			const MeshLod fullDetailLod = mesh->Lods().front();
+			const span<const uint32_t> fullDetailIndices = span<const uint32_t>(meshData.Indices).subspan(fullDetailLod.StartIndex, fullDetailLod.IndexCount);
+
+			const VertexCacheStatistics before = MeshOptimizer::AnalyzeVertexCache(fullDetailIndices, vertexCount);
+			MeshOptimizer::Optimize(meshData);
+			const VertexCacheStatistics after = MeshOptimizer::AnalyzeVertexCache(fullDetailIndices, vertexCount);
+
+			cout << "Mesh "s << mesh->Name() << ": "s << vertexCount << " vertices, "s << fullDetailLod.IndexCount / 3 << " triangles, "s;
+			cout << (mesh->IndexFormat() == DXGI_FORMAT_R16_UINT ? "16"s : "32"s) << "-bit indices"s << endl;
+			cout << "  ACMR: "s << fixed << setprecision(3) << before.Acmr << " -> "s << after.Acmr;
+			cout << ", ATVR: "s << before.Atvr << " -> "s << after.Atvr << endl;
+			for (size_t i = 1; i < meshData.Lods.size(); ++i)
+			{
+				cout << "  LOD "s << i << ": "s << meshData.Lods[i].IndexCount / 3 << " triangles, error "s << scientific << setprecision(2) << meshData.Lods[i].Error << fixed << endl;
+			}
+			if (tangentStatistics.Generated)
+			{
+				cout << "  Tangents: "s << tangentStatistics.VertexCount << " vertices from "s << tangentStatistics.TriangleCount << " triangles ("s;
+				cout << tangentStatistics.DegenerateTriangleCount << " degenerate) in "s << setprecision(3) << tangentStatistics.Milliseconds << " ms on "s << tangentStatistics.ThreadCount << " threads"s << endl;
+			}
+
+			cout << "  Meshlets: "s << meshData.Meshlets.size() << endl;
+			const MeshBounds bounds = MeshBounds::FromPositions(meshData.Vertices);
+			cout << "  Bounds: ("s << bounds.Minimum.x << ", "s << bounds.Minimum.y << ", "s << bounds.Minimum.z << ") - ("s;
+			cout << bounds.Maximum.x << ", "s << bounds.Maximum.y << ", "s << bounds.Maximum.z << "), sphere radius "s << bounds.Radius << endl;
+			ReportPackingError(*mesh);
+		}
+
+		cout << "Writing: "s << outputFile << endl;
+		model.Save(outputFile.string(), MeshEncoding::Compressed);
 		cout << "Finished."s << endl;
 	}
 	catch (exception ex)
 	{
 		cout << ex.what() << endl;
+		return 1;
 	}
-	*/
+
 	return 0;
 }
\ No newline at end of file
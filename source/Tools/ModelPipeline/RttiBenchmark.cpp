@@ -0,0 +1,212 @@
+#include "pch.h"
+#include "RttiBenchmark.h"
+#include "RTTI.h"
+#include <chrono>
+
+using namespace std;
+using namespace std::string_literals;
+using namespace gsl;
+using namespace Library;
+
+namespace ModelPipeline
+{
+	namespace
+	{
+		const size_t ObjectCount = 4096;
+
+		// The RTTI base and macros as they were before the ancestor tables, kept here as the benchmark's baseline
+		class RecursiveRTTI
+		{
+		public:
+			using IdType = uint64_t;
+
+			virtual ~RecursiveRTTI() = default;
+
+			virtual uint64_t TypeIdInstance() const = 0;
+
+			virtual RecursiveRTTI* QueryInterface(const IdType)
+			{
+				return nullptr;
+			}
+
+			virtual bool Is(IdType) const
+			{
+				return false;
+			}
+
+			virtual bool Is(const string&) const
+			{
+				return false;
+			}
+
+			template <typename T>
+			T* As() const
+			{
+				return (Is(T::TypeIdClass()) ? reinterpret_cast<T*>(const_cast<RecursiveRTTI*>(this)) : nullptr);
+			}
+		};
+
+#define RECURSIVE_RTTI_DECLARATIONS(Type, ParentType)																	\
+		public:																											\
+			static std::string TypeName() { return std::string(#Type); }												\
+			static IdType TypeIdClass() { return sRunTimeTypeId; }														\
+			virtual IdType TypeIdInstance() const override { return Type::TypeIdClass(); }								\
+			virtual RecursiveRTTI* QueryInterface(const IdType id) override												\
+			{																											\
+				return (id == sRunTimeTypeId ? reinterpret_cast<RecursiveRTTI*>(this) : ParentType::QueryInterface(id));\
+			}																											\
+			virtual bool Is(IdType id) const override																	\
+			{																											\
+				return (id == sRunTimeTypeId ? true : ParentType::Is(id));												\
+			}																											\
+			virtual bool Is(const std::string& name) const override														\
+			{																											\
+				return (name == TypeName() ? true : ParentType::Is(name));												\
+			}																											\
+		private:																										\
+			static IdType sRunTimeTypeId;
+
+#define RECURSIVE_RTTI_DEFINITIONS(Type) RecursiveRTTI::IdType Type::sRunTimeTypeId = reinterpret_cast<RecursiveRTTI::IdType>(&Type::sRunTimeTypeId);
+
+		// The demo's deepest chain, and a sibling branch
+		namespace Recursive
+		{
+			class GameComponent : public RecursiveRTTI { RECURSIVE_RTTI_DECLARATIONS(GameComponent, RecursiveRTTI) };
+			class Camera : public GameComponent { RECURSIVE_RTTI_DECLARATIONS(Camera, GameComponent) };
+			class PerspectiveCamera : public Camera { RECURSIVE_RTTI_DECLARATIONS(PerspectiveCamera, Camera) };
+			class FirstPersonCamera : public PerspectiveCamera { RECURSIVE_RTTI_DECLARATIONS(FirstPersonCamera, PerspectiveCamera) };
+			class DrawableGameComponent : public GameComponent { RECURSIVE_RTTI_DECLARATIONS(DrawableGameComponent, GameComponent) };
+			class Skybox : public DrawableGameComponent { RECURSIVE_RTTI_DECLARATIONS(Skybox, DrawableGameComponent) };
+
+			RECURSIVE_RTTI_DEFINITIONS(GameComponent)
+			RECURSIVE_RTTI_DEFINITIONS(Camera)
+			RECURSIVE_RTTI_DEFINITIONS(PerspectiveCamera)
+			RECURSIVE_RTTI_DEFINITIONS(FirstPersonCamera)
+			RECURSIVE_RTTI_DEFINITIONS(DrawableGameComponent)
+			RECURSIVE_RTTI_DEFINITIONS(Skybox)
+		}
+
+		namespace Flat
+		{
+			class GameComponent : public RTTI { RTTI_DECLARATIONS(GameComponent, RTTI) };
+			class Camera : public GameComponent { RTTI_DECLARATIONS(Camera, GameComponent) };
+			class PerspectiveCamera : public Camera { RTTI_DECLARATIONS(PerspectiveCamera, Camera) };
+			class FirstPersonCamera : public PerspectiveCamera { RTTI_DECLARATIONS(FirstPersonCamera, PerspectiveCamera) };
+			class DrawableGameComponent : public GameComponent { RTTI_DECLARATIONS(DrawableGameComponent, GameComponent) };
+			class Skybox : public DrawableGameComponent { RTTI_DECLARATIONS(Skybox, DrawableGameComponent) };
+
+			RTTI_DEFINITIONS(GameComponent)
+			RTTI_DEFINITIONS(Camera)
+			RTTI_DEFINITIONS(PerspectiveCamera)
+			RTTI_DEFINITIONS(FirstPersonCamera)
+			RTTI_DEFINITIONS(DrawableGameComponent)
+			RTTI_DEFINITIONS(Skybox)
+		}
+
+		// The same mix of types in the same order for both, so every query sees the same branch pattern
+		template <typename Base, typename Camera, typename PerspectiveCamera, typename FirstPersonCamera, typename Skybox>
+		vector<unique_ptr<Base>> CreateObjects()
+		{
+			vector<unique_ptr<Base>> objects;
+			objects.reserve(ObjectCount);
+			for (size_t i = 0; i < ObjectCount; ++i)
+			{
+				switch (i % 5)
+				{
+				case 0:
+				case 1:
+					objects.push_back(make_unique<FirstPersonCamera>());
+					break;
+
+				case 2:
+					objects.push_back(make_unique<PerspectiveCamera>());
+					break;
+
+				case 3:
+					objects.push_back(make_unique<Camera>());
+					break;
+
+				default:
+					objects.push_back(make_unique<Skybox>());
+					break;
+				}
+			}
+
+			return objects;
+		}
+
+		template <typename T, typename Query>
+		pair<double, uint64_t> Measure(const vector<unique_ptr<T>>& objects, uint32_t iterationCount, Query query)
+		{
+			uint64_t hitCount = 0;
+			const auto startTime = chrono::high_resolution_clock::now();
+			for (uint32_t iteration = 0; iteration < iterationCount; ++iteration)
+			{
+				for (const auto& object : objects)
+				{
+					hitCount += (query(*object) ? 1 : 0);
+				}
+			}
+
+			const chrono::duration<double, nano> elapsed = chrono::high_resolution_clock::now() - startTime;
+			return { elapsed.count() / (static_cast<double>(iterationCount) * static_cast<double>(objects.size())), hitCount };
+		}
+	}
+
+	RttiBenchmarkResults RttiBenchmark::Run(uint32_t iterationCount)
+	{
+		RttiBenchmarkResults results;
+		results.IterationCount = max(iterationCount, 1U);
+		results.ObjectCount = static_cast<uint32_t>(ObjectCount);
+
+		const auto recursiveObjects = CreateObjects<RecursiveRTTI, Recursive::Camera, Recursive::PerspectiveCamera, Recursive::FirstPersonCamera, Recursive::Skybox>();
+		const auto flatObjects = CreateObjects<RTTI, Flat::Camera, Flat::PerspectiveCamera, Flat::FirstPersonCamera, Flat::Skybox>();
+
+		auto compare = [&](const string& name, auto recursiveQuery, auto flatQuery)
+		{
+			const auto recursive = Measure(recursiveObjects, results.IterationCount, recursiveQuery);
+			const auto flat = Measure(flatObjects, results.IterationCount, flatQuery);
+			results.Results.push_back({ name, recursive.first, flat.first, recursive.second == flat.second });
+		};
+
+		compare("Is(GameComponent::TypeIdClass())"s,
+			[](const RecursiveRTTI& object) { return object.Is(Recursive::GameComponent::TypeIdClass()); },
+			[](const RTTI& object) { return object.Is(Flat::GameComponent::TypeIdClass()); });
+
+		compare("Is(FirstPersonCamera::TypeIdClass())"s,
+			[](const RecursiveRTTI& object) { return object.Is(Recursive::FirstPersonCamera::TypeIdClass()); },
+			[](const RTTI& object) { return object.Is(Flat::FirstPersonCamera::TypeIdClass()); });
+
+		compare("Is(DrawableGameComponent::TypeIdClass())"s,
+			[](const RecursiveRTTI& object) { return object.Is(Recursive::DrawableGameComponent::TypeIdClass()); },
+			[](const RTTI& object) { return object.Is(Flat::DrawableGameComponent::TypeIdClass()); });
+
+		// Ids picked at run time, as ids read from data would be, so the query can't be folded into a constant
+		const vector<RecursiveRTTI::IdType> recursiveIds{ Recursive::GameComponent::TypeIdClass(), Recursive::Camera::TypeIdClass(), Recursive::FirstPersonCamera::TypeIdClass(), Recursive::DrawableGameComponent::TypeIdClass(), Recursive::Skybox::TypeIdClass() };
+		const vector<RTTI::IdType> flatIds{ Flat::GameComponent::TypeIdClass(), Flat::Camera::TypeIdClass(), Flat::FirstPersonCamera::TypeIdClass(), Flat::DrawableGameComponent::TypeIdClass(), Flat::Skybox::TypeIdClass() };
+		size_t recursiveIdIndex = 0;
+		size_t flatIdIndex = 0;
+		compare("Is(IdType) with ids chosen at run time"s,
+			[&recursiveIds, &recursiveIdIndex](const RecursiveRTTI& object) { return object.Is(recursiveIds[recursiveIdIndex++ % recursiveIds.size()]); },
+			[&flatIds, &flatIdIndex](const RTTI& object) { return object.Is(flatIds[flatIdIndex++ % flatIds.size()]); });
+
+		compare("Is<FirstPersonCamera>()"s,
+			[](const RecursiveRTTI& object) { return object.Is(Recursive::FirstPersonCamera::TypeIdClass()); },
+			[](const RTTI& object) { return object.Is<Flat::FirstPersonCamera>(); });
+
+		compare("As<PerspectiveCamera>()"s,
+			[](const RecursiveRTTI& object) { return object.As<Recursive::PerspectiveCamera>() != nullptr; },
+			[](const RTTI& object) { return object.As<Flat::PerspectiveCamera>() != nullptr; });
+
+		compare("QueryInterface(Camera::TypeIdClass())"s,
+			[](const RecursiveRTTI& object) { return const_cast<RecursiveRTTI&>(object).QueryInterface(Recursive::Camera::TypeIdClass()) != nullptr; },
+			[](const RTTI& object) { return const_cast<RTTI&>(object).QueryInterface(Flat::Camera::TypeIdClass()) != nullptr; });
+
+		const string gameComponentName("GameComponent"s);
+		compare("Is(\"GameComponent\"s)"s,
+			[&gameComponentName](const RecursiveRTTI& object) { return object.Is(gameComponentName); },
+			[&gameComponentName](const RTTI& object) { return object.Is(gameComponentName); });
+
+		return results;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ModelPipeline
+{
+	struct RttiBenchmarkResult final
+	{
+		std::string Query;
+		double RecursiveNanoseconds{ 0.0 }; // Per query, with the previous recursive macro
+		double FlatNanoseconds{ 0.0 }; // Per query, with the ancestor tables
+		bool Identical{ false }; // Both answered every query the same way
+	};
+
+	struct RttiBenchmarkResults final
+	{
+		std::uint32_t IterationCount{ 0 };
+		std::uint32_t ObjectCount{ 0 };
+		std::vector<RttiBenchmarkResult> Results;
+	};
+
+	/// <summary>
+	/// Compares the previous RTTI_DECLARATIONS, which walked the parent chain through virtual calls, with the current flattened ancestor tables.
+	/// Both run the same queries over a mix of objects from the demo's deepest hierarchy,
+	/// FirstPersonCamera, PerspectiveCamera, Camera and GameComponent, and a sibling branch that every camera query misses.
+	/// </summary>
+	class RttiBenchmark final
+	{
+	public:
+		inline static const std::uint32_t DefaultIterationCount{ 1000 };
+
+		static RttiBenchmarkResults Run(std::uint32_t iterationCount = DefaultIterationCount);
+
+		RttiBenchmark() = delete;
+		RttiBenchmark(const RttiBenchmark&) = delete;
+		RttiBenchmark& operator=(const RttiBenchmark&) = delete;
+		RttiBenchmark(RttiBenchmark&&) = delete;
+		RttiBenchmark& operator=(RttiBenchmark&&) = delete;
+		~RttiBenchmark() = default;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "pch.h"
+#include "TangentGenerator.h"
+#include "Mesh.h"
+#include <chrono>
+#include <future>
+#include <numeric>
+#include <thread>
+
+using namespace std;
+using namespace gsl;
+using namespace DirectX;
+using namespace Library;
+
+namespace ModelPipeline
+{
+	namespace
+	{
+		// Contiguous, equally sized ranges; results never depend on how the work was split.
+		template <typename Function>
+		void ParallelFor(size_t count, uint32_t threadCount, Function function)
+		{
+			const size_t chunkCount = max<size_t>(1, min<size_t>(threadCount, count));
+			if (chunkCount == 1)
+			{
+				function(size_t(0), count);
+				return;
+			}
+
+			vector<future<void>> chunks;
+			chunks.reserve(chunkCount - 1);
+			for (size_t i = 1; i < chunkCount; ++i)
+			{
+				chunks.push_back(async(launch::async, function, count * i / chunkCount, count * (i + 1) / chunkCount));
+			}
+
+			function(size_t(0), count / chunkCount);
+			for (auto& chunk : chunks)
+			{
+				chunk.get();
+			}
+		}
+
+		XMVECTOR PerpendicularTo(FXMVECTOR normal)
+		{
+			const XMVECTOR axis = (fabs(XMVectorGetX(normal)) < 0.9f ? g_XMIdentityR0 : g_XMIdentityR1);
+			return XMVector3Normalize(XMVector3Cross(normal, axis));
+		}
+	}
+
+	TangentStatistics TangentGenerator::GenerateTangents(MeshData& meshData, uint32_t threadCount)
+	{
+		TangentStatistics statistics;
+		const size_t vertexCount = meshData.Vertices.size();
+		if (vertexCount == 0 || meshData.Normals.size() != vertexCount || meshData.TextureCoordinates.empty() || meshData.TextureCoordinates.front().size() != vertexCount)
+		{
+			return statistics;
+		}
+
+		const auto startTime = chrono::high_resolution_clock::now();
+		if (threadCount == 0)
+		{
+			threadCount = max(thread::hardware_concurrency(), 1U);
+		}
+
+		// Frames come from the full-detail level; coarser levels share its vertices.
+		const uint32_t levelStart = (meshData.Lods.empty() ? 0 : meshData.Lods.front().StartIndex);
+		const uint32_t levelIndexCount = (meshData.Lods.empty() ? narrow<uint32_t>(meshData.Indices.size()) : meshData.Lods.front().IndexCount);
+		const span<const uint32_t> indices = span<const uint32_t>(meshData.Indices).subspan(levelStart, levelIndexCount);
+		const size_t triangleCount = levelIndexCount / 3;
+		const vector<XMFLOAT3>& positions = meshData.Vertices;
+		const vector<XMFLOAT3>& textureCoordinates = meshData.TextureCoordinates.front();
+
+		// Each triangle's tangent (along +u) and bitangent (along +v), scaled by the inverse UV area
+		vector<XMFLOAT3> triangleTangents(triangleCount);
+		vector<XMFLOAT3> triangleBitangents(triangleCount);
+		vector<uint8_t> degenerate(triangleCount, 0);
+		ParallelFor(triangleCount, threadCount, [&](size_t begin, size_t end)
+		{
+			for (size_t triangle = begin; triangle < end; ++triangle)
+			{
+				const uint32_t* corners = &indices[triangle * 3];
+				const XMVECTOR p0 = XMLoadFloat3(&positions[corners[0]]);
+				const XMVECTOR edge1 = XMVectorSubtract(XMLoadFloat3(&positions[corners[1]]), p0);
+				const XMVECTOR edge2 = XMVectorSubtract(XMLoadFloat3(&positions[corners[2]]), p0);
+
+				const XMFLOAT3& uv0 = textureCoordinates[corners[0]];
+				const float du1 = textureCoordinates[corners[1]].x - uv0.x;
+				const float dv1 = textureCoordinates[corners[1]].y - uv0.y;
+				const float du2 = textureCoordinates[corners[2]].x - uv0.x;
+				const float dv2 = textureCoordinates[corners[2]].y - uv0.y;
+				const float determinant = du1 * dv2 - du2 * dv1;
+				if (fabs(determinant) <= numeric_limits<float>::min())
+				{
+					triangleTangents[triangle] = XMFLOAT3(0.0f, 0.0f, 0.0f);
+					triangleBitangents[triangle] = XMFLOAT3(0.0f, 0.0f, 0.0f);
+					degenerate[triangle] = 1;
+					continue;
+				}
+
+				const float inverseDeterminant = 1.0f / determinant;
+				XMStoreFloat3(&triangleTangents[triangle], XMVectorScale(XMVectorSubtract(XMVectorScale(edge1, dv2), XMVectorScale(edge2, dv1)), inverseDeterminant));
+				XMStoreFloat3(&triangleBitangents[triangle], XMVectorScale(XMVectorSubtract(XMVectorScale(edge2, du1), XMVectorScale(edge1, du2)), inverseDeterminant));
+			}
+		});
+
+		// Vertex -> triangle adjacency in compressed row form, each row in ascending triangle order
+		vector<uint32_t> offsets(vertexCount + 1, 0);
+		for (uint32_t index : indices)
+		{
+			++offsets[size_t(index) + 1];
+		}
+
+		partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+		vector<uint32_t> vertexTriangles(levelIndexCount);
+		{
+			vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+			for (uint32_t i = 0; i < levelIndexCount; ++i)
+			{
+				vertexTriangles[cursors[indices[i]]++] = i / 3;
+			}
+		}
+
+		meshData.Tangents.resize(vertexCount);
+		meshData.BiNormals.resize(vertexCount);
+		ParallelFor(vertexCount, threadCount, [&](size_t begin, size_t end)
+		{
+			for (size_t vertex = begin; vertex < end; ++vertex)
+			{
+				XMVECTOR tangent = XMVectorZero();
+				XMVECTOR bitangent = XMVectorZero();
+				for (uint32_t i = offsets[vertex]; i < offsets[vertex + 1]; ++i)
+				{
+					tangent = XMVectorAdd(tangent, XMLoadFloat3(&triangleTangents[vertexTriangles[i]]));
+					bitangent = XMVectorAdd(bitangent, XMLoadFloat3(&triangleBitangents[vertexTriangles[i]]));
+				}
+
+				const XMVECTOR normal = XMVector3Normalize(XMLoadFloat3(&meshData.Normals[vertex]));
+				tangent = XMVectorSubtract(tangent, XMVectorScale(normal, XMVectorGetX(XMVector3Dot(normal, tangent))));
+				tangent = (XMVectorGetX(XMVector3LengthSq(tangent)) > numeric_limits<float>::min() ? XMVector3Normalize(tangent) : PerpendicularTo(normal));
+
+				// Mirrored UVs flip the binormal, so normal maps authored for either side light the same way
+				const XMVECTOR binormal = XMVector3Cross(normal, tangent);
+				const float handedness = (XMVectorGetX(XMVector3Dot(binormal, bitangent)) < 0.0f ? -1.0f : 1.0f);
+				XMStoreFloat3(&meshData.Tangents[vertex], tangent);
+				XMStoreFloat3(&meshData.BiNormals[vertex], XMVectorScale(binormal, handedness));
+			}
+		});
+
+		const chrono::duration<double, milli> elapsed = chrono::high_resolution_clock::now() - startTime;
+		statistics.Generated = true;
+		statistics.TriangleCount = narrow<uint32_t>(triangleCount);
+		statistics.VertexCount = narrow<uint32_t>(vertexCount);
+		statistics.DegenerateTriangleCount = narrow<uint32_t>(count(degenerate.begin(), degenerate.end(), uint8_t(1)));
+		statistics.ThreadCount = threadCount;
+		statistics.Milliseconds = elapsed.count();
+
+		return statistics;
+	}
+}
\ No newline at end of file
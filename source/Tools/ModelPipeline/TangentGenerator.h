@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Library
+{
+	struct MeshData;
+}
+
+namespace ModelPipeline
+{
+	struct TangentStatistics final
+	{
+		bool Generated{ false }; // False when the mesh lacks per-vertex normals or texture coordinates
+		std::uint32_t TriangleCount{ 0 };
+		std::uint32_t VertexCount{ 0 };
+		std::uint32_t DegenerateTriangleCount{ 0 }; // Zero-area in UV space; these contribute nothing
+		std::uint32_t ThreadCount{ 0 };
+		double Milliseconds{ 0.0 };
+	};
+
+	/// <summary>
+	/// Per-vertex tangent frames from positions, normals and the first texture coordinate channel, after Lengyel's
+	/// "Computing Tangent Space Basis Vectors for an Arbitrary Mesh". Each triangle's frame is computed independently.
+	/// Every vertex then sums its triangles' frames in triangle order and Gram-Schmidt orthogonalizes the result against its normal.
+	/// Each output element is written by exactly one thread in a fixed order, so the result is bit-identical for any thread count.
+	/// The binormal carries the UV mapping's handedness.
+	/// </summary>
+	class TangentGenerator final
+	{
+	public:
+		TangentGenerator() = delete;
+
+		static TangentStatistics GenerateTangents(Library::MeshData& meshData, std::uint32_t threadCount = 0); // 0 uses one thread per hardware thread
+	};
+}
\ No newline at end of file